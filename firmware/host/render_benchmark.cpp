@@ -0,0 +1,254 @@
+// Renders every screen in representative states. Without arguments it reports
+// the time per build(), the lit pixels and the bus cost of typical frame to
+// frame changes. With --check or --update it compares the frames against, or
+// writes, the golden PBM images that rendering changes must keep pixel exact.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config.hpp"
+#include "hardware_config.hpp"
+#include "loading_screen.hpp"
+#include "main_screen.hpp"
+#include "menu_screen.hpp"
+#include "ssd1306_i2c_target.hpp"
+
+static constexpr uint32_t k_build_count = 20'000;
+static constexpr size_t k_pdo_count = 13;
+static constexpr std::string_view k_menu_title = "Available PDOs";
+
+/**
+ * @brief Screen in a named state
+ */
+struct Scene {
+    std::string name;
+    std::function<Screen&()> setup;
+};
+
+/**
+ * @brief Change between two states of a screen
+ */
+struct Transition {
+    std::string name;
+    std::function<Screen&()> from;
+    std::function<Screen&()> to;
+};
+
+static std::array<uint8_t, Ssd1306_128x64::getFrameBufferSize()>
+    g_frame_buffer;
+static Ssd1306I2cTarget g_display;
+static HostI2cBus g_i2c;
+static Ssd1306_128x64 g_oled{g_i2c};
+
+static MainScreen g_main_screen;
+static MenuScreen g_menu_screen{k_menu_title};
+static LoadingScreen g_loading_screen;
+static std::array<Config, k_pdo_count> g_configs;
+
+// 0: output off, 1: voltage being edited, 2: output on in CC
+static auto setMainState(int state) -> Screen& {
+    g_main_screen = MainScreen{};
+    return g_main_screen.setPdoType(IPdSink::PdoType::PPS)
+        .setTemperature(42 + state)
+        .setMeasuredVoltage(5070 + (state * 3330))
+        .setMeasuredCurrent(1234 * state)
+        .setTargetVoltage(5000 + (state * 1020))
+        .setTargetCurrent(1000 + (state * 250))
+        .selectTargetVoltage(state == 1)
+        .selectTargetCurrent(state == 2)
+        .setOutputEnable(state != 0)
+        .setSupplyMode((state == 2) ? SupplyMode::CC : SupplyMode::CV);
+}
+
+static auto setMenuState(size_t count, uint8_t selection) -> Screen& {
+    g_menu_screen = MenuScreen{k_menu_title};
+    return g_menu_screen
+        .setConfig(std::span<const Config>(g_configs.data(), count))
+        .selectMenuItem(selection);
+}
+
+// 0: just started, 1: two retries later, 2: PDOs found
+static auto setLoadingState(int state) -> Screen& {
+    g_loading_screen = LoadingScreen{};
+    if (state >= 1) {
+        g_loading_screen.updateProgress();
+        g_loading_screen.updateProgress();
+    }
+    if (state == 2) {
+        g_loading_screen.setPdoProfileCount(7);
+    }
+    return g_loading_screen;
+}
+
+static auto getScenes() -> std::vector<Scene> {
+    std::vector<Scene> scenes;
+    for (int state = 0; state < 3; ++state) {
+        scenes.push_back({.name = "main_" + std::to_string(state),
+                          .setup = [state]() -> Screen& {
+                              return setMainState(state);
+                          }});
+    }
+    for (size_t count : {1, 7, 13}) {
+        for (size_t selection = 0; selection < count; selection += 3) {
+            scenes.push_back(
+                {.name = "menu_" + std::to_string(count) + "_" +
+                         std::to_string(selection),
+                 .setup = [count, selection]() -> Screen& {
+                     return setMenuState(count,
+                                         static_cast<uint8_t>(selection));
+                 }});
+        }
+    }
+    for (int state = 0; state < 3; ++state) {
+        scenes.push_back({.name = "loading_" + std::to_string(state),
+                          .setup = [state]() -> Screen& {
+                              return setLoadingState(state);
+                          }});
+    }
+    return scenes;
+}
+
+static auto getTransitions() -> std::vector<Transition> {
+    return {
+        {.name = "digit",
+         .from = []() -> Screen& {
+             setMainState(2);
+             return g_main_screen.setMeasuredVoltage(8400);
+         },
+         .to = []() -> Screen& {
+             return g_main_screen.setMeasuredVoltage(8410);
+         }},
+        {.name = "blink",
+         .from = []() -> Screen& { return setMainState(1); },
+         .to = []() -> Screen& {
+             return g_main_screen.selectTargetVoltage(false);
+         }},
+        {.name = "output",
+         .from = []() -> Screen& { return setMainState(0); },
+         .to = []() -> Screen& {
+             return g_main_screen.setOutputEnable(true);
+         }},
+        {.name = "menu_next",
+         .from = []() -> Screen& { return setMenuState(k_pdo_count, 4); },
+         .to = []() -> Screen& {
+             return g_menu_screen.selectNextMenuItem();
+         }},
+        {.name = "progress",
+         .from = []() -> Screen& { return setLoadingState(0); },
+         .to = []() -> Screen& {
+             return g_loading_screen.updateProgress();
+         }},
+    };
+}
+
+static auto initialize() -> void {
+    Screen::initialize(g_frame_buffer, Ssd1306_128x64::getWidth(),
+                       Ssd1306_128x64::getHeight(),
+                       Ssd1306_128x64::getPageHeight());
+    g_i2c.attach(Ssd1306I2cTarget::k_i2c_addr, g_display);
+    g_oled.initialize();
+    for (size_t i = 0; i < g_configs.size(); ++i) {
+        IPdSink::Pdo pdo;
+        pdo.index = static_cast<uint8_t>(i);
+        pdo.type = ((i % 3) != 0) ? IPdSink::PdoType::PPS
+                                  : IPdSink::PdoType::FIX;
+        pdo.voltage_min = static_cast<uint16_t>(3300 + (i * 100));
+        pdo.voltage_max = static_cast<uint16_t>(5000 + (i * 1500));
+        pdo.current_max = static_cast<uint16_t>(1000 + (i * 333));
+        g_configs[i] = ConfigBuilder::buildWithPdo(pdo);
+    }
+}
+
+static auto countLitPixels(std::span<const uint8_t> frame) -> uint32_t {
+    uint32_t count = 0;
+    for (auto column : frame) {
+        count += std::popcount(column);
+    }
+    return count;
+}
+
+static auto readFile(const std::string& path) -> std::vector<char> {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+static auto runBenchmark() -> int {
+    std::printf("%-12s %10s %8s\n", "screen", "ns/build", "lit px");
+    for (const auto& scene : getScenes()) {
+        auto& screen = scene.setup();
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < k_build_count; ++i) {
+            screen.build();
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start);
+        std::printf("%-12s %10.0f %8u\n", scene.name.c_str(),
+                    elapsed.count() / k_build_count,
+                    countLitPixels(screen.build()));
+    }
+    std::printf("\n%-12s %8s %8s %8s\n", "change", "bytes", "data", "writes");
+    for (const auto& transition : getTransitions()) {
+        g_oled.display(transition.from().build());
+        g_display.resetStatistics();
+        g_oled.display(transition.to().build());
+        auto statistics = g_display.getStatistics();
+        std::printf("%-12s %8u %8u %8u\n", transition.name.c_str(),
+                    statistics.bytes, statistics.data_bytes,
+                    statistics.transactions);
+    }
+    return 0;
+}
+
+// The frames go through the driver into the decoded display RAM, so the
+// images also cover the wire protocol
+static auto compareGolden(const std::string& directory, bool is_update)
+    -> int {
+    int mismatch_count = 0;
+    for (const auto& scene : getScenes()) {
+        auto& frame = scene.setup().build();
+        g_oled.display(frame);
+        auto ram = g_display.getRam();
+        bool is_sent = std::equal(ram.begin(), ram.end(), frame.begin());
+        auto golden_path = directory + "/" + scene.name + ".pbm";
+        auto frame_path = is_update ? golden_path : scene.name + ".pbm";
+        if (!g_display.writePbm(frame_path.c_str())) {
+            std::fprintf(stderr, "can not write %s\n", frame_path.c_str());
+            return 1;
+        }
+        if (!is_sent || readFile(frame_path) != readFile(golden_path)) {
+            std::fprintf(stderr, "%s differs from %s\n", frame_path.c_str(),
+                         golden_path.c_str());
+            ++mismatch_count;
+        }
+    }
+    return (mismatch_count == 0) ? 0 : 1;
+}
+
+auto main(int argc, char** argv) -> int {
+    initialize();
+    if (argc == 1) {
+        return runBenchmark();
+    }
+    if (argc == 3 && std::strcmp(argv[1], "--check") == 0) {
+        return compareGolden(argv[2], false);
+    }
+    if (argc == 3 && std::strcmp(argv[1], "--update") == 0) {
+        return compareGolden(argv[2], true);
+    }
+    std::fprintf(stderr, "usage: %s [--check|--update <golden directory>]\n",
+                 argv[0]);
+    return 1;
+}
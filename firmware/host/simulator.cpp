@@ -0,0 +1,363 @@
+// Runs the firmware on the host against fakes of the board devices, in real
+// time. The remote control interface is served on a pseudo-terminal, the
+// encoder is operated with keys on the standard input.
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "ap33772s.hpp"
+#include "ap33772s_i2c_target.hpp"
+#include "event.hpp"
+#include "hardware_config.hpp"
+#include "hardware_context.hpp"
+#include "ina226.hpp"
+#include "ina226_i2c_target.hpp"
+#include "output_sequencer.hpp"
+#include "scpi_interpreter.hpp"
+#include "ssd1306.hpp"
+#include "ssd1306_i2c_target.hpp"
+#include "state_machine.hpp"
+#include "task_scheduler.hpp"
+
+using hal::gpio::Direction;
+using hal::gpio::Edge;
+using hal::gpio::Pull;
+
+static constexpr uint8_t k_ina226_addr = 0x40;
+static constexpr int32_t k_shunt = 10'000;   // uOhm
+static constexpr int32_t k_load = 10'000;    // mOhm, default
+static constexpr uint32_t k_caps_time = 200;   // ms after start up
+
+static constexpr uint32_t k_calibration_magic = 0x494E4131;   // "INA1"
+static constexpr uint32_t k_settings_magic = 0x53455431;      // "SET1"
+static constexpr uint32_t k_settings_flash_size =
+    4 * RamFlash::getSectorSize();
+static constexpr uint32_t k_flash_size =
+    k_settings_flash_size + RamFlash::getSectorSize();
+
+static constexpr Ina226::Profile k_sensor_profile = Ina226::Profile::Balanced;
+static constexpr int32_t k_ocp_limit = 5500;   // mA
+static constexpr uint32_t k_temperature_period = 1'000'000;   // us
+static constexpr uint8_t k_temperature_priority = 0;
+static constexpr uint8_t k_measurement_priority = 1;
+static constexpr uint32_t k_sequencer_period = 1000;   // us
+static constexpr uint8_t k_sequencer_priority = 2;
+static constexpr size_t k_task_count = 3;
+static constexpr uint32_t k_microseconds_per_millisecond = 1000;
+static constexpr std::string_view k_remote_identity =
+    "TinyPPS,TinyPPS simulator,0,2.0";
+static constexpr const char* k_display_path = "display.pbm";
+
+// SRC_SPR_PDOX words of the emulated source: 5 V, 9 V and 15 V at 3 A and
+// a 3.3 V to 11 V PPS at 4.75 A
+static constexpr uint16_t k_fixed_3a = (8 << 10) | (1 << 15);
+static constexpr uint16_t k_pps_5a = (15 << 10) | (1 << 8) | (1 << 14) |
+                                     (1 << 15);
+static constexpr std::array<uint16_t, 4> k_source_pdos = {
+    50 | k_fixed_3a, 90 | k_fixed_3a, 150 | k_fixed_3a, 110 | k_pps_5a};
+
+static std::atomic<bool> g_is_running{true};
+static volatile uint32_t g_system_time = 0;
+static volatile bool g_is_pd_interrupt_pending = false;
+static volatile bool g_is_ocp_interrupt_pending = false;
+static const std::chrono::steady_clock::time_point g_start_time =
+    std::chrono::steady_clock::now();
+
+static auto getTimeUs() -> uint32_t {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - g_start_time)
+            .count());
+}
+
+// Round a value in micro units to the nearest milli unit
+static auto microToMilli(int32_t value) -> int32_t {
+    constexpr int32_t k_micro_per_milli = 1000;
+    constexpr int32_t k_half = k_micro_per_milli / 2;
+    return (value >= 0) ? (value + k_half) / k_micro_per_milli
+                        : (value - k_half) / k_micro_per_milli;
+}
+
+/**
+ * @brief Devices of the board
+ */
+struct Board {
+    std::vector<uint8_t> flash_storage =
+        std::vector<uint8_t>(k_flash_size, 0xFF);
+    RamFlash calibration_flash{
+        std::span(flash_storage).first(RamFlash::getSectorSize())};
+    RamFlash settings_flash{
+        std::span(flash_storage).last(k_settings_flash_size)};
+    Ssd1306I2cTarget display;
+    Ina226I2cTarget sensor{k_shunt};
+    Ap33772sI2cTarget pdsink;
+    HostI2cBus i2c;
+    HostGpioPin output_enable;
+    HostGpioPin pd_int;
+    HostGpioPin ina226_alert;
+    HostRepeatingTimer timer;
+    PtySerial serial;
+};
+
+// The source feeds a resistive load, a PPS contract limits the current by
+// lowering the voltage
+static auto updateLoad(Board& board, int32_t load) -> void {
+    auto contract = board.pdsink.getContract();
+    int32_t voltage = contract.voltage;   // mV
+    int32_t current = 0;                  // mA
+    if (board.output_enable.read() && load > 0) {
+        current = voltage * 1000 / load;
+        if (contract.current > 0 && current > contract.current) {
+            current = contract.current;
+            voltage = current * load / 1000;
+        }
+    }
+    board.sensor.setMeasurement(voltage * 1000, current * 1000);
+    // The ALERT pin is active low
+    board.ina226_alert.setLevel(!board.sensor.isAlert());
+}
+
+// Keys: k/j turn right/left, K/J turn while pressed, space short press,
+// l long press, d saves the display, q quits
+static auto readKey(const Board& board, RotaryEncoder::State& state) -> bool {
+    char key = 0;
+    if (::read(STDIN_FILENO, &key, 1) != 1) {
+        return false;
+    }
+    switch (key) {
+    case 'k':
+        state = RotaryEncoder::State::rot_inc;
+        return true;
+    case 'j':
+        state = RotaryEncoder::State::rot_dec;
+        return true;
+    case 'K':
+        state = RotaryEncoder::State::rot_inc_while_btn_press;
+        return true;
+    case 'J':
+        state = RotaryEncoder::State::rot_dec_while_btn_press;
+        return true;
+    case ' ':
+        state = RotaryEncoder::State::btn_short_press;
+        return true;
+    case 'l':
+        state = RotaryEncoder::State::btn_long_press;
+        return true;
+    case 'd':
+        if (board.display.writePbm(k_display_path)) {
+            std::printf("display saved to %s\n", k_display_path);
+        }
+        return false;
+    case 'q':
+        g_is_running = false;
+        return false;
+    default:
+        return false;
+    }
+}
+
+auto main(int argc, char** argv) -> int {
+    const char* image_path = nullptr;
+    int32_t load = k_load;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--flash") == 0) {
+            image_path = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--load") == 0) {
+            load = std::atoi(argv[i + 1]);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--flash <image>] [--load <mOhm>]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    static Board board;
+    if (image_path != nullptr && access(image_path, F_OK) == 0 &&
+        !board.settings_flash.loadImage(image_path)) {
+        std::fprintf(stderr, "can not load %s\n", image_path);
+        return 1;
+    }
+    if (!board.serial.open()) {
+        std::fprintf(stderr, "can not open a pseudo-terminal\n");
+        return 1;
+    }
+    std::printf("remote control on %s\n", board.serial.getPortName());
+    std::fflush(stdout);
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    std::signal(SIGINT, [](int) { g_is_running = false; });
+
+    board.i2c.attach(Ssd1306I2cTarget::k_i2c_addr, board.display);
+    board.i2c.attach(Ina226I2cTarget::k_i2c_addr, board.sensor);
+    board.i2c.attach(Ap33772sI2cTarget::k_i2c_addr, board.pdsink);
+
+    static Ssd1306_128x64 oled{board.i2c};
+    static Ina226 ina226{board.i2c, k_ina226_addr};
+    static Ap33772s ap33772s{board.i2c};
+    static const CalibrationStore calibration_store{board.calibration_flash,
+                                                    k_calibration_magic};
+    static SettingsStore settings{board.settings_flash, k_settings_magic};
+    static OutputSequencer sequencer;
+    static std::array<uint8_t, Ssd1306_128x64::getFrameBufferSize()>
+        frame_buffer;
+    static ScpiInterpreter<PtySerial> remote{board.serial, k_remote_identity};
+
+    board.output_enable.configure(Direction::Output, Pull::Down);
+    board.pd_int.configure(Direction::Input, Pull::Down);
+    board.pd_int.attachInterrupt(
+        Edge::Rising,
+        [](const GpioPin&, void*) -> void { g_is_pd_interrupt_pending = true; },
+        nullptr);
+    board.pd_int.enableInterrupt(true);
+    board.ina226_alert.configure(Direction::Input, Pull::Up);
+    board.ina226_alert.attachInterrupt(
+        Edge::Falling,
+        [](const GpioPin&, void*) -> void {
+            board.output_enable.write(false);
+            g_is_ocp_interrupt_pending = true;
+        },
+        nullptr);
+    board.ina226_alert.enableInterrupt(true);
+    oled.initialize();
+    ina226.setProfile(k_sensor_profile);
+    ina226.calibrate(8, 0.01);
+    Ina226::Calibration calibration{};
+    if (calibration_store.load(calibration)) {
+        ina226.setCalibration(calibration);
+    }
+    settings.mount();
+    Screen::initialize(frame_buffer, Ssd1306_128x64::getWidth(),
+                       Ssd1306_128x64::getHeight(),
+                       Ssd1306_128x64::getPageHeight());
+    board.timer.start(
+        1, [](void*) -> void { g_system_time = g_system_time + 1; }, nullptr);
+
+    static PdRequestQueue pd_requests{ap33772s};
+    static HardwareContext hardware{.pdsink = ap33772s,
+                                    .pd_requests = pd_requests,
+                                    .sequencer = sequencer,
+                                    .output_enable = board.output_enable,
+                                    .oled = oled,
+                                    .sensor = ina226,
+                                    .calibration_store = calibration_store,
+                                    .settings = settings};
+    static StateMachine state_machine{hardware};
+    state_machine.dispatch(OcpLimitUpdateEvent{k_ocp_limit});
+
+    TaskScheduler<k_task_count> scheduler{getTimeUs};
+    size_t task = 0;
+    size_t measurement_task = 0;
+    size_t sequencer_task = 0;
+    scheduler.addTask(
+        k_temperature_period, k_temperature_priority,
+        [](uint32_t timestamp, void*) -> void {
+            state_machine.dispatch(TemperatureUpdateEvent{
+                .temperature = ap33772s.getTemp(), .timestamp = timestamp});
+        },
+        nullptr, task);
+    scheduler.addTask(
+        0, k_measurement_priority,
+        [](uint32_t timestamp, void*) -> void {
+            int32_t voltage = ina226.getBusVoltageMicro();
+            int32_t current = ina226.getCurrentMicro();
+            int32_t power = ina226.getPowerMicro();
+            state_machine.dispatch(
+                SensorUpdateEvent{.voltage = microToMilli(voltage),
+                                  .current = microToMilli(current),
+                                  .power = microToMilli(power),
+                                  .timestamp = timestamp,
+                                  .current_micro = current,
+                                  .power_micro = power});
+        },
+        nullptr, measurement_task);
+    scheduler.addTask(
+        k_sequencer_period, k_sequencer_priority,
+        [](uint32_t timestamp, void*) -> void {
+            state_machine.dispatch(SequencerTickEvent{.timestamp = timestamp});
+        },
+        nullptr, sequencer_task);
+
+    uint32_t last_tick_time = 0;
+    uint32_t last_clock_time = 0;
+    uint32_t settings_failure_count = 0;
+    bool is_source_attached = false;
+
+    while (g_is_running) {
+        uint32_t clock_time = getTimeUs() / k_microseconds_per_millisecond;
+        board.timer.advance(clock_time - last_clock_time);
+        last_clock_time = clock_time;
+        uint32_t current_time = g_system_time;
+        uint32_t delta = current_time - last_tick_time;
+        last_tick_time = current_time;
+
+        // The charger is plugged in shortly after power up
+        if (!is_source_attached && current_time >= k_caps_time) {
+            is_source_attached = true;
+            board.pdsink.attachSource(k_source_pdos);
+            board.pd_int.setLevel(true);
+            board.pd_int.setLevel(false);
+        }
+        updateLoad(board, load);
+
+        RotaryEncoder::State encoder_state{};
+        if (readKey(board, encoder_state)) {
+            state_machine.dispatch(RotaryEncoderEvent{encoder_state});
+        }
+
+        scheduler.setPeriod(measurement_task,
+                            ina226.getPollPeriod() *
+                                k_microseconds_per_millisecond);
+        scheduler.setEnabled(sequencer_task, sequencer.isRunning());
+        scheduler.run();
+
+        if (g_is_pd_interrupt_pending) {
+            g_is_pd_interrupt_pending = false;
+            state_machine.dispatch(
+                PdSinkStatusUpdateEvent{ap33772s.getStatus()});
+        }
+
+        PdRequestQueue::Outcome outcome;
+        if (pd_requests.process(current_time, outcome)) {
+            state_machine.dispatch(PdRequestStatusEvent{
+                .request = outcome.request, .result = outcome.result});
+        }
+
+        if (g_is_ocp_interrupt_pending) {
+            g_is_ocp_interrupt_pending = false;
+            bool is_alert = false;
+            ina226.readAlertFlag(is_alert);
+            state_machine.dispatch(OverCurrentEvent{});
+        }
+
+        RemoteCommand command;
+        if (remote.poll(command)) {
+            state_machine.dispatch(RemoteCommandEvent{
+                .command = command, .reply = &remote.getReply()});
+        }
+
+        state_machine.dispatch(SystemTickEvent{delta});
+        state_machine.flushUI();
+
+        if (state_machine.getSettingsFailureCount() != settings_failure_count) {
+            settings_failure_count = state_machine.getSettingsFailureCount();
+            remote.reportError(ScpiError::SystemError);
+        }
+        // The board loop never sleeps, the host one leaves the CPU to others
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    if (image_path != nullptr && !board.settings_flash.saveImage(image_path)) {
+        std::fprintf(stderr, "can not save %s\n", image_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+#ifndef board_fixture_hpp
+#define board_fixture_hpp
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "ap33772s.hpp"
+#include "ap33772s_i2c_target.hpp"
+#include "event.hpp"
+#include "hardware_config.hpp"
+#include "hardware_context.hpp"
+#include "ina226.hpp"
+#include "ina226_i2c_target.hpp"
+#include "output_sequencer.hpp"
+#include "scpi_interpreter.hpp"
+#include "ssd1306.hpp"
+#include "ssd1306_i2c_target.hpp"
+#include "state_machine.hpp"
+
+/**
+ * @brief The state machine on the emulated board, driven in 1 ms steps
+ *
+ * Wired like the simulator, without the real time loop and the terminal. The
+ * source feeds a resistive load and the sensor reads every step.
+ */
+class BoardFixture {
+  public:
+    static constexpr int32_t k_shunt = 10'000;   // uOhm
+    static constexpr uint32_t k_calibration_magic = 0x494E4131;
+    static constexpr uint32_t k_settings_magic = 0x53455431;
+    static constexpr uint32_t k_settings_flash_size =
+        4 * RamFlash::getSectorSize();
+    static constexpr uint32_t k_flash_size =
+        k_settings_flash_size + RamFlash::getSectorSize();
+    static constexpr uint32_t k_menu_time = 3000;   // ms, PDOs are loaded
+
+    // 5 V, 9 V and 15 V at 3 A and a 3.3 V to 11 V PPS at 4.75 A
+    static constexpr uint16_t k_fixed_3a = (8 << 10) | (1 << 15);
+    static constexpr uint16_t k_pps_5a = (15 << 10) | (1 << 8) | (1 << 14) |
+                                         (1 << 15);
+    static constexpr std::array<uint16_t, 4> k_source_pdos = {
+        50 | k_fixed_3a, 90 | k_fixed_3a, 150 | k_fixed_3a, 110 | k_pps_5a};
+    static constexpr uint8_t k_pps_item = 3;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] flash_storage Flash content of a previous run, erased if
+     * empty
+     */
+    explicit BoardFixture(std::vector<uint8_t> flash_storage = {})
+        : m_flash_storage(flash_storage.empty()
+                              ? std::vector<uint8_t>(k_flash_size, 0xFF)
+                              : std::move(flash_storage)) {
+        m_i2c.attach(Ssd1306I2cTarget::k_i2c_addr, display);
+        m_i2c.attach(Ina226I2cTarget::k_i2c_addr, sensor);
+        m_i2c.attach(Ap33772sI2cTarget::k_i2c_addr, pdsink);
+        m_output_enable.configure(hal::gpio::Direction::Output,
+                                  hal::gpio::Pull::Down);
+        m_oled.initialize();
+        m_ina226.calibrate(8, 0.01);
+        Ina226::Calibration calibration{};
+        if (m_calibration_store.load(calibration)) {
+            m_ina226.setCalibration(calibration);
+        }
+        m_settings.mount();
+        Screen::initialize(m_frame_buffer, Ssd1306_128x64::getWidth(),
+                           Ssd1306_128x64::getHeight(),
+                           Ssd1306_128x64::getPageHeight());
+        m_state_machine.emplace(m_hardware);
+    }
+
+    /**
+     * @brief Plug in the source and let the PDOs load
+     *
+     * @param[in] pdos Raw PDOs of the source
+     * @param[in] duration Time to run afterwards in ms
+     */
+    auto attachSource(std::span<const uint16_t> pdos = k_source_pdos,
+                      uint32_t duration = k_menu_time) -> void {
+        pdsink.attachSource(pdos);
+        dispatch(PdSinkStatusUpdateEvent{m_ap33772s.getStatus()});
+        run(duration);
+    }
+
+    /**
+     * @brief Plug in the source and pick a PDO in the menu
+     *
+     * @param[in] item Menu item, the PPS one by default
+     */
+    auto enterMainState(uint8_t item = k_pps_item) -> void {
+        attachSource();
+        for (uint8_t i = 0; i < item; ++i) {
+            dispatch(RotaryEncoderEvent{RotaryEncoder::State::rot_inc});
+        }
+        dispatch(RotaryEncoderEvent{RotaryEncoder::State::btn_short_press});
+        run(100);
+    }
+
+    /**
+     * @brief Let time pass
+     *
+     * @param[in] duration Time in ms
+     */
+    auto run(uint32_t duration) -> void {
+        for (uint32_t i = 0; i < duration; ++i) {
+            step();
+        }
+    }
+
+    /**
+     * @brief Run a remote command
+     *
+     * @param[in] type Command
+     * @param[in] values Parameters in the units of RemoteCommand
+     * @return Answer, empty for set commands
+     */
+    auto remote(RemoteCommand::Type type,
+                std::array<int32_t, 3> values = {}) -> std::string {
+        m_reply.clear();
+        dispatch(RemoteCommandEvent{
+            .command = {.type = type, .values = values}, .reply = &m_reply});
+        auto data = m_reply.getData();
+        return {data.begin(), data.end()};
+    }
+
+    /**
+     * @brief Get the error of the last remote command
+     */
+    [[nodiscard]] auto getRemoteError() const -> ScpiError {
+        return m_reply.getError();
+    }
+
+    auto dispatch(const SystemEvent& event) -> void {
+        m_state_machine->dispatch(event);
+    }
+
+    [[nodiscard]] auto getFlash() const -> const std::vector<uint8_t>& {
+        return m_flash_storage;
+    }
+
+    [[nodiscard]] auto isOutputEnabled() const -> bool {
+        return m_output_enable.read();
+    }
+
+    [[nodiscard]] auto getSensor() -> Ina226& { return m_ina226; }
+
+    [[nodiscard]] auto getSequencer() -> OutputSequencer& {
+        return m_sequencer;
+    }
+
+    [[nodiscard]] auto getTime() const -> uint32_t { return m_time; }
+
+    [[nodiscard]] auto getSettingsFlash() -> RamFlash& {
+        return m_settings_flash;
+    }
+
+    [[nodiscard]] auto getSettingsFailureCount() const -> uint32_t {
+        return m_state_machine->getSettingsFailureCount();
+    }
+
+    int32_t load{10'000};   // mOhm
+    Ssd1306I2cTarget display;
+    Ina226I2cTarget sensor{k_shunt};
+    Ap33772sI2cTarget pdsink;
+
+  private:
+    auto step() -> void {
+        ++m_time;
+        updateLoad();
+        uint32_t timestamp = m_time * 1000;
+        int32_t current = m_ina226.getCurrentMicro();
+        int32_t power = m_ina226.getPowerMicro();
+        dispatch(SensorUpdateEvent{
+            .voltage = m_ina226.getBusVoltageMicro() / 1000,
+            .current = current / 1000,
+            .power = power / 1000,
+            .timestamp = timestamp,
+            .current_micro = current,
+            .power_micro = power});
+        if (m_sequencer.isRunning()) {
+            dispatch(SequencerTickEvent{.timestamp = timestamp});
+        }
+        PdRequestQueue::Outcome outcome;
+        if (m_pd_requests.process(m_time, outcome)) {
+            dispatch(PdRequestStatusEvent{.request = outcome.request,
+                                          .result = outcome.result});
+        }
+        dispatch(SystemTickEvent{1});
+        m_state_machine->flushUI();
+    }
+
+    auto updateLoad() -> void {
+        auto contract = pdsink.getContract();
+        int32_t voltage = contract.voltage;   // mV
+        int32_t current = 0;                  // mA
+        if (m_output_enable.read() && load > 0) {
+            current = voltage * 1000 / load;
+            if (contract.current > 0 && current > contract.current) {
+                current = contract.current;
+                voltage = current * load / 1000;
+            }
+        }
+        sensor.setMeasurement(voltage * 1000, current * 1000);
+    }
+
+    std::vector<uint8_t> m_flash_storage;
+    RamFlash m_calibration_flash{
+        std::span(m_flash_storage).first(RamFlash::getSectorSize())};
+    RamFlash m_settings_flash{
+        std::span(m_flash_storage).last(k_settings_flash_size)};
+    HostI2cBus m_i2c;
+    HostGpioPin m_output_enable;
+    Ssd1306_128x64 m_oled{m_i2c};
+    Ina226 m_ina226{m_i2c, Ina226I2cTarget::k_i2c_addr};
+    Ap33772s m_ap33772s{m_i2c};
+    CalibrationStore m_calibration_store{m_calibration_flash,
+                                         k_calibration_magic};
+    SettingsStore m_settings{m_settings_flash, k_settings_magic};
+    OutputSequencer m_sequencer;
+    PdRequestQueue m_pd_requests{m_ap33772s};
+    HardwareContext m_hardware{.pdsink = m_ap33772s,
+                               .pd_requests = m_pd_requests,
+                               .sequencer = m_sequencer,
+                               .output_enable = m_output_enable,
+                               .oled = m_oled,
+                               .sensor = m_ina226,
+                               .calibration_store = m_calibration_store,
+                               .settings = m_settings};
+    std::array<uint8_t, Ssd1306_128x64::getFrameBufferSize()> m_frame_buffer{};
+    std::optional<StateMachine> m_state_machine;
+    RemoteReply m_reply;
+    uint32_t m_time{0};
+};
+
+#endif   // board_fixture_hpp
@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+
+#include "board_fixture.hpp"
+
+using Type = RemoteCommand::Type;
+
+// A reference meter at the output reads 1 % more than the sensor, plus 20 mV
+static auto readReference(int32_t voltage) -> int32_t {
+    return voltage + (voltage / 100) + 20'000;
+}
+
+static auto setOutput(BoardFixture& board, int32_t voltage) -> void {
+    board.remote(Type::SetVoltage, {voltage});
+    board.run(200);
+}
+
+TEST_CASE("Captures need a calibration session") {
+    auto board = std::make_unique<BoardFixture>();
+    board->remote(Type::CalibrationVoltage, {5'000'000});
+    CHECK(board->getRemoteError() == ScpiError::SettingsConflict);
+    board->remote(Type::CalibrationSave);
+    CHECK(board->getRemoteError() == ScpiError::SettingsConflict);
+}
+
+TEST_CASE("A two point calibration is applied and stored") {
+    auto board = std::make_unique<BoardFixture>();
+    board->enterMainState();
+    // Keep the load out of constant current
+    board->remote(Type::SetCurrent, {3000});
+    board->remote(Type::SetOutput, {1});
+
+    board->remote(Type::CalibrationStart);
+    REQUIRE(board->getRemoteError() == ScpiError::None);
+    setOutput(*board, 5000);
+    board->remote(Type::CalibrationVoltage, {readReference(5'000'000)});
+    REQUIRE(board->getRemoteError() == ScpiError::None);
+    setOutput(*board, 10000);
+    board->remote(Type::CalibrationVoltage, {readReference(10'000'000)});
+    board->remote(Type::CalibrationSave);
+    REQUIRE(board->getRemoteError() == ScpiError::None);
+
+    setOutput(*board, 8000);
+    CHECK(board->remote(Type::MeasureVoltage) == "8.100");
+
+    // The correction is loaded from flash at the next start
+    auto restarted = std::make_unique<BoardFixture>(board->getFlash());
+    auto gain = restarted->getSensor().getCalibration().voltage.gain;
+    CHECK(gain > LinearCorrection::k_unity_gain);
+}
+
+TEST_CASE("A calibration without two captures is not saved") {
+    auto board = std::make_unique<BoardFixture>();
+    board->enterMainState();
+    board->remote(Type::SetOutput, {1});
+    setOutput(*board, 5000);
+
+    board->remote(Type::CalibrationStart);
+    board->remote(Type::CalibrationVoltage, {readReference(5'000'000)});
+    board->remote(Type::CalibrationSave);
+    CHECK(board->getRemoteError() == ScpiError::SettingsConflict);
+    CHECK(board->getSensor().getCalibration().voltage.gain ==
+          LinearCorrection::k_unity_gain);
+}
+
+TEST_CASE("An aborted calibration restores the stored correction") {
+    auto board = std::make_unique<BoardFixture>();
+    board->enterMainState();
+    board->remote(Type::SetOutput, {1});
+    Ina226::Calibration stored{};
+    stored.current.offset = 5000;
+    board->getSensor().setCalibration(stored);
+
+    board->remote(Type::CalibrationStart);
+    CHECK(board->getSensor().getCalibration().current.offset == 0);
+    board->remote(Type::CalibrationAbort);
+    CHECK(board->getRemoteError() == ScpiError::None);
+    CHECK(board->getSensor().getCalibration().current.offset == 5000);
+
+    board->remote(Type::CalibrationReset);
+    CHECK(board->getSensor().getCalibration().current.offset == 0);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+#include "current_regulator.hpp"
+
+// Samples every 10 ms, the source follows a request right away
+static constexpr uint32_t k_period = 10'000;   // us
+
+/**
+ * @brief Programmable source feeding a resistive load
+ */
+struct ResistiveLoad {
+    int32_t resistance;   // mOhm
+    uint16_t voltage;     // mV, last request
+    uint32_t timestamp{0};
+    uint32_t request_count{0};
+
+    // Feeds samples for the duration in ms, applies every new request
+    auto run(CurrentRegulator& regulator, uint32_t duration) -> void {
+        for (uint32_t elapsed = 0; elapsed < duration * 1000;
+             elapsed += k_period, timestamp += k_period) {
+            int32_t current = voltage * 1000 / resistance;
+            if (regulator.addSample(timestamp, voltage, current)) {
+                voltage = regulator.getRequestVoltage();
+                ++request_count;
+            }
+        }
+    }
+
+    [[nodiscard]] auto getCurrent() const -> int32_t {
+        return voltage * 1000 / resistance;
+    }
+};
+
+static auto startRegulator(uint16_t voltage, uint16_t current)
+    -> CurrentRegulator {
+    CurrentRegulator regulator;
+    regulator.setLimits(3300, 20);
+    regulator.setTarget(voltage, current);
+    regulator.start();
+    return regulator;
+}
+
+TEST_CASE("A stopped regulator ignores samples") {
+    CurrentRegulator regulator;
+    regulator.setLimits(3300, 20);
+    regulator.setTarget(5000, 1000);
+    ResistiveLoad load{.resistance = 1000, .voltage = 5000};
+    load.run(regulator, 2000);
+    CHECK_FALSE(regulator.isRunning());
+    CHECK(load.request_count == 0);
+    CHECK(regulator.getMode() == SupplyMode::CV);
+}
+
+TEST_CASE("A light load keeps the voltage setpoint") {
+    auto regulator = startRegulator(5000, 1000);
+    ResistiveLoad load{.resistance = 10'000, .voltage = 5000};
+    load.run(regulator, 2000);
+    CHECK(load.request_count == 0);
+    CHECK(regulator.getRequestVoltage() == 5000);
+    CHECK(regulator.getMode() == SupplyMode::CV);
+}
+
+TEST_CASE("A heavy load is limited to the current setpoint") {
+    auto regulator = startRegulator(12'000, 2000);
+    ResistiveLoad load{.resistance = 3000, .voltage = 12'000};
+    load.run(regulator, 5000);
+    CHECK(regulator.getMode() == SupplyMode::CC);
+    CHECK(load.getCurrent() == Approx(2000).margin(20));
+    CHECK(regulator.getRequestVoltage() % 20 == 0);
+}
+
+TEST_CASE("The voltage does not drop below the source minimum") {
+    auto regulator = startRegulator(5000, 1000);
+    ResistiveLoad load{.resistance = 1000, .voltage = 5000};
+    load.run(regulator, 5000);
+    CHECK(regulator.getMode() == SupplyMode::CC);
+    CHECK(regulator.getRequestVoltage() == 3300);
+}
+
+TEST_CASE("The voltage setpoint returns once the load allows it") {
+    auto regulator = startRegulator(12'000, 2000);
+    ResistiveLoad load{.resistance = 3000, .voltage = 12'000};
+    load.run(regulator, 5000);
+    REQUIRE(regulator.getMode() == SupplyMode::CC);
+    load.resistance = 20'000;
+    load.run(regulator, 5000);
+    CHECK(regulator.getMode() == SupplyMode::CV);
+    CHECK(regulator.getRequestVoltage() == 12'000);
+}
+
+TEST_CASE("Requests are spaced by the request interval") {
+    auto regulator = startRegulator(12'000, 2000);
+    ResistiveLoad load{.resistance = 3000, .voltage = 12'000};
+    load.run(regulator, 1000);
+    // The first sample only sets the reference
+    CHECK(load.request_count > 0);
+    CHECK(load.request_count <= 9);
+}
+
+TEST_CASE("A new voltage setpoint applies right away in CV") {
+    auto regulator = startRegulator(5000, 1000);
+    regulator.setTarget(9000, 1000);
+    CHECK(regulator.getRequestVoltage() == 9000);
+    ResistiveLoad load{.resistance = 20'000, .voltage = 9000};
+    load.run(regulator, 2000);
+    CHECK(load.request_count == 0);
+    CHECK(regulator.getMode() == SupplyMode::CV);
+}
+
+TEST_CASE("Stopping returns the request to the voltage setpoint") {
+    auto regulator = startRegulator(12'000, 2000);
+    ResistiveLoad load{.resistance = 3000, .voltage = 12'000};
+    load.run(regulator, 5000);
+    REQUIRE(regulator.getRequestVoltage() < 12'000);
+    regulator.stop();
+    CHECK(regulator.getRequestVoltage() == 12'000);
+    CHECK(regulator.getMode() == SupplyMode::CV);
+}
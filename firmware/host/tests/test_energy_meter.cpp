@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+#include "energy_meter.hpp"
+
+static constexpr uint32_t k_us_per_hour = 3'600'000'000;
+
+// Feed a constant sample every period for the given time
+static auto feed(EnergyMeter& meter, uint32_t& timestamp, uint32_t duration,
+                 uint32_t period, int32_t power, int32_t current) -> void {
+    for (uint32_t elapsed = 0; elapsed < duration; elapsed += period) {
+        timestamp += period;
+        meter.addSample(timestamp, power, current);
+    }
+}
+
+TEST_CASE("Power and current are integrated over time") {
+    EnergyMeter meter;
+    uint32_t timestamp = 0;
+    meter.start();
+    meter.addSample(timestamp, 0, 0);
+    // 5 W and 1 A for 36 s
+    feed(meter, timestamp, 36'000'000, 1000, 5'000'000, 1'000'000);
+    CHECK(meter.getEnergy() == 50'000);
+    CHECK(meter.getCharge() == 10'000);
+    CHECK(meter.getElapsedTime() == 36'000'000);
+}
+
+TEST_CASE("Fractions of a milliampere add up") {
+    EnergyMeter meter;
+    uint32_t timestamp = 0;
+    meter.start();
+    meter.addSample(timestamp, 0, 0);
+    // 0.4 mA at 1 kHz for an hour would be lost when rounded to mA
+    feed(meter, timestamp, k_us_per_hour, 1000, 2000, 400);
+    CHECK(meter.getCharge() == 400);
+    CHECK(meter.getEnergy() == 2000);
+}
+
+TEST_CASE("Irregular periods do not drift") {
+    EnergyMeter meter;
+    uint32_t timestamp = 0xFFFF'0000;   // wraps around on the way
+    meter.start();
+    meter.addSample(timestamp, 0, 0);
+    feed(meter, timestamp, 18'000'000, 1000, 0, 1'000'000);
+    feed(meter, timestamp, 18'000'000, 9000, 0, 1'000'000);
+    CHECK(meter.getCharge() == 10'000);
+}
+
+TEST_CASE("The totals survive a stop and a restart") {
+    EnergyMeter meter;
+    uint32_t timestamp = 0;
+    meter.start();
+    meter.addSample(timestamp, 0, 0);
+    feed(meter, timestamp, 36'000'000, 1000, 0, 1'000'000);
+    meter.stop();
+    // Nothing is integrated while stopped, also not the gap
+    feed(meter, timestamp, 36'000'000, 1000, 0, 1'000'000);
+    meter.start();
+    meter.addSample(timestamp, 0, 0);
+    feed(meter, timestamp, 36'000'000, 1000, 0, 1'000'000);
+    CHECK(meter.getCharge() == 20'000);
+    CHECK(meter.getElapsedTime() == 72'000'000);
+}
+
+TEST_CASE("A reset clears the totals only") {
+    EnergyMeter meter;
+    uint32_t timestamp = 0;
+    meter.start();
+    meter.addSample(timestamp, 0, 0);
+    feed(meter, timestamp, 36'000'000, 1000, 5'000'000, 1'000'000);
+    meter.reset();
+    CHECK(meter.getEnergy() == 0);
+    CHECK(meter.getCharge() == 0);
+    CHECK(meter.getElapsedTime() == 0);
+    CHECK(meter.isRunning());
+    feed(meter, timestamp, 36'000'000, 1000, 5'000'000, 1'000'000);
+    CHECK(meter.getEnergy() == 50'000);
+}
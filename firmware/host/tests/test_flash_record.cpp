@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "flash_record.hpp"
+#include "ram_flash.hpp"
+
+static constexpr uint32_t k_magic = 0x52454331;
+
+/**
+ * @brief Record stored in the tests
+ */
+struct Sample {
+    int32_t gain;
+    int32_t offset;
+};
+
+/**
+ * @brief Blank flash sector
+ */
+struct RecordFixture {
+    std::vector<uint8_t> storage =
+        std::vector<uint8_t>(RamFlash::k_sector_size, 0xFF);
+    RamFlash flash{storage};
+    FlashRecord<RamFlash, Sample> record{flash, k_magic};
+};
+
+TEST_CASE("An erased flash holds no record") {
+    RecordFixture fixture;
+    Sample sample{.gain = 1, .offset = 2};
+    CHECK_FALSE(fixture.record.load(sample));
+    CHECK(sample.gain == 1);
+}
+
+TEST_CASE("A saved record is loaded") {
+    RecordFixture fixture;
+    REQUIRE(fixture.record.save({.gain = 1000, .offset = -20}));
+    Sample sample{};
+    REQUIRE(fixture.record.load(sample));
+    CHECK(sample.gain == 1000);
+    CHECK(sample.offset == -20);
+}
+
+TEST_CASE("An unchanged record is not written again") {
+    RecordFixture fixture;
+    fixture.record.save({.gain = 1000, .offset = -20});
+    auto erase_count = fixture.flash.getEraseCount();
+    CHECK(fixture.record.save({.gain = 1000, .offset = -20}));
+    CHECK(fixture.flash.getEraseCount() == erase_count);
+}
+
+TEST_CASE("Foreign and damaged records are rejected") {
+    RecordFixture fixture;
+    fixture.record.save({.gain = 1000, .offset = -20});
+    Sample sample{};
+
+    FlashRecord<RamFlash, Sample> other{fixture.flash, k_magic + 1};
+    CHECK_FALSE(other.load(sample));
+    FlashRecord<RamFlash, std::array<int32_t, 3>> resized{fixture.flash,
+                                                          k_magic};
+    std::array<int32_t, 3> values{};
+    CHECK_FALSE(resized.load(values));
+
+    // A bit of the payload flips
+    fixture.storage[12] ^= 0x01;
+    CHECK_FALSE(fixture.record.load(sample));
+}
+
+TEST_CASE("A save cut by a power loss is not loaded") {
+    RecordFixture fixture;
+    fixture.record.save({.gain = 1000, .offset = -20});
+    fixture.flash.setPowerBudget(RamFlash::k_sector_size + 14);
+    CHECK_FALSE(fixture.record.save({.gain = 2000, .offset = 0}));
+    Sample sample{};
+    CHECK_FALSE(fixture.record.load(sample));
+}
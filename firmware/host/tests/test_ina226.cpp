@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+
+#include "hardware_config.hpp"
+#include "ina226.hpp"
+#include "ina226_i2c_target.hpp"
+
+static constexpr int32_t k_shunt = 10'000;   // uOhm
+
+TEST_CASE("The current range covers the over-current limit") {
+    Ina226I2cTarget target{k_shunt};
+    HostI2cBus i2c;
+    REQUIRE(i2c.attach(Ina226I2cTarget::k_i2c_addr, target));
+    Ina226 sensor{i2c, Ina226I2cTarget::k_i2c_addr};
+
+    REQUIRE(sensor.calibrate(8, 0.01));
+    CHECK(sensor.getCurrentRange() >= 8000);
+
+    // Above the 5.5 A limit, the register must not saturate
+    target.setMeasurement(5'000'000, 6'000'000);
+    CHECK(sensor.getCurrentMicro() == Approx(6'000'000).margin(1000));
+    CHECK_FALSE(target.isOverflow());
+
+    // A 5 A range saturates below the limit
+    REQUIRE(sensor.calibrate(5, 0.01));
+    CHECK(sensor.getCurrentRange() < 5500);
+}
+
+TEST_CASE("The alert fires above the over-current limit") {
+    Ina226I2cTarget target{k_shunt};
+    HostI2cBus i2c;
+    REQUIRE(i2c.attach(Ina226I2cTarget::k_i2c_addr, target));
+    Ina226 sensor{i2c, Ina226I2cTarget::k_i2c_addr};
+    REQUIRE(sensor.calibrate(8, 0.01));
+    REQUIRE(sensor.setOverCurrentLimit(2000));
+
+    target.setMeasurement(5'000'000, 1'900'000);
+    CHECK_FALSE(target.isAlert());
+    target.setMeasurement(5'000'000, 2'100'000);
+    CHECK(target.isAlert());
+
+    bool is_alert = false;
+    REQUIRE(sensor.readAlertFlag(is_alert));
+    CHECK(is_alert);
+}
@@ -0,0 +1,46 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+#include "linear_correction.hpp"
+
+TEST_CASE("The default correction keeps the value") {
+    LinearCorrection correction;
+    CHECK(correction.apply(0) == 0);
+    CHECK(correction.apply(12'345'678) == 12'345'678);
+    CHECK(correction.apply(-5000) == -5000);
+}
+
+TEST_CASE("Two points give gain and offset") {
+    // The reference reads 1 % more plus 20 mV, in uV
+    LinearCorrection correction;
+    REQUIRE(LinearCorrection::fromTwoPoints(5'000'000, 5'070'000, 10'000'000,
+                                            10'120'000, correction));
+    CHECK(correction.apply(5'000'000) == 5'070'000);
+    CHECK(correction.apply(10'000'000) == 10'120'000);
+    CHECK(correction.apply(20'000'000) == 20'220'000);
+}
+
+TEST_CASE("The order of the points does not matter") {
+    LinearCorrection forward;
+    LinearCorrection backward;
+    REQUIRE(LinearCorrection::fromTwoPoints(100'000, 98'000, 3'000'000,
+                                            2'990'000, forward));
+    REQUIRE(LinearCorrection::fromTwoPoints(3'000'000, 2'990'000, 100'000,
+                                            98'000, backward));
+    CHECK(forward == backward);
+}
+
+TEST_CASE("Unusable points are rejected") {
+    LinearCorrection correction{.gain = 123, .offset = 4};
+    // Same measured value
+    CHECK_FALSE(LinearCorrection::fromTwoPoints(5000, 5000, 5000, 6000,
+                                                correction));
+    // The reference falls while the measurement rises
+    CHECK_FALSE(LinearCorrection::fromTwoPoints(5000, 6000, 6000, 5000,
+                                                correction));
+    // A gain of 2 or more is not representable
+    CHECK_FALSE(LinearCorrection::fromTwoPoints(1000, 1000, 2000, 3000,
+                                                correction));
+    CHECK(correction == LinearCorrection{.gain = 123, .offset = 4});
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board_fixture.hpp"
+#include "log_store.hpp"
+#include "ram_flash.hpp"
+
+static constexpr uint32_t k_magic = 0x54455354;
+static constexpr uint32_t k_sector_count = 4;
+
+using Store = LogStore<RamFlash, 8>;
+
+/**
+ * @brief Blank flash region with a store on it
+ */
+struct StoreFixture {
+    StoreFixture() { REQUIRE(store.mount()); }
+
+    // A fresh store on the same flash, like after a restart
+    auto remount() -> Store {
+        Store restarted{flash, k_magic};
+        REQUIRE(restarted.mount());
+        return restarted;
+    }
+
+    std::vector<uint8_t> storage =
+        std::vector<uint8_t>(k_sector_count * RamFlash::k_sector_size, 0xFF);
+    RamFlash flash{storage};
+    Store store{flash, k_magic};
+};
+
+TEST_CASE("Values are read back after a restart") {
+    StoreFixture fixture;
+    CHECK(fixture.store.write<uint32_t>(1, 0x12345678));
+    CHECK(fixture.store.write<uint16_t>(2, 42));
+    CHECK(fixture.store.write<uint32_t>(1, 7));
+
+    auto store = fixture.remount();
+    uint32_t first = 0;
+    uint16_t second = 0;
+    CHECK(store.read(1, first));
+    CHECK(first == 7);
+    CHECK(store.read(2, second));
+    CHECK(second == 42);
+}
+
+TEST_CASE("A value of another size is not read") {
+    StoreFixture fixture;
+    fixture.store.write<uint16_t>(1, 42);
+    uint32_t value = 5;
+    CHECK_FALSE(fixture.store.read(1, value));
+    CHECK(value == 5);
+    CHECK_FALSE(fixture.store.read(3, value));
+}
+
+TEST_CASE("The number of keys is limited") {
+    StoreFixture fixture;
+    for (uint16_t key = 0; key < 8; ++key) {
+        CHECK(fixture.store.write(key, key));
+    }
+    CHECK_FALSE(fixture.store.write<uint16_t>(8, 8));
+    CHECK(fixture.store.write<uint16_t>(7, 70));
+    CHECK_FALSE(fixture.store.write<uint16_t>(0xFFFF, 1));
+}
+
+TEST_CASE("The latest values survive the compaction into the next sector") {
+    StoreFixture fixture;
+    fixture.store.write<uint32_t>(1, 1000);
+    // Several sectors worth of records, every sector is erased evenly
+    for (uint32_t i = 0; i < 1000; ++i) {
+        REQUIRE(fixture.store.write<uint32_t>(2, i));
+    }
+    CHECK(fixture.flash.getEraseCount() >= k_sector_count);
+
+    auto store = fixture.remount();
+    uint32_t value = 0;
+    CHECK(store.read(1, value));
+    CHECK(value == 1000);
+    CHECK(store.read(2, value));
+    CHECK(value == 999);
+}
+
+TEST_CASE("A torn write keeps the previous value") {
+    StoreFixture fixture;
+    fixture.store.write<uint32_t>(1, 5);
+    fixture.flash.setPowerBudget(6);
+    CHECK_FALSE(fixture.store.write<uint32_t>(1, 6));
+    fixture.flash.setPowerBudget(RamFlash::k_unlimited);
+
+    auto store = fixture.remount();
+    uint32_t value = 0;
+    CHECK(store.read(1, value));
+    CHECK(value == 5);
+    // The torn slot is skipped, later writes go on
+    CHECK(store.write<uint32_t>(1, 7));
+    CHECK(fixture.remount().read(1, value));
+    CHECK(value == 7);
+}
+
+TEST_CASE("Records after a failed write are replayed") {
+    StoreFixture fixture;
+    fixture.store.write<uint32_t>(1, 5);
+    // The program fails before it touches the flash, the slot stays blank
+    fixture.flash.setPowerBudget(0);
+    CHECK_FALSE(fixture.store.write<uint32_t>(1, 6));
+    fixture.flash.setPowerBudget(RamFlash::k_unlimited);
+    CHECK(fixture.store.write<uint32_t>(1, 7));
+    CHECK(fixture.store.write<uint32_t>(2, 9));
+
+    auto store = fixture.remount();
+    uint32_t value = 0;
+    CHECK(store.read(1, value));
+    CHECK(value == 7);
+    CHECK(store.read(2, value));
+    CHECK(value == 9);
+    // The next record goes behind the replayed ones
+    CHECK(store.write<uint32_t>(2, 10));
+    CHECK(fixture.remount().read(2, value));
+    CHECK(value == 10);
+}
+
+TEST_CASE("A failed compaction keeps the active sector") {
+    StoreFixture fixture;
+    fixture.store.write<uint32_t>(1, 5);
+    uint32_t i = 0;
+    while (fixture.flash.getEraseCount() == 0) {
+        REQUIRE(fixture.store.write<uint32_t>(2, i++));
+    }
+    // The header and both keys take 3 of the 256 slots of the new sector,
+    // the power fails in the compaction after the rest is filled
+    auto erase_count = fixture.flash.getEraseCount();
+    for (uint32_t slot = 3; slot < 256; ++slot) {
+        REQUIRE(fixture.store.write<uint32_t>(2, i++));
+    }
+    REQUIRE(fixture.flash.getEraseCount() == erase_count);
+    fixture.flash.setPowerBudget(100);
+    CHECK_FALSE(fixture.store.write<uint32_t>(2, i));
+    fixture.flash.setPowerBudget(RamFlash::k_unlimited);
+
+    auto store = fixture.remount();
+    uint32_t value = 0;
+    CHECK(store.read(1, value));
+    CHECK(value == 5);
+    CHECK(store.read(2, value));
+    CHECK(value == i - 1);
+}
+
+TEST_CASE("UI preferences are saved once the encoder rests") {
+    using Encoder = RotaryEncoder::State;
+    auto board = std::make_unique<BoardFixture>();
+    board->enterMainState();
+    board->getSettingsFlash().setPowerBudget(0);
+
+    board->dispatch(RotaryEncoderEvent{Encoder::rot_inc_while_btn_press});
+    board->run(500);
+    board->dispatch(RotaryEncoderEvent{Encoder::rot_inc_while_btn_press});
+    board->run(1000);
+    CHECK(board->getSettingsFailureCount() == 0);
+    // The failed write is counted for the remote error queue
+    board->run(1500);
+    CHECK(board->getSettingsFailureCount() == 1);
+}
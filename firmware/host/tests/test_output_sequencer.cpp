@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+#include "output_sequencer.hpp"
+
+using Step = OutputSequencer::Step;
+
+static constexpr uint32_t k_ms = 1000;   // us
+
+// Holds the voltage for 10 ms
+static auto makeStep(uint16_t voltage, uint16_t current = 1000) -> Step {
+    return {.voltage = voltage, .current = current, .duration = 10 * k_ms};
+}
+
+// Plays the list in 1 ms steps, the measured values follow the request
+static auto run(OutputSequencer& sequencer, uint32_t& timestamp,
+                uint32_t duration, int32_t current = 100) -> void {
+    for (uint32_t i = 0; i < duration; ++i, timestamp += k_ms) {
+        sequencer.update(timestamp);
+        sequencer.addSample(timestamp, sequencer.getVoltage(), current);
+    }
+}
+
+TEST_CASE("A list without duration does not start") {
+    OutputSequencer sequencer;
+    CHECK_FALSE(sequencer.start(5000));
+    sequencer.addStep({.voltage = 5000, .current = 1000, .duration = 0});
+    CHECK_FALSE(sequencer.start(5000));
+    CHECK_FALSE(sequencer.isRunning());
+}
+
+TEST_CASE("Steps start at their deadlines") {
+    OutputSequencer sequencer;
+    sequencer.addStep(makeStep(5000));
+    sequencer.addStep(makeStep(9000, 2000));
+    REQUIRE(sequencer.start(3300));
+    CHECK(sequencer.update(0));
+    CHECK(sequencer.getVoltage() == 5000);
+    CHECK(sequencer.getCurrent() == 1000);
+    CHECK_FALSE(sequencer.update((10 * k_ms) - 1));
+    CHECK(sequencer.update(10 * k_ms));
+    CHECK(sequencer.getStepIndex() == 1);
+    CHECK(sequencer.getVoltage() == 9000);
+    CHECK(sequencer.getCurrent() == 2000);
+}
+
+TEST_CASE("A late update does not shift the following steps") {
+    OutputSequencer sequencer;
+    for (uint16_t voltage : {5000, 6000, 7000, 8000}) {
+        sequencer.addStep(makeStep(voltage));
+    }
+    REQUIRE(sequencer.start(5000));
+    sequencer.update(0);
+    // The second step is skipped entirely
+    sequencer.update(25 * k_ms);
+    CHECK(sequencer.getStepIndex() == 2);
+    CHECK(sequencer.getVoltage() == 7000);
+    CHECK(sequencer.getStatistics().max_lateness == 15 * k_ms);
+    sequencer.update(30 * k_ms);
+    CHECK(sequencer.getStepIndex() == 3);
+    CHECK(sequencer.getStatistics().step_count == 4);
+    CHECK(sequencer.getCapture(2).timestamp == 20 * k_ms);
+}
+
+TEST_CASE("A ramp moves from the previous voltage in whole steps") {
+    OutputSequencer sequencer;
+    sequencer.setVoltageStep(20);
+    sequencer.addStep({.voltage = 9000,
+                       .current = 1000,
+                       .duration = 10 * k_ms,
+                       .is_ramp = true});
+    REQUIRE(sequencer.start(5000));
+    sequencer.update(0);
+    CHECK(sequencer.getVoltage() == 5000);
+    sequencer.update(2500);
+    CHECK(sequencer.getVoltage() == 6000);
+    sequencer.update(3333);
+    CHECK(sequencer.getVoltage() == 6340);
+    sequencer.update(10 * k_ms);
+    CHECK_FALSE(sequencer.isRunning());
+    CHECK(sequencer.getVoltage() == 9000);
+}
+
+TEST_CASE("The list is played the set number of times") {
+    OutputSequencer sequencer;
+    sequencer.addStep(makeStep(5000));
+    sequencer.addStep(makeStep(9000));
+    sequencer.setLoopCount(2);
+    REQUIRE(sequencer.start(5000));
+    uint32_t timestamp = 0;
+    run(sequencer, timestamp, 40);
+    CHECK(sequencer.isRunning());
+    CHECK(sequencer.getLoop() == 1);
+    run(sequencer, timestamp, 1);
+    CHECK_FALSE(sequencer.isRunning());
+    CHECK(sequencer.getLoop() == 2);
+    CHECK(sequencer.getStepIndex() == 1);
+    CHECK(sequencer.getVoltage() == 9000);
+}
+
+TEST_CASE("A loop count of 0 plays until stopped") {
+    OutputSequencer sequencer;
+    sequencer.addStep(makeStep(5000));
+    sequencer.setLoopCount(0);
+    REQUIRE(sequencer.start(5000));
+    uint32_t timestamp = 0;
+    run(sequencer, timestamp, 1000);
+    CHECK(sequencer.isRunning());
+    CHECK(sequencer.getLoop() == 99);
+    sequencer.stop();
+    CHECK_FALSE(sequencer.update(timestamp));
+    CHECK_FALSE(sequencer.isRunning());
+}
+
+TEST_CASE("Captures skip the settling time") {
+    OutputSequencer sequencer{{.settling_time = 3 * k_ms}};
+    sequencer.addStep(makeStep(5000));
+    REQUIRE(sequencer.start(5000));
+    uint32_t timestamp = 0;
+    // A spike during the settling time is not captured
+    run(sequencer, timestamp, 3, 900);
+    run(sequencer, timestamp, 6, 200);
+    run(sequencer, timestamp, 1, 500);
+    sequencer.update(timestamp);
+    CHECK_FALSE(sequencer.isRunning());
+    auto capture = sequencer.getCapture(0);
+    CHECK(capture.sample_count == 7);
+    CHECK(capture.voltage == 5000);
+    CHECK(capture.current == 242);
+    CHECK(capture.current_max == 500);
+    CHECK(capture.loop == 0);
+}
+
+TEST_CASE("Steps are only added while the list is stopped") {
+    OutputSequencer sequencer;
+    for (size_t i = 0; i < OutputSequencer::k_max_steps; ++i) {
+        REQUIRE(sequencer.addStep(
+            {.voltage = 5000, .current = 1000, .duration = k_ms}));
+    }
+    CHECK_FALSE(sequencer.addStep({.voltage = 5000, .duration = k_ms}));
+    sequencer.clear();
+    CHECK(sequencer.getStepCount() == 0);
+    sequencer.addStep({.voltage = 5000, .current = 1000, .duration = k_ms});
+    REQUIRE(sequencer.start(5000));
+    CHECK_FALSE(sequencer.addStep({.voltage = 5000, .duration = k_ms}));
+    CHECK(sequencer.getStepCount() == 1);
+}
+
+TEST_CASE("The deadlines survive a wrap around of the time") {
+    OutputSequencer sequencer;
+    sequencer.addStep(makeStep(5000));
+    sequencer.addStep(makeStep(9000));
+    REQUIRE(sequencer.start(5000));
+    uint32_t timestamp = UINT32_MAX - (5 * k_ms) + 1;
+    run(sequencer, timestamp, 11);
+    CHECK(sequencer.getStepIndex() == 1);
+    run(sequencer, timestamp, 10);
+    CHECK_FALSE(sequencer.isRunning());
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "pd_request_queue.hpp"
+
+using Request = PdRequestQueue::Request;
+using Result = PdRequestQueue::Result;
+
+/**
+ * @brief PD sink that records the requests and answers with a set result
+ */
+class FakePdSink : public IPdSink {
+  public:
+    auto probe() -> bool override { return true; }
+    auto getStatus() -> Status override { return {}; }
+    void clearStatus() override {}
+    auto getFaultDetails() -> Faults override { return {}; }
+    auto getTemp() -> uint8_t override { return 25; }
+    auto getPDSourcePowerCapabilities() -> uint8_t override { return 0; }
+    auto getSourceFingerprint() const -> uint32_t override { return 0; }
+    auto getPdo(uint8_t /*index*/, Pdo& /*pdo*/) -> bool override {
+        return false;
+    }
+
+    auto requestPdo(uint8_t index, uint16_t voltage, uint16_t current)
+        -> bool override {
+        requests.push_back({index, voltage, current});
+        result = Result::Pending;
+        return is_responding;
+    }
+
+    auto getRequestResult() -> RequestResult override {
+        ++poll_count;
+        return result;
+    }
+
+    std::vector<Request> requests;
+    Result result{Result::Pending};
+    uint32_t poll_count{0};
+    bool is_responding{true};
+};
+
+// Processes the queue in 1 ms steps, returns true on the first outcome
+static auto run(PdRequestQueue& queue, uint32_t& timestamp, uint32_t duration,
+                PdRequestQueue::Outcome& outcome) -> bool {
+    for (uint32_t i = 0; i < duration; ++i, ++timestamp) {
+        if (queue.process(timestamp, outcome)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE("An accepted request is reported once") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    CHECK(queue.isPending());
+    CHECK_FALSE(run(queue, timestamp, 1, outcome));
+    REQUIRE(sink.requests.size() == 1);
+    CHECK_FALSE(queue.isPending());
+    CHECK(queue.isBusy());
+    sink.result = Result::Accepted;
+    REQUIRE(run(queue, timestamp, 10, outcome));
+    CHECK(outcome.request == Request{3, 5000, 1000});
+    CHECK(outcome.result == Result::Accepted);
+    CHECK_FALSE(queue.isBusy());
+    CHECK_FALSE(run(queue, timestamp, 1000, outcome));
+    CHECK(queue.getStatistics().accepted == 1);
+}
+
+TEST_CASE("Only the latest waiting request is sent") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    queue.submit({.index = 3, .voltage = 5100, .current = 1000});
+    queue.submit({.index = 3, .voltage = 5200, .current = 1000});
+    run(queue, timestamp, 1, outcome);
+    REQUIRE(sink.requests.size() == 1);
+    CHECK(sink.requests.front().voltage == 5200);
+    CHECK(queue.getStatistics().submitted == 3);
+    CHECK(queue.getStatistics().coalesced == 2);
+}
+
+TEST_CASE("Requests are spaced by the minimum interval") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    sink.result = Result::Accepted;
+    run(queue, timestamp, 1, outcome);
+    sink.result = Result::Accepted;
+    REQUIRE(run(queue, timestamp, 10, outcome));
+    queue.submit({.index = 3, .voltage = 5100, .current = 1000});
+    run(queue, timestamp, 99 - timestamp, outcome);
+    CHECK(sink.requests.size() == 1);
+    run(queue, timestamp, 2, outcome);
+    CHECK(sink.requests.size() == 2);
+}
+
+TEST_CASE("The result is polled at the poll interval") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    run(queue, timestamp, 100, outcome);
+    CHECK(sink.poll_count == 19);
+}
+
+TEST_CASE("An unanswered request is sent again and then given up") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    REQUIRE(run(queue, timestamp, 4000, outcome));
+    CHECK(outcome.result == Result::Timeout);
+    CHECK(timestamp >= 3000);
+    CHECK(sink.requests.size() == 3);
+    CHECK(queue.getStatistics().retries == 2);
+    CHECK(queue.getStatistics().timeouts == 1);
+}
+
+TEST_CASE("A newer request replaces the retry of a timed out one") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    run(queue, timestamp, 500, outcome);
+    queue.submit({.index = 3, .voltage = 5100, .current = 1000});
+    REQUIRE(run(queue, timestamp, 1000, outcome));
+    CHECK(outcome.request.voltage == 5000);
+    CHECK(outcome.result == Result::Timeout);
+    CHECK(queue.getStatistics().retries == 0);
+    run(queue, timestamp, 1, outcome);
+    REQUIRE(sink.requests.size() == 2);
+    CHECK(sink.requests.back().voltage == 5100);
+}
+
+TEST_CASE("A rejection is final") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    run(queue, timestamp, 1, outcome);
+    sink.result = Result::Rejected;
+    REQUIRE(run(queue, timestamp, 10, outcome));
+    CHECK(outcome.result == Result::Rejected);
+    CHECK_FALSE(run(queue, timestamp, 3000, outcome));
+    CHECK(sink.requests.size() == 1);
+    CHECK(queue.getStatistics().rejected == 1);
+}
+
+TEST_CASE("A request the sink does not take is rejected right away") {
+    FakePdSink sink;
+    sink.is_responding = false;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    REQUIRE(run(queue, timestamp, 1, outcome));
+    CHECK(outcome.result == Result::Rejected);
+    CHECK(sink.poll_count == 0);
+    CHECK_FALSE(queue.isBusy());
+}
+
+TEST_CASE("A cancelled request is not sent") {
+    FakePdSink sink;
+    PdRequestQueue queue{sink};
+    PdRequestQueue::Outcome outcome;
+    uint32_t timestamp = 0;
+    queue.submit({.index = 3, .voltage = 5000, .current = 1000});
+    queue.cancel();
+    CHECK_FALSE(queue.isBusy());
+    CHECK_FALSE(run(queue, timestamp, 1000, outcome));
+    CHECK(sink.requests.empty());
+}
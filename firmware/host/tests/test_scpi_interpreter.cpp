@@ -0,0 +1,174 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "board_fixture.hpp"
+#include "scpi_interpreter.hpp"
+
+using Type = RemoteCommand::Type;
+
+/**
+ * @brief Both directions of the fake serial port
+ */
+struct SerialLink {
+    std::string input;
+    std::string output;
+};
+
+/**
+ * @brief Serial port that reads and writes strings
+ */
+class FakeSerial {
+  public:
+    explicit FakeSerial(SerialLink& link) : m_link(link) {}
+
+    auto read(std::span<uint8_t> data) const -> int {
+        auto count = std::min(data.size(), m_link.input.size());
+        std::copy_n(m_link.input.begin(), count, data.begin());
+        m_link.input.erase(0, count);
+        return static_cast<int>(count);
+    }
+
+    auto write(std::span<const uint8_t> data) const -> int {
+        m_link.output.append(data.begin(), data.end());
+        return static_cast<int>(data.size());
+    }
+
+  private:
+    SerialLink& m_link;
+};
+
+/**
+ * @brief Interpreter with a handler that records the commands
+ */
+class RemoteFixture {
+  public:
+    /**
+     * @brief Send a line and collect the reply
+     *
+     * VOLTage? is answered with the number of commands returned before it.
+     *
+     * @param[in] line Line without the line end
+     * @return Reply without the line end
+     */
+    auto send(const std::string& line) -> std::string {
+        m_link.input = line + "\n";
+        commands.clear();
+        RemoteCommand command;
+        for (int i = 0; i < 20; ++i) {
+            if (m_interpreter.poll(command)) {
+                commands.push_back(command);
+                if (command.type == Type::GetVoltage) {
+                    m_interpreter.getReply().append(
+                        static_cast<int32_t>(commands.size() - 1));
+                }
+            }
+        }
+        auto reply = m_link.output;
+        m_link.output.clear();
+        if (!reply.empty() && reply.back() == '\n') {
+            reply.pop_back();
+        }
+        return reply;
+    }
+
+    std::vector<RemoteCommand> commands;
+
+  private:
+    SerialLink m_link;
+    FakeSerial m_serial{m_link};
+    ScpiInterpreter<FakeSerial> m_interpreter{m_serial, "maker,model,0,1"};
+};
+
+TEST_CASE("Keywords match in the short and the long form") {
+    RemoteFixture remote;
+    remote.send("MEAS:VOLT?;measure:current?;Meas:ARRay?");
+    REQUIRE(remote.commands.size() == 3);
+    CHECK(remote.commands[0].type == Type::MeasureVoltage);
+    CHECK(remote.commands[1].type == Type::MeasureCurrent);
+    CHECK(remote.commands[2].type == Type::MeasureArray);
+}
+
+TEST_CASE("Parameters are converted to integers") {
+    RemoteFixture remote;
+    remote.send("VOLT 5.1;LIST:STEP 9,1.5,0.25;SENS:PROF 2;VOLT:TRIM ON");
+    REQUIRE(remote.commands.size() == 4);
+    CHECK(remote.commands[0].type == Type::SetVoltage);
+    CHECK(remote.commands[0].values[0] == 5100);
+    CHECK(remote.commands[1].values == std::array<int32_t, 3>{
+                                           9000, 1500, 250'000});
+    CHECK(remote.commands[2].type == Type::SetSensorProfile);
+    CHECK(remote.commands[2].values[0] == 2);
+    CHECK(remote.commands[3].type == Type::SetVoltageTrim);
+    CHECK(remote.commands[3].values[0] == 1);
+}
+
+TEST_CASE("The answers of a line are separated by semicolons") {
+    RemoteFixture remote;
+    CHECK(remote.send("VOLT?;*IDN?;VOLT?") == "0;maker,model,0,1;1");
+}
+
+TEST_CASE("Unanswered queries return not a number") {
+    RemoteFixture remote;
+    CHECK(remote.send("CURR?") == "9.91E+37");
+}
+
+TEST_CASE("Errors are queued until they are read") {
+    RemoteFixture remote;
+    CHECK(remote.send("FOO:BAR;VOLT").empty());
+    CHECK(remote.commands.empty());
+    CHECK(remote.send("SYST:ERR?") == "-113,\"Undefined header\"");
+    CHECK(remote.send("SYST:ERR?") == "-109,\"Missing parameter\"");
+    CHECK(remote.send("SYST:ERR?") == "0,\"No error\"");
+}
+
+TEST_CASE("The acquisition profile is set remotely and kept") {
+    auto board = std::make_unique<BoardFixture>();
+    board->remote(Type::SetSensorProfile, {3});
+    CHECK(board->getRemoteError() == ScpiError::DataOutOfRange);
+    board->remote(Type::SetSensorProfile, {2});
+    CHECK(board->getSensor().getProfile() == Ina226::Profile::Precision);
+
+    auto restarted = std::make_unique<BoardFixture>(board->getFlash());
+    CHECK(restarted->remote(Type::GetSensorProfile) == "2");
+}
+
+TEST_CASE("MEASure:ARRay? returns every sample since the last query") {
+    static constexpr size_t k_record_size = 16;
+    auto board = std::make_unique<BoardFixture>();
+    board->enterMainState();
+    board->remote(Type::MeasureArray);
+
+    board->run(5);
+    auto block = board->remote(Type::MeasureArray);
+    CHECK(block.substr(0, 4) == "#280");
+    REQUIRE(block.size() == 4 + (5 * k_record_size));
+    // The timestamps of the samples follow each other in us
+    auto getTime = [&block](size_t record) -> uint32_t {
+        uint32_t time = 0;
+        std::memcpy(&time, block.data() + 4 + (record * k_record_size),
+                    sizeof(time));
+        return time;
+    };
+    CHECK(getTime(4) - getTime(0) == 4000);
+    CHECK(getTime(4) == board->getTime() * 1000);
+
+    // A reader that falls behind gets the latest samples
+    board->run(100);
+    block = board->remote(Type::MeasureArray);
+    CHECK(block.substr(0, 5) == "#3512");
+    CHECK(board->remote(Type::MeasureArray) == "#10");
+}
+
+TEST_CASE("A command without a handler is reported in the main state") {
+    auto board = std::make_unique<BoardFixture>();
+    board->enterMainState();
+    // Stands for a command type added later without a handler
+    board->remote(static_cast<Type>(0xFF));
+    CHECK(board->getRemoteError() == ScpiError::SettingsConflict);
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+#include "short_circuit_detector.hpp"
+
+// Samples every 140 us, like the fast acquisition profile
+static constexpr uint32_t k_period = 140;
+
+// Feeds samples at a constant voltage, returns true on the first detection
+static auto feed(ShortCircuitDetector& detector, uint32_t& timestamp,
+                 int32_t voltage, uint32_t duration) -> bool {
+    for (uint32_t elapsed = 0; elapsed < duration;
+         elapsed += k_period, timestamp += k_period) {
+        if (detector.addSample(timestamp, voltage)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE("A disarmed detector ignores samples") {
+    ShortCircuitDetector detector;
+    uint32_t timestamp = 0;
+    CHECK_FALSE(detector.isArmed());
+    CHECK_FALSE(feed(detector, timestamp, 0, 100'000));
+}
+
+TEST_CASE("The output ramps up during the blanking period") {
+    ShortCircuitDetector detector;
+    uint32_t timestamp = 0;
+    detector.arm();
+    CHECK_FALSE(feed(detector, timestamp, 0, 499'000));
+    CHECK(feed(detector, timestamp, 0, 30'000));
+    CHECK_FALSE(detector.isArmed());
+}
+
+TEST_CASE("A slow drop is reported after the detection window") {
+    ShortCircuitDetector detector{{.collapse_rate = 0}};
+    uint32_t timestamp = 0;
+    detector.arm();
+    REQUIRE_FALSE(feed(detector, timestamp, 5000, 600'000));
+    uint32_t low_timestamp = timestamp;
+    CHECK_FALSE(feed(detector, timestamp, 400, 19'000));
+    CHECK(feed(detector, timestamp, 400, 2'000));
+    CHECK(timestamp - low_timestamp >= 20'000);
+}
+
+TEST_CASE("A voltage recovering within the window is no short") {
+    ShortCircuitDetector detector{{.collapse_rate = 0}};
+    uint32_t timestamp = 0;
+    detector.arm();
+    REQUIRE_FALSE(feed(detector, timestamp, 5000, 600'000));
+    CHECK_FALSE(feed(detector, timestamp, 400, 15'000));
+    CHECK_FALSE(feed(detector, timestamp, 5000, 1'000));
+    CHECK_FALSE(feed(detector, timestamp, 400, 15'000));
+    CHECK(detector.isArmed());
+}
+
+TEST_CASE("A collapse is reported on the first low sample") {
+    ShortCircuitDetector detector;
+    uint32_t timestamp = 0;
+    detector.arm();
+    REQUIRE_FALSE(feed(detector, timestamp, 5000, 600'000));
+    CHECK(detector.addSample(timestamp, 100));
+}
+
+TEST_CASE("Timestamps may wrap around") {
+    ShortCircuitDetector detector{{.collapse_rate = 0}};
+    uint32_t timestamp = UINT32_MAX - 300'000;
+    detector.arm();
+    REQUIRE_FALSE(feed(detector, timestamp, 5000, 600'000));
+    CHECK(timestamp < 600'000);
+    CHECK(feed(detector, timestamp, 0, 21'000));
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "hardware_config.hpp"
+#include "ssd1306.hpp"
+#include "ssd1306_i2c_target.hpp"
+
+using Frame = std::array<uint8_t, Ssd1306_128x64::getFrameBufferSize()>;
+
+static uint32_t g_time = 0;   // us
+
+static auto getTime() -> uint32_t { return g_time; }
+
+/**
+ * @brief Display with hardware scrolling on the emulated controller
+ */
+struct ScrollFixture {
+    ScrollFixture() {
+        i2c.attach(Ssd1306I2cTarget::k_i2c_addr, display);
+        oled.initialize();
+        oled.enableHardwareScroll(true, getTime);
+        // A plot on the second page, one column per sample
+        for (size_t column = 0; column < 128; ++column) {
+            frame[128 + column] = static_cast<uint8_t>(1 << (column % 8));
+        }
+        oled.display(frame);
+    }
+
+    // Move the plot left by one column, a new sample enters on the right
+    auto scroll() -> uint32_t {
+        std::shift_left(frame.begin() + 128, frame.begin() + 256, 1);
+        frame[255] = static_cast<uint8_t>(g_time);
+        display.resetStatistics();
+        oled.display(frame);
+        return display.getStatistics().data_bytes;
+    }
+
+    Ssd1306I2cTarget display;
+    HostI2cBus i2c;
+    Ssd1306_128x64 oled{i2c};
+    Frame frame{};
+};
+
+static auto isShown(const ScrollFixture& fixture) -> bool {
+    auto ram = fixture.display.getRam();
+    return std::equal(ram.begin(), ram.end(), fixture.frame.begin());
+}
+
+TEST_CASE("A shifted page is scrolled by the controller") {
+    g_time = 1'000'000;
+    ScrollFixture fixture;
+    CHECK(fixture.scroll() < 16);
+    CHECK(isShown(fixture));
+}
+
+TEST_CASE("Scrolls are at least two display frames apart") {
+    g_time = 1'000'000;
+    ScrollFixture fixture;
+    CHECK(fixture.scroll() < 16);
+    g_time += 10'000;
+    // Too soon, the page is sent instead
+    CHECK(fixture.scroll() >= 128);
+    CHECK(isShown(fixture));
+    g_time += 30'000;
+    CHECK(fixture.scroll() < 16);
+    CHECK(isShown(fixture));
+}
+
+TEST_CASE("Without hardware scrolling the pages are sent") {
+    g_time = 1'000'000;
+    ScrollFixture fixture;
+    fixture.oled.enableHardwareScroll(false, getTime);
+    CHECK(fixture.scroll() >= 128);
+    CHECK(isShown(fixture));
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include <array>
+
+#include "task_scheduler.hpp"
+
+static uint32_t g_now = 0;
+static std::array<uint32_t, 3> g_run_counts{};
+
+static auto getNow() -> uint32_t { return g_now; }
+
+static auto countRun(uint32_t, void* context) -> void {
+    ++g_run_counts[*static_cast<size_t*>(context)];
+}
+
+TEST_CASE("Tasks run by priority, then by lateness") {
+    g_now = 0;
+    g_run_counts = {};
+    TaskScheduler<3> scheduler{getNow};
+    std::array<size_t, 3> ids{};
+    std::array<size_t, 3> indexes{0, 1, 2};
+    REQUIRE(scheduler.addTask(1000, 0, countRun, &indexes[0], ids[0]));
+    REQUIRE(scheduler.addTask(1000, 1, countRun, &indexes[1], ids[1]));
+    REQUIRE(scheduler.addTask(1000, 1, countRun, &indexes[2], ids[2]));
+
+    // All tasks are due at the start, the higher priority ones first
+    REQUIRE(scheduler.run());
+    REQUIRE(scheduler.run());
+    CHECK(g_run_counts == std::array<uint32_t, 3>{0, 1, 1});
+    REQUIRE(scheduler.run());
+    CHECK_FALSE(scheduler.run());
+
+    g_now = 1500;
+    REQUIRE(scheduler.run());
+    REQUIRE(scheduler.run());
+    CHECK(g_run_counts == std::array<uint32_t, 3>{1, 2, 2});
+}
+
+TEST_CASE("A late task ages into a higher priority") {
+    g_now = 0;
+    g_run_counts = {};
+    TaskScheduler<2> scheduler{getNow, 10'000};
+    size_t id = 0;
+    std::array<size_t, 2> indexes{0, 1};
+    REQUIRE(scheduler.addTask(5000, 0, countRun, &indexes[0], id));
+    // Always due, like polling a sensor as fast as it converts
+    REQUIRE(scheduler.addTask(0, 1, countRun, &indexes[1], id));
+
+    // Strict priority would run the polling task forever
+    for (; g_now < 9'900; g_now += 100) {
+        scheduler.run();
+    }
+    CHECK(g_run_counts[0] == 0);
+    for (; g_now < 10'200; g_now += 100) {
+        scheduler.run();
+    }
+    CHECK(g_run_counts[0] == 1);
+    for (; g_now < 24'900; g_now += 100) {
+        scheduler.run();
+    }
+    CHECK(g_run_counts[0] == 1);
+    for (; g_now < 25'200; g_now += 100) {
+        scheduler.run();
+    }
+    CHECK(g_run_counts[0] == 2);
+}
+
+TEST_CASE("A disabled task is never due") {
+    g_now = 0;
+    g_run_counts = {};
+    TaskScheduler<1> scheduler{getNow};
+    size_t id = 0;
+    size_t index = 0;
+    REQUIRE(scheduler.addTask(1000, 0, countRun, &index, id));
+    scheduler.setEnabled(id, false);
+    g_now = 5000;
+    CHECK_FALSE(scheduler.run());
+
+    // Enabling makes it due right away
+    g_now = 5001;
+    scheduler.setEnabled(id, true);
+    CHECK(scheduler.run());
+    CHECK_FALSE(scheduler.run());
+    CHECK(g_run_counts[0] == 1);
+}
+
+TEST_CASE("The busy time of a task is accounted") {
+    g_now = 0;
+    TaskScheduler<1> scheduler{getNow};
+    size_t id = 0;
+    REQUIRE(scheduler.addTask(
+        1000, 0, [](uint32_t, void*) -> void { g_now += 250; }, nullptr, id));
+    scheduler.run();
+    g_now = 2000;
+    scheduler.run();
+    auto statistics = scheduler.getStatistics(id);
+    CHECK(statistics.run_count == 2);
+    CHECK(statistics.busy_time == 500);
+    CHECK(statistics.max_busy_time == 250);
+}
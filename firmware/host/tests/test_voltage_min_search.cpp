@@ -0,0 +1,67 @@
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <memory>
+
+#include "board_fixture.hpp"
+#include "voltage_min_search.hpp"
+
+using Type = RemoteCommand::Type;
+
+// A PPS whose lowest voltage is only known to be between 3.3 V and 5 V
+static constexpr std::array<uint16_t, 2> k_range_pdos = {
+    50 | BoardFixture::k_fixed_3a,
+    110 | (15 << 10) | (2 << 8) | (1 << 14) | (1 << 15)};
+static constexpr uint8_t k_range_item = 1;
+
+static auto search(uint16_t voltage_min) -> VoltageMinSearch {
+    VoltageMinSearch search{3400, 5000, 100};
+    while (!search.isDone()) {
+        search.addResult(search.getProbeVoltage() >= voltage_min);
+    }
+    return search;
+}
+
+TEST_CASE("The search finds the lowest accepted voltage") {
+    CHECK(search(3400).getVoltageMin() == 3400);
+    CHECK(search(4300).getVoltageMin() == 4300);
+    CHECK(search(5000).getVoltageMin() == 5000);
+    // 16 candidates below the known upper end
+    CHECK(search(4300).getProbeCount() <= 5);
+}
+
+TEST_CASE("A search without candidates is done right away") {
+    VoltageMinSearch search{5000, 5000, 100};
+    CHECK(search.isDone());
+    CHECK(search.getVoltageMin() == 5000);
+}
+
+TEST_CASE("The lowest voltage is probed once per source") {
+    auto board = std::make_unique<BoardFixture>();
+    board->attachSource(k_range_pdos, 0);
+    board->pdsink.setVoltageMin(k_range_item, 4300);
+    board->run(BoardFixture::k_menu_time);
+    auto pdos = board->remote(Type::GetPdos);
+    CHECK(pdos.find("PPS 4.3") != std::string::npos);
+
+    auto restarted = std::make_unique<BoardFixture>(board->getFlash());
+    restarted->attachSource(k_range_pdos, 0);
+    restarted->pdsink.setVoltageMin(k_range_item, 3800);
+    restarted->run(BoardFixture::k_menu_time);
+    CHECK(restarted->remote(Type::GetPdos) == pdos);
+}
+
+TEST_CASE("A search cut short by a reset is not repeated") {
+    auto board = std::make_unique<BoardFixture>();
+    board->attachSource(k_range_pdos, 0);
+    board->pdsink.setVoltageMin(k_range_item, 4300);
+    // The first probe is out, the board resets before the answer
+    board->run(1);
+
+    auto restarted = std::make_unique<BoardFixture>(board->getFlash());
+    restarted->attachSource(k_range_pdos, 0);
+    restarted->pdsink.setVoltageMin(k_range_item, 4300);
+    restarted->run(BoardFixture::k_menu_time);
+    auto pdos = restarted->remote(Type::GetPdos);
+    CHECK(pdos.find("PPS 5.0") != std::string::npos);
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+#include "board_fixture.hpp"
+#include "voltage_trim.hpp"
+
+using Type = RemoteCommand::Type;
+
+static constexpr uint32_t k_interval = 100'000;   // us, the default one
+
+// One sample as reference, then a whole update interval of the same voltage
+static auto feed(VoltageTrim& trim, uint32_t& timestamp, int32_t voltage)
+    -> bool {
+    bool is_changed = false;
+    for (uint32_t i = 0; i <= 10; ++i) {
+        is_changed |= trim.addSample(timestamp, voltage);
+        timestamp += k_interval / 10;
+    }
+    return is_changed;
+}
+
+static auto makeTrim() -> VoltageTrim {
+    VoltageTrim trim;
+    trim.setLimits(11000, 20);
+    trim.setTarget(5000);
+    trim.start();
+    return trim;
+}
+
+TEST_CASE("The trim raises the request by the voltage lost") {
+    auto trim = makeTrim();
+    uint32_t timestamp = 0;
+    CHECK(feed(trim, timestamp, 4880));
+    CHECK(trim.getCorrection() == 120);
+    CHECK(trim.getRequestVoltage() == 5120);
+}
+
+TEST_CASE("Errors within the hysteresis are left alone") {
+    auto trim = makeTrim();
+    uint32_t timestamp = 0;
+    CHECK_FALSE(feed(trim, timestamp, 4980));
+    CHECK(trim.getRequestVoltage() == 5000);
+}
+
+TEST_CASE("The correction stays below the highest source voltage") {
+    auto trim = makeTrim();
+    trim.setTarget(10800);
+    uint32_t timestamp = 0;
+    for (int i = 0; i < 5; ++i) {
+        feed(trim, timestamp, 10000);
+    }
+    CHECK(trim.getRequestVoltage() == 11000);
+}
+
+TEST_CASE("A stopped trim requests the setpoint") {
+    auto trim = makeTrim();
+    uint32_t timestamp = 0;
+    feed(trim, timestamp, 4800);
+    trim.stop();
+    CHECK(trim.getRequestVoltage() == 5000);
+    CHECK_FALSE(feed(trim, timestamp, 4800));
+}
+
+TEST_CASE("The voltage trim setting survives a restart") {
+    auto board = std::make_unique<BoardFixture>();
+    CHECK(board->remote(Type::GetVoltageTrim) == "0");
+    board->remote(Type::SetVoltageTrim, {1});
+    CHECK(board->remote(Type::GetVoltageTrim) == "1");
+
+    auto restarted = std::make_unique<BoardFixture>(board->getFlash());
+    CHECK(restarted->remote(Type::GetVoltageTrim) == "1");
+    restarted->remote(Type::SetVoltageTrim, {0});
+    restarted = std::make_unique<BoardFixture>(restarted->getFlash());
+    CHECK(restarted->remote(Type::GetVoltageTrim) == "0");
+}
@@ -2,7 +2,9 @@
 
 #include <cstdint>
 #include <cstring>
-#include <pico/time.h>
+#include <utility>
+
+#include "crc32.hpp"
 
 /// @brief AP33772 register commands
 static constexpr uint8_t k_cmd_srcpdo = 0x00;
@@ -44,7 +46,9 @@ auto Ap33772::probe() -> bool {
 }
 
 auto Ap33772::getStatus() -> IPdSink::Status {
-    m_status = getStatusReg();
+    m_status.raw = getStatusReg().raw | m_unreported_status.raw;
+    m_unreported_status.raw = 0;
+    updateRequestResult(m_status);
     IPdSink::Status status;
     if (m_status.bits.ready) {
         status.is_ready = true;
@@ -87,12 +91,16 @@ auto Ap33772::getPDSourcePowerCapabilities() -> uint8_t {
     uint8_t cnt = 0;
 
     if (!readRegister(k_cmd_pdonum, cnt)) {
+        m_source_fingerprint = 0;
         return 0;
     }
 
     m_i2c.writeTo(k_i2c_addr, std::span<const uint8_t>(&k_cmd_srcpdo, 1));
-    std::array<uint8_t, k_max_pdo_entries * sizeof(SrcPdoReg)> buffer;
-    m_i2c.readFrom(k_i2c_addr, buffer);
+    std::array<uint8_t, k_max_pdo_entries * sizeof(SrcPdoReg)> buffer{};
+    m_source_fingerprint =
+        std::cmp_equal(m_i2c.readFrom(k_i2c_addr, buffer), buffer.size())
+            ? crc32(buffer)
+            : 0;
     m_pdo_array = *reinterpret_cast<std::array<SrcPdoReg, k_max_pdo_entries>*>(
         buffer.data());
 
@@ -130,8 +138,10 @@ auto Ap33772::getPdo(uint8_t index, Pdo& pdo) -> bool {
     return true;
 }
 
-auto Ap33772::setPdoOutput(uint8_t index, uint16_t voltage, uint16_t current)
+auto Ap33772::requestPdo(uint8_t index, uint16_t voltage, uint16_t current)
     -> bool {
+    m_is_request_pending = false;
+    m_request_result = RequestResult::Rejected;
     // Handle invalid indices
     if ((index >= k_max_pdo_entries) || (voltage < k_voltage_min) ||
         (current < k_current_min)) {
@@ -161,9 +171,28 @@ auto Ap33772::setPdoOutput(uint8_t index, uint16_t voltage, uint16_t current)
         rdo.fixed.current_op = current / k_rdo_fixed_current_inc;
         rdo.fixed.obj_position = index + 1;
     }
-    writeRegister(k_cmd_rdo, rdo.raw);
+    // Drop a SUCCESS left over from the previous negotiation, the other flags
+    // are still reported by the next getStatus()
+    m_unreported_status.raw |= getStatusReg().raw;
+    m_unreported_status.bits.ready = 0;
+    m_unreported_status.bits.success = 0;
+    if (!writeRegister(k_cmd_rdo, rdo.raw)) {
+        return false;
+    }
+    m_is_request_pending = true;
+    m_request_result = RequestResult::Pending;
+    return true;
+}
 
-    return false;
+auto Ap33772::getRequestResult() -> RequestResult {
+    if (m_is_request_pending) {
+        // Reading clears the STATUS register, keep the other flags for the
+        // next getStatus()
+        auto status = getStatusReg();
+        m_unreported_status.raw |= status.raw;
+        updateRequestResult(status);
+    }
+    return m_request_result;
 }
 
 auto Ap33772::getStatusReg() -> Ap33772::StatusReg {
@@ -189,6 +218,22 @@ auto Ap33772::setOtpThreshold(uint8_t threshold) -> bool {
     return writeRegister(k_cmd_otpthr, threshold);
 }
 
+auto Ap33772::updateRequestResult(StatusReg status) -> void {
+    // READY is not used, it is also set by negotiations the sink starts on
+    // its own and does not tell which one finished. SUCCESS accepts the
+    // request, a protection fault rejects it.
+    if (!m_is_request_pending) {
+        return;
+    }
+    if (status.bits.success != 0) {
+        m_is_request_pending = false;
+        m_request_result = RequestResult::Accepted;
+    } else if ((status.raw & k_fault_mask) != 0) {
+        m_is_request_pending = false;
+        m_request_result = RequestResult::Rejected;
+    }
+}
+
 auto Ap33772::readRegister(uint8_t reg, uint8_t& value) -> bool {
     if (m_i2c.writeTo(k_i2c_addr, std::span<const uint8_t>(&reg, 1)) != 1) {
         return false;
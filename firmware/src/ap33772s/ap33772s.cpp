@@ -4,6 +4,8 @@
 #include <cstring>
 #include <utility>
 
+#include "crc32.hpp"
+
 /// @brief AP33772s register commands
 static constexpr uint8_t k_cmd_status = 0x01;
 static constexpr uint8_t k_cmd_mask = 0x02;
@@ -51,6 +53,11 @@ static constexpr uint8_t k_voutctl_on = 2;     // VOUT force ON
 
 static constexpr uint8_t k_fault_mask = 0x78;   // OVP, OCP, OTP & UVP
 
+/// @brief PD_MSGRLT RESPONSE values
+static constexpr uint8_t k_response_busy = 0;
+static constexpr uint8_t k_response_success = 1;
+static constexpr uint8_t k_response_fail = 4;   // no answer from the source
+
 static constexpr uint16_t k_current_min = 1000;   // mA
 static constexpr uint16_t k_voltage_min = 3300;   // mV
 
@@ -107,8 +114,11 @@ auto Ap33772s::getPDSourcePowerCapabilities() -> uint8_t {
     uint8_t cnt = 0;
 
     m_i2c.writeTo(k_i2c_addr, std::span<const uint8_t>(&k_cmd_srcpdo, 1));
-    std::array<uint8_t, k_max_pdo_entries * sizeof(SrcPdoReg)> buf;
-    m_i2c.readFrom(k_i2c_addr, buf);
+    std::array<uint8_t, k_max_pdo_entries * sizeof(SrcPdoReg)> buf{};
+    m_source_fingerprint =
+        std::cmp_equal(m_i2c.readFrom(k_i2c_addr, buf), buf.size())
+            ? crc32(buf)
+            : 0;
     m_pdo_array = *reinterpret_cast<std::array<SrcPdoReg, k_max_pdo_entries>*>(
         buf.data());
 
@@ -149,11 +159,11 @@ auto Ap33772s::getPdo(uint8_t index, Pdo& pdo) -> bool {
             // In this case:
             //               3.3V < VOLTAGE_MIN ≤ 5V for PPS
             //               15V < VOLTAGE_MIN ≤ 20V for AVS
-            // To find the exact VOLTAGE_MIN it is needed to iterate through the
-            // voltage range and find the first voltage that is accepted by the
-            // source
-
-            // TODO implement this
+            // Report the upper end, the exact VOLTAGE_MIN is found by probing
+            // the range with requests, see VoltageMinSearch
+            pdo.voltage_min = is_epr ? 20000 : 5000;
+            pdo.voltage_min_floor =
+                (is_epr ? 15000 : k_voltage_min) + pdo.voltage_step;
         }
         pdo.voltage_max =
             m_pdo_array[index].pps.voltage_max * (is_epr ? 200 : 100);
@@ -161,8 +171,10 @@ auto Ap33772s::getPdo(uint8_t index, Pdo& pdo) -> bool {
     return true;
 }
 
-auto Ap33772s::setPdoOutput(uint8_t index, uint16_t voltage, uint16_t current)
+auto Ap33772s::requestPdo(uint8_t index, uint16_t voltage, uint16_t current)
     -> bool {
+    m_is_request_pending = false;
+    m_request_result = RequestResult::Rejected;
     if ((index >= k_max_pdo_entries) || (voltage < k_voltage_min) ||
         (current < k_current_min)) {
         return false;
@@ -176,14 +188,36 @@ auto Ap33772s::setPdoOutput(uint8_t index, uint16_t voltage, uint16_t current)
     if (!writeRegister(k_cmd_pd_reqmsg, req.raw)) {
         return false;
     }
+    m_is_request_pending = true;
+    m_request_result = RequestResult::Pending;
+    return true;
+}
+
+auto Ap33772s::getRequestResult() -> RequestResult {
+    if (!m_is_request_pending) {
+        return m_request_result;
+    }
+    // A failed read is retried on the next poll, the caller's timeout covers
+    // a sink that stopped responding
     PdMsgrltReg res;
-    if (!readRegister(k_cmd_pd_msgrlt, res.raw)) {
-        return false;
+    if (!readRegister(k_cmd_pd_msgrlt, res.raw) ||
+        res.bits.response == k_response_busy) {
+        return RequestResult::Pending;
     }
-    if (res.bits.response == 1) {
-        return true;
+    switch (res.bits.response) {
+    case k_response_success:
+        m_request_result = RequestResult::Accepted;
+        break;
+    case k_response_fail:
+        m_request_result = RequestResult::Timeout;
+        break;
+    default:
+        // Invalid or not supported request
+        m_request_result = RequestResult::Rejected;
+        break;
     }
-    return false;
+    m_is_request_pending = false;
+    return m_request_result;
 }
 
 auto Ap33772s::getStatusReg() -> Ap33772s::StatusReg {
@@ -105,7 +105,8 @@ class Ap33772s : public IPdSink {
      */
     union PdMsgrltReg {
         struct {
-            uint8_t response : 2;
+            uint8_t response : 4;
+            uint8_t : 4;
         } bits;
         uint8_t raw;
     };
@@ -206,6 +207,15 @@ class Ap33772s : public IPdSink {
      */
     auto getPDSourcePowerCapabilities() -> uint8_t override;
 
+    /**
+     * @brief Get a fingerprint of the source power capabilities
+     *
+     * @return CRC-32 of the SRCPDO block, 0 if it could not be read
+     */
+    auto getSourceFingerprint() const -> uint32_t override {
+        return m_source_fingerprint;
+    }
+
     /**
      * @brief Retrieves the Power Data Object (PDO) at the specified index.
      *
@@ -222,25 +232,29 @@ class Ap33772s : public IPdSink {
     auto getPdo(uint8_t index, Pdo& pdo) -> bool override;
 
     /**
-     * @brief Selects a Power Data Object (PDO) and sets the output voltage and
-     * current.
-     *
-     * This function configures the power supply to use the specified PDO index
-     * and applies the requested voltage and current.
+     * @brief Starts the request of a Power Data Object (PDO) with the given
+     * output voltage and current.
      *
      * @param index   The PDO index to select (starting from 0).
      * @param voltage Desired output voltage in millivolts (mV).
      * @param current Desired output current in milliamps (mA).
      *
-     * @return true  If the PDO was successfully applied.
-     * @return false If the PDO selection or voltage/current setting failed.
-     *
-     * @note Ensure that the requested voltage and current are within the limits
-     *       of the selected PDO to prevent unexpected behavior.
+     * @return true  If the request was sent to the source.
+     * @return false If the arguments are invalid or the sink did not respond.
      */
-    auto setPdoOutput(uint8_t index, uint16_t voltage, uint16_t current)
+    auto requestPdo(uint8_t index, uint16_t voltage, uint16_t current)
         -> bool override;
 
+    /**
+     * @brief Get the progress of the last request without blocking.
+     *
+     * The result is read from PD_MSGRLT, which the AP33772S updates once the
+     * source answered the request.
+     *
+     * @return Pending until the negotiation is finished, then the outcome
+     */
+    auto getRequestResult() -> RequestResult override;
+
     /**
      * @brief Set Mask, used for setting up interrupt events
      *
@@ -304,7 +318,10 @@ class Ap33772s : public IPdSink {
 
     const I2c& m_i2c;
     std::array<SrcPdoReg, k_max_pdo_entries> m_pdo_array{};
+    uint32_t m_source_fingerprint{0};
     StatusReg m_status{};
+    RequestResult m_request_result{RequestResult::Rejected};
+    bool m_is_request_pending{false};
 };
 
 #endif   // ap33772s_hpp
@@ -1,10 +1,14 @@
 #ifndef event_hpp
 #define event_hpp
 
+#include <cstdint>
 #include <variant>
 
+#include "output_sequencer.hpp"
+#include "pd_request_queue.hpp"
 #include "pdsink_iface.hpp"
 #include "rotary_encoder.hpp"
+#include "scpi_interpreter.hpp"
 
 /**
  * @brief Event type for rotary encoder state changes.
@@ -17,9 +21,20 @@ struct RotaryEncoderEvent {
  * @brief Event type for INA226 update events.
  */
 struct SensorUpdateEvent {
-    float voltage{0.0F};
-    float current{0.0F};
-    uint8_t temperature{0};
+    int32_t voltage{0};         // mV
+    int32_t current{0};         // mA
+    int32_t power{0};           // mW
+    uint32_t timestamp{0};      // us
+    int32_t current_micro{0};   // uA, unrounded for the charge integral
+    int32_t power_micro{0};     // uW, unrounded for the energy integral
+};
+
+/**
+ * @brief Event type for PD sink temperature updates.
+ */
+struct TemperatureUpdateEvent {
+    uint8_t temperature{0};   // C
+    uint32_t timestamp{0};    // us
 };
 
 /**
@@ -36,6 +51,14 @@ struct PdSinkStatusUpdateEvent {
     IPdSink::Status status;
 };
 
+/**
+ * @brief Event type for the outcome of a request sent to the PD sink.
+ */
+struct PdRequestStatusEvent {
+    PdRequestQueue::Request request{};
+    IPdSink::RequestResult result{IPdSink::RequestResult::Rejected};
+};
+
 /**
  * @brief Event type for VOUT status update events.
  */
@@ -43,11 +66,88 @@ struct VoutStatusUpdateEvent {
     bool enabled{false};
 };
 
+/**
+ * @brief Event type for over-current limit changes.
+ */
+struct OcpLimitUpdateEvent {
+    int32_t current{0};   // mA, 0 disables the limit
+};
+
+/**
+ * @brief Event type for switching the cable-drop compensation.
+ */
+struct VoltageTrimEvent {
+    bool enable{false};   // trim the PPS request until the output matches
+};
+
+/**
+ * @brief Event type for over-current trips signaled by the sensor ALERT pin.
+ */
+struct OverCurrentEvent {};
+
+/**
+ * @brief Event type for the two-point measurement calibration.
+ *
+ * Each capture pairs the current sensor reading with the value shown by a
+ * reference meter, two captures per quantity at distant operating points.
+ */
+struct CalibrationEvent {
+    enum class Action : uint8_t {
+        Start,            // readings become uncorrected, captures are cleared
+        CaptureVoltage,   // reference in uV
+        CaptureCurrent,   // reference in uA
+        Save,             // compute, apply and store the correction
+        Cancel,           // restore the stored correction
+        Reset             // apply and store the uncorrected readings
+    };
+    Action action{Action::Start};
+    int32_t reference{0};
+};
+
+/**
+ * @brief Event type for the output sequencer, which plays a list of steps.
+ *
+ * The list is kept across states, it is only played in the main state of a
+ * PPS profile.
+ */
+struct SequencerEvent {
+    enum class Action : uint8_t {
+        Clear,          // remove all steps, stops the list
+        AddStep,        // append step
+        SetLoopCount,   // loop_count passes, 0 loops until stopped
+        Start,          // play from the first step, the output stays as is
+        Stop            // stop, the output keeps the current setpoint
+    };
+    Action action{Action::Clear};
+    OutputSequencer::Step step{};
+    uint16_t loop_count{0};
+};
+
+/**
+ * @brief Event type for the deadline task advancing the output sequencer.
+ */
+struct SequencerTickEvent {
+    uint32_t timestamp{0};   // us
+};
+
+/**
+ * @brief Event type for a command of the remote control interface.
+ *
+ * A query appends its answer to the reply, a failed command sets its error.
+ */
+struct RemoteCommandEvent {
+    RemoteCommand command{};
+    RemoteReply* reply{nullptr};
+};
+
 /**
  * @brief System event variant that holds one of the supported event types.
  */
 using SystemEvent =
-    std::variant<RotaryEncoderEvent, SensorUpdateEvent, SystemTickEvent,
-                 PdSinkStatusUpdateEvent, VoutStatusUpdateEvent>;
+    std::variant<RotaryEncoderEvent, SensorUpdateEvent, TemperatureUpdateEvent,
+                 SystemTickEvent, PdSinkStatusUpdateEvent, PdRequestStatusEvent,
+                 VoutStatusUpdateEvent, OcpLimitUpdateEvent, VoltageTrimEvent,
+                 OverCurrentEvent, CalibrationEvent, SequencerEvent,
+                 SequencerTickEvent, RemoteCommandEvent>;
 
 #endif   // event_hpp
@@ -0,0 +1,164 @@
+#include "chart_screen.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "tiny_format.hpp"
+
+// Every plot is divided into this many steps of the scale
+static constexpr int32_t k_scale_divisions = 4;
+static constexpr std::array<int32_t, 12> k_scale_steps = {
+    10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+// Measured values are in mV/mA and shown in V/A, like "05.07"
+static constexpr NumberFormat k_measurement_format{
+    .width = 5, .decimals = 2, .zero_pad = true, .scale = 3};
+
+static auto floorToStep(int32_t value, int32_t step) -> int32_t {
+    int32_t result = (value / step) * step;
+    return (result > value) ? result - step : result;
+}
+
+static auto ceilToStep(int32_t value, int32_t step) -> int32_t {
+    int32_t result = (value / step) * step;
+    return (result < value) ? result + step : result;
+}
+
+ChartScreen::ChartScreen(uint16_t decimation)
+    : m_voltage(decimation), m_current(decimation) {}
+
+auto ChartScreen::addSample(int32_t voltage, int32_t current) -> ChartScreen& {
+    m_latest_voltage = voltage;
+    m_latest_current = current;
+    // Both series are pushed together, so they complete buckets together
+    m_current.push(current);
+    if (m_voltage.push(voltage)) {
+        m_new_columns = std::min<uint16_t>(m_new_columns + 1, k_chart_width);
+        invalidate();
+    }
+    return *this;
+}
+
+auto ChartScreen::setSamplePeriod(uint32_t period) -> ChartScreen& {
+    auto decimation = static_cast<uint16_t>(
+        std::clamp<uint32_t>(k_column_period / std::max<uint32_t>(period, 1),
+                             1, UINT16_MAX));
+    if (decimation != m_voltage.getDecimation()) {
+        m_voltage.setDecimation(decimation);
+        m_current.setDecimation(decimation);
+        m_new_columns = 0;
+        m_is_redraw_pending = true;
+        invalidate();
+    }
+    return *this;
+}
+
+auto ChartScreen::setProfileName(std::string_view name) -> ChartScreen& {
+    updateField(m_profile_name, name);
+    return *this;
+}
+
+auto ChartScreen::build() -> FrameBuffer& {
+    auto voltage_range = scaleRange(m_voltage.getMin(), m_voltage.getMax());
+    auto current_range = scaleRange(m_current.getMin(), m_current.getMax());
+    bool is_redraw_needed = m_is_redraw_pending ||
+                            m_drawn_epoch != m_frame_buffer_epoch ||
+                            voltage_range != m_voltage_range ||
+                            current_range != m_current_range ||
+                            m_new_columns >= std::min(m_width, k_chart_width);
+    m_voltage_range = voltage_range;
+    m_current_range = current_range;
+
+    if (is_redraw_needed) {
+        clear();
+        auto count = std::min<size_t>(m_voltage.size(), m_width);
+        for (size_t i = 0; i < count; ++i) {
+            drawColumn(static_cast<int16_t>(m_width - count + i),
+                       m_voltage.size() - count + i);
+        }
+    } else {
+        // Scroll the plot by one column per new bucket, oldest first
+        for (; m_new_columns > 0; --m_new_columns) {
+            shiftPlot();
+            drawColumn(static_cast<int16_t>(m_width - 1),
+                       m_voltage.size() - m_new_columns);
+        }
+    }
+    m_new_columns = 0;
+    m_is_redraw_pending = false;
+    drawHeader();
+    m_drawn_epoch = m_frame_buffer_epoch;
+    return m_frame_buffer;
+}
+
+auto ChartScreen::scaleRange(int32_t min, int32_t max) -> Range {
+    int32_t step = k_scale_steps.back();
+    for (const auto& candidate : k_scale_steps) {
+        if (candidate * k_scale_divisions >= max - min) {
+            step = candidate;
+            break;
+        }
+    }
+    Range range{.low = floorToStep(min, step), .high = ceilToStep(max, step)};
+    if (range.high == range.low) {
+        range.high += step;
+    }
+    return range;
+}
+
+auto ChartScreen::drawHeader() -> void {
+    std::fill_n(m_frame_buffer.begin(), m_width, 0);
+    // Fits any int32_t value in the measurement format and the unit
+    std::array<char, 16> buffer;
+    printString(0, 0,
+                TinyFormat{buffer}
+                    .append(m_latest_voltage, k_measurement_format)
+                    .append("V")
+                    .str());
+    printString(m_width / 2, 0, m_profile_name, {.align = TextAlign::center});
+    // The circuit is physically wired for positive current only
+    printString(m_width, 0,
+                TinyFormat{buffer}
+                    .append(std::abs(m_latest_current), k_measurement_format)
+                    .append("A")
+                    .str(),
+                {.align = TextAlign::right});
+}
+
+auto ChartScreen::shiftPlot() -> void {
+    // The plots start on the second page, the header page is not scrolled
+    for (auto page = 1; page < m_height / m_page_height; ++page) {
+        auto row = m_frame_buffer.subspan(page * m_width, m_width);
+        std::shift_left(row.begin(), row.end(), 1);
+        row.back() = 0;
+    }
+}
+
+auto ChartScreen::drawColumn(int16_t x_pos, size_t index) -> void {
+    auto plot_height = static_cast<int16_t>((m_height - m_page_height) / 2);
+    auto voltage_top = static_cast<int16_t>(m_page_height);
+    auto current_top = static_cast<int16_t>(voltage_top + plot_height);
+    drawSeries(x_pos, index, m_voltage, m_voltage_range, voltage_top);
+    drawSeries(x_pos, index, m_current, m_current_range, current_top);
+}
+
+auto ChartScreen::drawSeries(int16_t x_pos, size_t index, const Series& series,
+                             const Range& range, int16_t top) -> void {
+    auto plot_height = static_cast<int16_t>((m_height - m_page_height) / 2);
+    auto to_y = [&](int32_t value) -> int16_t {
+        value = std::clamp(value, range.low, range.high);
+        return static_cast<int16_t>(top + plot_height - 1 -
+                                    ((value - range.low) * (plot_height - 1) /
+                                     (range.high - range.low)));
+    };
+    const auto& bucket = series[index];
+    const auto& previous = (index > 0) ? series[index - 1] : bucket;
+    // Extend the bucket range towards the previous one to get a connected
+    // trace
+    int32_t low = std::min(bucket.min, previous.max);
+    int32_t high = std::max(bucket.max, previous.min);
+    auto y_top = to_y(high);
+    auto y_bottom = to_y(low);
+    drawRectangle(x_pos, y_top, 1, y_bottom - y_top + 1, true);
+}
@@ -0,0 +1,121 @@
+#ifndef chart_screen_hpp
+#define chart_screen_hpp
+
+#include "decimating_ring_buffer.hpp"
+#include "screen.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+class ChartScreen : public Screen {
+  public:
+    /**
+     * @brief Number of plotted columns, one column per bucket
+     */
+    static constexpr uint16_t k_chart_width = 128;
+
+    /**
+     * @brief Default number of samples merged into one column
+     */
+    static constexpr uint16_t k_default_decimation = 5;
+
+    /**
+     * @brief Time covered by one column when the sample period is set
+     */
+    static constexpr uint32_t k_column_period = 100;   // ms
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] decimation Number of samples merged into one column
+     */
+    explicit ChartScreen(uint16_t decimation = k_default_decimation);
+
+    /**
+     * @brief Destructor
+     */
+    ~ChartScreen() override = default;
+
+    /**
+     * @brief Build the chart screen
+     *
+     * If the frame buffer still holds the chart drawn by the previous call and
+     * the scale did not change, the plot is shifted and only the new columns
+     * are drawn. Otherwise the whole chart is redrawn.
+     *
+     * @return A reference to shared FrameBuffer matching the display
+     * dimensions.
+     */
+    auto build() -> FrameBuffer& override;
+
+    /**
+     * @brief Add a measurement
+     *
+     * @param[in] voltage Voltage in mV
+     * @param[in] current Current in mA
+     * @return reference to this chart screen object
+     */
+    auto addSample(int32_t voltage, int32_t current) -> ChartScreen&;
+
+    /**
+     * @brief Set the period the samples are added with
+     *
+     * The number of samples merged into one column is chosen so a column
+     * covers k_column_period. A new period clears the chart.
+     *
+     * @param[in] period Sample period in ms
+     * @return reference to this chart screen object
+     */
+    auto setSamplePeriod(uint32_t period) -> ChartScreen&;
+
+    /**
+     * @brief Set the acquisition profile name shown in the header
+     *
+     * @param[in] name Short profile name, the view must outlive the screen
+     * @return reference to this chart screen object
+     */
+    auto setProfileName(std::string_view name) -> ChartScreen&;
+
+  private:
+    using Series = DecimatingRingBuffer<k_chart_width>;
+
+    /**
+     * @brief Value range mapped to the height of a plot
+     */
+    struct Range {
+        int32_t low{0};
+        int32_t high{0};
+        auto operator==(const Range&) const -> bool = default;
+    };
+
+    /**
+     * @brief Round the window extremes outwards to a coarse step
+     *
+     * Small changes of the extremes keep the same range, so the plot can be
+     * scrolled instead of redrawn.
+     *
+     * @param[in] min Smallest value in the window
+     * @param[in] max Largest value in the window
+     * @return Range used for scaling
+     */
+    static auto scaleRange(int32_t min, int32_t max) -> Range;
+
+    auto drawHeader() -> void;
+    auto shiftPlot() -> void;
+    auto drawColumn(int16_t x_pos, size_t index) -> void;
+    auto drawSeries(int16_t x_pos, size_t index, const Series& series,
+                    const Range& range, int16_t top) -> void;
+
+    Series m_voltage;
+    Series m_current;
+    int32_t m_latest_voltage{0};
+    int32_t m_latest_current{0};
+    std::string_view m_profile_name;
+    Range m_voltage_range;
+    Range m_current_range;
+    uint16_t m_new_columns{0};
+    uint32_t m_drawn_epoch{0};
+    bool m_is_redraw_pending{false};
+};
+
+#endif   // chart_screen_hpp
@@ -56,8 +56,12 @@ auto LoadingScreen::build() -> FrameBuffer& {
         if (res.ec == std::errc{}) {
             std::memcpy(res.ptr, k_pdos_found_str.data(),
                         k_pdos_found_str.size());
-            printString(m_width / 2, 48, profiles_found_str.data(),
-                        {.align = TextAlign::center});
+            // the array is not null terminated, so pass the exact length
+            std::string_view text{profiles_found_str.data(),
+                                  static_cast<std::size_t>(
+                                      res.ptr - profiles_found_str.data()) +
+                                      k_pdos_found_str.size()};
+            printString(m_width / 2, 48, text, {.align = TextAlign::center});
         }
     } else {
         std::string_view dots_str = k_all_dots_str.substr(0, m_progress);
@@ -73,10 +77,11 @@ auto LoadingScreen::build() -> FrameBuffer& {
 auto LoadingScreen::updateProgress() -> LoadingScreen& {
     // Increment progress and wrap around to 0 after reaching k_max_dots
     m_progress = (m_progress + 1) % (k_max_dots + 1);
+    invalidate();
     return *this;
 }
 
 auto LoadingScreen::setPdoProfileCount(uint8_t count) -> LoadingScreen& {
-    m_pdo_profile_count = count;
+    updateField(m_pdo_profile_count, std::optional<uint8_t>{count});
     return *this;
 }
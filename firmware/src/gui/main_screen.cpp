@@ -1,5 +1,7 @@
 #include "main_screen.hpp"
 
+#include <array>
+#include <cstdlib>
 #include <string_view>
 
 #include "config.hpp"
@@ -8,6 +10,9 @@
 
 static constexpr std::string_view k_target = "TARGET ";
 static constexpr std::string_view k_limit = "LIMIT ";
+// Measured values are in mV/mA and shown in V/A, like "05.07"
+static constexpr NumberFormat k_measurement_format{
+    .width = 5, .decimals = 2, .zero_pad = true, .scale = 3};
 
 auto MainScreen::build() -> FrameBuffer& {
     clear();
@@ -18,12 +23,16 @@ auto MainScreen::build() -> FrameBuffer& {
     std::array<char, 24> buffer;
 
     // Temperature
-    printString(m_width, 0, tinyFormat(buffer, "%d*C", m_temperature),
+    printString(m_width, 0,
+                TinyFormat{buffer}.append(m_temperature).append("*C").str(),
                 {.align = TextAlign::right});
 
     // Measured voltage in V
     printString(m_width / 2, 0,
-                tinyFormat(buffer, "%05.2fV", m_measured_voltage),
+                TinyFormat{buffer}
+                    .append(m_measured_voltage, k_measurement_format)
+                    .append("V")
+                    .str(),
                 {.align = TextAlign::center, .size = FontSize::big});
 
     // Target/Limit voltage in mV
@@ -35,7 +44,10 @@ auto MainScreen::build() -> FrameBuffer& {
         2;
     auto len = printString(target_voltage_pos, 16, voltage_label);
     len += printString(target_voltage_pos + len, 16,
-                       tinyFormat(buffer, "%05d", m_target_voltage),
+                       TinyFormat{buffer}
+                           .append(static_cast<int32_t>(m_target_voltage),
+                                   {.width = 5, .zero_pad = true})
+                           .str(),
                        {.invert = m_is_target_voltage_selected});
     printString(target_voltage_pos + len, 16, "mV");
 
@@ -43,7 +55,10 @@ auto MainScreen::build() -> FrameBuffer& {
     // Using std::abs as a safety net against sensor noise.
     // The circuit is physically wired for positive current only.
     printString(m_width / 2, 25,
-                tinyFormat(buffer, "%05.2fA", std::abs(m_measured_current)),
+                TinyFormat{buffer}
+                    .append(std::abs(m_measured_current), k_measurement_format)
+                    .append("A")
+                    .str(),
                 {.align = TextAlign::center, .size = FontSize::big});
 
     // Target/Limit current in mA
@@ -55,7 +70,10 @@ auto MainScreen::build() -> FrameBuffer& {
         2;
     len = printString(target_current_pos, 41, current_label);
     len += printString(target_current_pos + len, 41,
-                       tinyFormat(buffer, "%04d", m_target_current),
+                       TinyFormat{buffer}
+                           .append(static_cast<int32_t>(m_target_current),
+                                   {.width = 4, .zero_pad = true})
+                           .str(),
                        {.invert = m_is_target_current_selected});
     printString(target_current_pos + len, 41, "mA");
 
@@ -77,51 +95,51 @@ auto MainScreen::build() -> FrameBuffer& {
 }
 
 auto MainScreen::setPdoType(IPdSink::PdoType type) -> MainScreen& {
-    m_pdo_type = type;
+    updateField(m_pdo_type, type);
     return *this;
 }
 
 auto MainScreen::setSupplyMode(SupplyMode mode) -> MainScreen& {
-    m_supply_mode = mode;
+    updateField(m_supply_mode, mode);
     return *this;
 }
 
 auto MainScreen::setOutputEnable(bool value) -> MainScreen& {
-    m_is_output_enabled = value;
+    updateField(m_is_output_enabled, value);
     return *this;
 }
 
 auto MainScreen::setTemperature(int value) -> MainScreen& {
-    m_temperature = value;
+    updateField(m_temperature, value);
     return *this;
 }
 
-auto MainScreen::setMeasuredVoltage(float value) -> MainScreen& {
-    m_measured_voltage = value;
+auto MainScreen::setMeasuredVoltage(int32_t value) -> MainScreen& {
+    updateField(m_measured_voltage, value);
     return *this;
 }
 
-auto MainScreen::setMeasuredCurrent(float value) -> MainScreen& {
-    m_measured_current = value;
+auto MainScreen::setMeasuredCurrent(int32_t value) -> MainScreen& {
+    updateField(m_measured_current, value);
     return *this;
 }
 
 auto MainScreen::setTargetVoltage(unsigned int value) -> MainScreen& {
-    m_target_voltage = value;
+    updateField(m_target_voltage, value);
     return *this;
 }
 
 auto MainScreen::selectTargetVoltage(bool value) -> MainScreen& {
-    m_is_target_voltage_selected = value;
+    updateField(m_is_target_voltage_selected, value);
     return *this;
 }
 
 auto MainScreen::setTargetCurrent(unsigned int value) -> MainScreen& {
-    m_target_current = value;
+    updateField(m_target_current, value);
     return *this;
 }
 
 auto MainScreen::selectTargetCurrent(bool value) -> MainScreen& {
-    m_is_target_current_selected = value;
+    updateField(m_is_target_current_selected, value);
     return *this;
 }
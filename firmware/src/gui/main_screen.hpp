@@ -60,18 +60,18 @@ class MainScreen : public Screen {
     /**
      * @brief Set measured voltage
      *
-     * @param[in] value Voltage in V
+     * @param[in] value Voltage in mV
      * @return reference to this main screen object
      */
-    auto setMeasuredVoltage(float value) -> MainScreen&;
+    auto setMeasuredVoltage(int32_t value) -> MainScreen&;
 
     /**
      * @brief Set measured current
      *
-     * @param[in] value Current in A
+     * @param[in] value Current in mA
      * @return reference to this main screen object
      */
-    auto setMeasuredCurrent(float value) -> MainScreen&;
+    auto setMeasuredCurrent(int32_t value) -> MainScreen&;
 
     /**
      * @brief Set target voltage
@@ -110,8 +110,8 @@ class MainScreen : public Screen {
     SupplyMode m_supply_mode{SupplyMode::CV};
     bool m_is_output_enabled{false};
     int m_temperature{0};
-    float m_measured_voltage{0.0F};
-    float m_measured_current{0.0F};
+    int32_t m_measured_voltage{0};   // mV
+    int32_t m_measured_current{0};   // mA
     unsigned int m_target_voltage{0};
     bool m_is_target_voltage_selected{false};
     unsigned int m_target_current{0};
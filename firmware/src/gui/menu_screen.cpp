@@ -1,15 +1,45 @@
 #include "menu_screen.hpp"
 
+#include <algorithm>
+
 #include "pdo_helper.hpp"
 #include "screen.hpp"
 #include "tiny_format.hpp"
 
+MenuScreen::RowCache MenuScreen::s_row_cache{};
+
 MenuScreen::MenuScreen(std::string_view title) : m_title(title) {}
 
+MenuScreen::MenuScreen(const MenuScreen& other)
+    : Screen(other), m_title(other.m_title), m_config(other.m_config),
+      m_selected_menu_item(other.m_selected_menu_item) {}
+
+auto MenuScreen::operator=(const MenuScreen& other) -> MenuScreen& {
+    if (this != &other) {
+        releaseRowCache();
+        Screen::operator=(other);
+        m_title = other.m_title;
+        m_config = other.m_config;
+        m_selected_menu_item = other.m_selected_menu_item;
+    }
+    return *this;
+}
+
+MenuScreen::~MenuScreen() { releaseRowCache(); }
+
+auto MenuScreen::releaseRowCache() const -> void {
+    if (s_row_cache.owner == this) {
+        s_row_cache.owner = nullptr;
+        s_row_cache.cached_rows = 0;
+    }
+}
+
 auto MenuScreen::getTitle() const -> std::string_view { return m_title; }
 
 auto MenuScreen::setConfig(std::span<const Config> config) -> MenuScreen& {
     m_config = config;
+    releaseRowCache();
+    invalidate();
     return *this;
 }
 
@@ -18,18 +48,20 @@ auto MenuScreen::getSelectedMenuItem() const -> uint8_t {
 }
 
 auto MenuScreen::selectMenuItem(uint8_t index) -> MenuScreen& {
-    m_selected_menu_item = index;
+    updateField(m_selected_menu_item, index);
     return *this;
 }
 
 auto MenuScreen::selectNextMenuItem() -> MenuScreen& {
     m_selected_menu_item = (m_selected_menu_item + 1) % m_config.size();
+    invalidate();
     return *this;
 }
 
 auto MenuScreen::selectPreviousMenuItem() -> MenuScreen& {
     m_selected_menu_item =
         (m_selected_menu_item - 1 + m_config.size()) % m_config.size();
+    invalidate();
     return *this;
 }
 
@@ -40,9 +72,12 @@ auto MenuScreen::build() -> FrameBuffer& {
     }
     uint16_t y_pos = 0;
     std::array<char, 8> buffer;
-    printString(
-        0, y_pos,
-        tinyFormat(buffer, "%d/%d", m_selected_menu_item + 1, m_config.size()));
+    printString(0, y_pos,
+                TinyFormat{buffer}
+                    .append(m_selected_menu_item + 1)
+                    .append("/")
+                    .append(static_cast<int32_t>(m_config.size()))
+                    .str());
     printString(m_width / 2, y_pos, m_title, {.align = TextAlign::center});
 
     y_pos += 2 * m_page_height;
@@ -54,16 +89,46 @@ auto MenuScreen::build() -> FrameBuffer& {
         if ((start_index + i) >= m_config.size()) {
             break;
         }
-        bool is_selected = false;
-        if (start_index + i == m_selected_menu_item) {
-            is_selected = true;
-            drawRectangle(0, y_pos, 1, m_page_height, false);
-        }
-        std::array<char, 24> buffer;
-        printString(1, y_pos,
-                    pdoToString(m_config[start_index + i].pdo, buffer),
-                    {.invert = is_selected});
+        drawRow(start_index + i, static_cast<int16_t>(y_pos),
+                start_index + i == m_selected_menu_item);
         y_pos += m_page_height;
     }
     return m_frame_buffer;
 }
+
+auto MenuScreen::drawRow(std::size_t index, int16_t y_pos, bool is_selected)
+    -> void {
+    auto row = m_frame_buffer.subspan((y_pos / m_page_height) * m_width,
+                                      m_width);
+    bool is_cacheable =
+        index < k_max_cached_rows && m_width <= k_max_row_width;
+    if (is_cacheable && s_row_cache.owner != this) {
+        s_row_cache.owner = this;
+        s_row_cache.cached_rows = 0;
+    }
+    uint16_t text_width = 0;
+    if (is_cacheable && (s_row_cache.cached_rows & (1U << index)) != 0) {
+        const auto& strip = s_row_cache.rows[index];
+        std::copy_n(strip.columns.begin(), m_width, row.begin());
+        text_width = strip.text_width;
+    } else {
+        std::array<char, 24> buffer;
+        text_width =
+            printString(1, y_pos, pdoToString(m_config[index].pdo, buffer));
+        if (is_cacheable) {
+            auto& strip = s_row_cache.rows[index];
+            std::ranges::copy(row, strip.columns.begin());
+            strip.text_width = text_width;
+            s_row_cache.cached_rows |= (1U << index);
+        }
+    }
+    if (is_selected) {
+        drawRectangle(0, y_pos, 1, m_page_height, false);
+        // Same result as printing the text inverted
+        auto text = row.subspan(1, std::min<std::size_t>(text_width,
+                                                         row.size() - 1));
+        std::ranges::transform(text, text.begin(), [](uint8_t column) {
+            return static_cast<uint8_t>(~column);
+        });
+    }
+}
@@ -4,6 +4,7 @@
 #include "config.hpp"
 #include "screen.hpp"
 
+#include <array>
 #include <span>
 #include <string_view>
 
@@ -17,9 +18,24 @@ class MenuScreen : public Screen {
     MenuScreen(std::string_view title);
 
     /**
-     * @brief Destructor
+     * @brief Copy constructor, the copy does not share the cached rows
+     *
+     * @param[in] other Menu screen to copy
      */
-    ~MenuScreen() override = default;
+    MenuScreen(const MenuScreen& other);
+
+    /**
+     * @brief Copy assignment, drops the rows cached for this screen
+     *
+     * @param[in] other Menu screen to copy
+     * @return reference to this menu screen object
+     */
+    auto operator=(const MenuScreen& other) -> MenuScreen&;
+
+    /**
+     * @brief Destructor, releases the row cache
+     */
+    ~MenuScreen() override;
 
     /**
      * @brief Get the menu title
@@ -78,6 +94,51 @@ class MenuScreen : public Screen {
     auto build() -> FrameBuffer& override;
 
   private:
+    static constexpr uint8_t k_max_cached_rows = 16;
+    static constexpr uint16_t k_max_row_width = 128;
+
+    /**
+     * @brief Pre-rendered menu item, one page high
+     */
+    struct RowStrip {
+        std::array<uint8_t, k_max_row_width> columns;
+        uint16_t text_width;
+    };
+
+    /**
+     * @brief Draw a menu item into a page of the frame buffer
+     *
+     * The item is rendered only the first time and copied from the row cache
+     * afterwards. The selected item is the cached strip with the text columns
+     * inverted.
+     *
+     * @param[in] index Index of the menu item
+     * @param[in] y_pos Y coordinate, aligned to a page
+     * @param[in] is_selected Flag indicating the selected item
+     */
+    auto drawRow(std::size_t index, int16_t y_pos, bool is_selected) -> void;
+
+    /**
+     * @brief Pre-rendered menu items, shared by all menu screens
+     *
+     * Only one menu is shown at a time, so the cache belongs to the screen
+     * that drew into it last and is not part of every menu screen.
+     */
+    struct RowCache {
+        std::array<RowStrip, k_max_cached_rows> rows;
+        // Menu screen the rows were rendered for
+        const MenuScreen* owner{nullptr};
+        // Bit mask of menu items present in the row cache
+        uint16_t cached_rows{0};
+    };
+
+    static RowCache s_row_cache;
+
+    /**
+     * @brief Drop the cached rows if they were rendered for this screen
+     */
+    auto releaseRowCache() const -> void;
+
     std::string_view m_title;
     std::span<const Config> m_config;
     uint8_t m_selected_menu_item{0};
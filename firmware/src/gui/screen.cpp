@@ -1,6 +1,7 @@
 #include "screen.hpp"
 
 #include <algorithm>
+#include <array>
 #include <utility>
 
 static constexpr uint8_t k_font_width = 5;
@@ -108,7 +109,77 @@ static constexpr std::array<uint8_t, 475> k_font = {
     0x08, 0x04,     0x08,     0x04,     k_unused,   // ~
 };
 
-Screen::Screen() { clear(); }
+static constexpr std::size_t k_glyph_count = k_font.size() / k_font_width;
+static constexpr uint8_t k_big_font_width = k_font_width * 2;
+
+// Glyph widths, derived from k_font at compile time so that measuring text
+// does not need to scan for k_unused columns
+static constexpr auto k_font_widths = [] {
+    std::array<uint8_t, k_glyph_count> widths{};
+    for (std::size_t glyph = 0; glyph < k_glyph_count; ++glyph) {
+        for (std::size_t i = 0; i < k_font_width; ++i) {
+            if (k_font[(glyph * k_font_width) + i] != k_unused) {
+                ++widths[glyph];
+            }
+        }
+    }
+    return widths;
+}();
+
+/**
+ * @brief Double the height of the lower or upper nibble of a font column
+ *
+ * @param[in] column Font column
+ * @param[in] shift 0 for the upper part of the glyph, 4 for the lower one
+ * @return Page sized column where every source pixel occupies two rows
+ */
+static constexpr auto stretchColumn(uint8_t column, uint8_t shift) -> uint8_t {
+    uint8_t result = 0;
+    for (uint8_t i = 0; i < k_font_height; i++) {
+        if (((1 << (shift + (i / 2))) & column) != 0) {
+            result |= (1 << i);
+        }
+    }
+    return result;
+}
+
+// Pre-scaled big font. Every glyph occupies two pages, each page holds
+// k_big_font_width columns, where every source column is repeated twice.
+static constexpr auto k_big_font = [] {
+    std::array<std::array<std::array<uint8_t, k_big_font_width>, 2>,
+               k_glyph_count>
+        atlas{};
+    for (std::size_t glyph = 0; glyph < k_glyph_count; ++glyph) {
+        for (std::size_t j = 0; j < k_big_font_width; ++j) {
+            uint8_t column = k_font[(glyph * k_font_width) + (j / 2)];
+            if (column == k_unused) {
+                continue;
+            }
+            atlas[glyph][0][j] = stretchColumn(column, 0);
+            atlas[glyph][1][j] = stretchColumn(column, 4);
+        }
+    }
+    return atlas;
+}();
+
+/**
+ * @brief Map a character to its index in the font tables
+ *
+ * @param[in] character Character
+ * @return Glyph index or k_glyph_count if the character is not in the font
+ */
+static constexpr auto glyphIndex(char character) -> std::size_t {
+    if (character < ' ' ||
+        std::cmp_greater_equal(character - ' ', k_glyph_count)) {
+        return k_glyph_count;
+    }
+    return static_cast<std::size_t>(character - ' ');
+}
+
+Screen::Screen() {
+    clear();
+    invalidate();
+}
 
 auto Screen::initialize(FrameBuffer frame_buffer, uint16_t width,
                         uint16_t height, uint16_t page_height) -> void {
@@ -118,7 +189,10 @@ auto Screen::initialize(FrameBuffer frame_buffer, uint16_t width,
     m_page_height = page_height;
 }
 
-auto Screen::clear() -> void { std::ranges::fill(m_frame_buffer, 0); }
+auto Screen::clear() -> void {
+    std::ranges::fill(m_frame_buffer, 0);
+    ++m_frame_buffer_epoch;
+}
 
 auto Screen::setPixel(int16_t x_pos, int16_t y_pos) -> void {
     if ((x_pos < 0) || (y_pos < 0) || std::cmp_greater_equal(x_pos, m_width) ||
@@ -180,19 +254,52 @@ auto Screen::draw(int16_t x_pos, int16_t y_pos, const uint8_t* object,
     }
 }
 
+auto Screen::blit(int16_t x_pos, int16_t y_pos, const uint8_t* columns,
+                  uint16_t width, bool invert) -> void {
+    if (y_pos <= -m_page_height || std::cmp_greater_equal(y_pos, m_height)) {
+        return;
+    }
+    // A page sized column at an arbitrary y position spans at most two pages.
+    // Floor division keeps negative positions on the correct page.
+    int16_t page = (y_pos >= 0)
+                       ? (y_pos / m_page_height)
+                       : -((m_page_height - 1 - y_pos) / m_page_height);
+    auto shift = static_cast<uint8_t>(y_pos - (page * m_page_height));
+    int16_t page_count = m_height / m_page_height;
+    auto upper_mask = static_cast<uint8_t>(0xff << shift);
+    auto lower_mask = static_cast<uint8_t>(~upper_mask);
+    for (uint16_t i = 0; i < width; i++) {
+        int16_t x = x_pos + i;
+        if (x < 0 || std::cmp_greater_equal(x, m_width)) {
+            continue;
+        }
+        uint8_t column = (columns != nullptr) ? columns[i] : 0x00;
+        if (invert) {
+            column = ~column;
+        }
+        if (page >= 0) {
+            auto& dest = m_frame_buffer[(m_width * page) + x];
+            dest = (dest & lower_mask) | static_cast<uint8_t>(column << shift);
+        }
+        if (shift != 0 && page + 1 < page_count) {
+            auto& dest = m_frame_buffer[(m_width * (page + 1)) + x];
+            dest = (dest & upper_mask) |
+                   static_cast<uint8_t>(column >> (m_page_height - shift));
+        }
+    }
+}
+
 auto Screen::printChar(int16_t x_pos, int16_t y_pos, char character,
                        bool invert, bool dry_run) -> uint16_t {
-    auto char_width = 0;
-    for (auto i = 0; std::cmp_less(i, k_font_width); i++) {
-        if (k_font[((character - ' ') * k_font_width) + i] != k_unused) {
-            ++char_width;
-        }
+    auto glyph = glyphIndex(character);
+    if (glyph >= k_glyph_count) {
+        return 0;
     }
+    uint8_t char_width = k_font_widths[glyph];
     if (!dry_run) {
-        draw(x_pos, y_pos, &k_font[(character - ' ') * k_font_width],
-             char_width, k_font_height,
+        blit(x_pos, y_pos, &k_font[glyph * k_font_width], char_width,
              invert);   // draw the character
-        draw(x_pos + char_width, y_pos, nullptr, 1, k_font_height,
+        blit(x_pos + char_width, y_pos, nullptr, 1,
              invert);   // add letter spacing
     }
     return char_width + 1;   // +1 is for letter spacing
@@ -200,39 +307,15 @@ auto Screen::printChar(int16_t x_pos, int16_t y_pos, char character,
 
 auto Screen::printCharBig(int16_t x_pos, int16_t y_pos, char character,
                           bool invert, bool dry_run) -> uint16_t {
-    uint8_t font_element;
-    uint8_t big_font_element = 0x00;
-    uint8_t char_width = 0;
-    for (auto j = 0; j < k_font_width * 2; j++) {
-        font_element = k_font[((character - ' ') * k_font_width) + (j / 2)];
-        // skip empty space
-        if (font_element == k_unused) {
-            continue;
-        }
-        ++char_width;
-        // interpolate the upper part of the character element
-        for (auto i = 0; std::cmp_less(i, k_font_height); i++) {
-            if (((1 << i / 2) & font_element) != 0) {
-                big_font_element |= (1 << i);
-            } else {
-                big_font_element &= ~(1 << i);
-            }
-        }
-        if (!dry_run) {
-            draw(x_pos + j, y_pos, &big_font_element, 1, k_font_height, invert);
-        }
-        // interpolate the bottom part of the character element
-        for (auto i = 0; std::cmp_less(i, k_font_height); i++) {
-            if (((1 << (4 + (i / 2))) & font_element) != 0) {
-                big_font_element |= (1 << i);
-            } else {
-                big_font_element &= ~(1 << i);
-            }
-        }
-        if (!dry_run) {
-            draw(x_pos + j, y_pos + k_font_height, &big_font_element, 1,
-                 k_font_height, invert);
-        }
+    auto glyph = glyphIndex(character);
+    if (glyph >= k_glyph_count) {
+        return 0;
+    }
+    uint8_t char_width = k_font_widths[glyph] * 2;
+    if (!dry_run) {
+        blit(x_pos, y_pos, k_big_font[glyph][0].data(), char_width, invert);
+        blit(x_pos, y_pos + k_font_height, k_big_font[glyph][1].data(),
+             char_width, invert);
     }
     return char_width + 2;   // +2 is for letter spacing
 }
@@ -246,13 +329,11 @@ auto Screen::printString(int16_t x_pos, int16_t y_pos, std::string_view str,
                          const StringConfig& config, bool dry_run) -> uint16_t {
     auto text_width = 0;
     if (config.align == TextAlign::center || config.align == TextAlign::right) {
-        // dry run to calculate width used for alignment
+        // sum up glyph widths to calculate width used for alignment
         for (const auto& character : str) {
-            for (uint8_t i = 0; i < k_font_width; i++) {
-                if (k_font[((character - ' ') * k_font_width) + i] !=
-                    k_unused) {
-                    ++text_width;
-                }
+            auto glyph = glyphIndex(character);
+            if (glyph < k_glyph_count) {
+                text_width += k_font_widths[glyph];
             }
         }
         text_width += str.size() - 1;   // add letter spacing to text width
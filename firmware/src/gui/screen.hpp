@@ -44,6 +44,19 @@ class Screen {
      */
     virtual auto build() -> FrameBuffer& = 0;
 
+    /**
+     * @brief Get the generation of the screen content
+     *
+     * The generation changes every time a setter changes what the screen
+     * shows. Generations are unique across all screens, so a screen that was
+     * never rendered never matches the generation of the last rendered one.
+     *
+     * @return Generation of the screen content
+     */
+    [[nodiscard]] auto getGeneration() const -> uint32_t {
+        return m_generation;
+    }
+
   protected:
     /**
      * @brief Enumeration describing text alignment
@@ -64,6 +77,26 @@ class Screen {
         bool invert = false;
     };
 
+    /**
+     * @brief Mark the screen content as changed
+     */
+    auto invalidate() -> void { m_generation = ++m_generation_counter; }
+
+    /**
+     * @brief Assign a new value to a field and invalidate the screen if the
+     * value is different
+     *
+     * @param[out] field Field shown on the screen
+     * @param[in] value New value
+     */
+    template <typename T>
+    auto updateField(T& field, const T& value) -> void {
+        if (field != value) {
+            field = value;
+            invalidate();
+        }
+    }
+
     /**
      * Clear the frame buffer
      */
@@ -90,6 +123,23 @@ class Screen {
     auto draw(int16_t x_pos, int16_t y_pos, const uint8_t* object,
               uint16_t width, uint16_t height, bool invert = false) -> void;
 
+    /**
+     * @brief Copy page sized columns into the frame buffer on desired x_pos,
+     * y_pos coordinates
+     *
+     * Faster alternative to draw() for objects that are exactly one page
+     * high, each column is written with at most two masked byte operations.
+     *
+     * @param[in] x_pos X coordianate
+     * @param[in] y_pos Y coordinate
+     * @param[in] columns Buffer containing one byte per column. If nullptr,
+     * empty columns are written.
+     * @param[in] width Number of columns
+     * @param[in] invert Flag indicating drawing in inverted mode
+     */
+    auto blit(int16_t x_pos, int16_t y_pos, const uint8_t* columns,
+              uint16_t width, bool invert = false) -> void;
+
     /**
      * @brief A function for drawing a rectange on desired x_pos, y_pos
      * coordinates
@@ -162,11 +212,19 @@ class Screen {
                      const StringConfig& config, bool dry_run = false)
         -> uint16_t;
 
-    // Make the frame buffer shared across all screens
+    // Make the frame buffer shared across all screens. It is the back buffer,
+    // the display driver keeps its own copy of the frame that is being sent
     static inline FrameBuffer m_frame_buffer{};
     static inline uint16_t m_width{0};
     static inline uint16_t m_height{0};
     static inline uint16_t m_page_height{0};
+    // Incremented on every clear(), allows a screen to detect whether the
+    // frame buffer still holds the content it has drawn
+    static inline uint32_t m_frame_buffer_epoch{0};
+
+  private:
+    static inline uint32_t m_generation_counter{0};
+    uint32_t m_generation{0};
 };
 
 #endif   // screen_hpp
@@ -0,0 +1,78 @@
+#include "statistics_screen.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "tiny_format.hpp"
+
+// Energy is shown in Wh like "12.345", charge in mAh like "1234.5"
+static constexpr NumberFormat k_energy_format{.decimals = 3, .scale = 3};
+static constexpr NumberFormat k_charge_format{.decimals = 1, .scale = 1};
+static constexpr NumberFormat k_time_format{.width = 2, .zero_pad = true};
+// Largest values that still fit the screen in the big font
+static constexpr int64_t k_max_energy = 99'999'999;   // uWh
+static constexpr int64_t k_max_charge = 99'999'900;   // uAh
+static constexpr uint32_t k_max_hours = 99;
+
+auto StatisticsScreen::build() -> FrameBuffer& {
+    clear();
+    std::array<char, 16> buffer;
+
+    printString(0, 0, "STATISTICS");
+    if (m_is_running) {
+        printString(m_width, 0, "REC", {.align = TextAlign::right});
+    }
+
+    printString(m_width / 2, 12,
+                TinyFormat{buffer}
+                    .append(m_energy, k_energy_format)
+                    .append("Wh")
+                    .str(),
+                {.align = TextAlign::center, .size = FontSize::big});
+    printString(m_width / 2, 32,
+                TinyFormat{buffer}
+                    .append(m_charge, k_charge_format)
+                    .append("mAh")
+                    .str(),
+                {.align = TextAlign::center, .size = FontSize::big});
+
+    auto hours = std::min(m_elapsed_time / 3600, k_max_hours);
+    auto minutes = (m_elapsed_time / 60) % 60;
+    auto seconds = m_elapsed_time % 60;
+    printString(m_width / 2, 54,
+                TinyFormat{buffer}
+                    .append(static_cast<int32_t>(hours), k_time_format)
+                    .append(":")
+                    .append(static_cast<int32_t>(minutes), k_time_format)
+                    .append(":")
+                    .append(static_cast<int32_t>(seconds), k_time_format)
+                    .str(),
+                {.align = TextAlign::center});
+    return m_frame_buffer;
+}
+
+auto StatisticsScreen::setEnergy(int64_t value) -> StatisticsScreen& {
+    // The screen resolution is 1 mWh, only redraw when that changes
+    updateField(m_energy, static_cast<int32_t>(
+                              std::clamp<int64_t>(value, 0, k_max_energy) /
+                              1000));
+    return *this;
+}
+
+auto StatisticsScreen::setCharge(int64_t value) -> StatisticsScreen& {
+    // The screen resolution is 0.1 mAh, only redraw when that changes
+    updateField(m_charge, static_cast<int32_t>(
+                              std::clamp<int64_t>(value, 0, k_max_charge) /
+                              100));
+    return *this;
+}
+
+auto StatisticsScreen::setElapsedTime(uint32_t value) -> StatisticsScreen& {
+    updateField(m_elapsed_time, value);
+    return *this;
+}
+
+auto StatisticsScreen::setRunning(bool value) -> StatisticsScreen& {
+    updateField(m_is_running, value);
+    return *this;
+}
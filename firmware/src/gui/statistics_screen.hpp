@@ -0,0 +1,67 @@
+#ifndef statistics_screen_hpp
+#define statistics_screen_hpp
+
+#include "screen.hpp"
+
+#include <cstdint>
+
+class StatisticsScreen : public Screen {
+  public:
+    /**
+     * @brief Constructor
+     */
+    StatisticsScreen() = default;
+
+    /**
+     * @brief Destructor
+     */
+    ~StatisticsScreen() override = default;
+
+    /**
+     * @brief Build the statistics screen based on data provided by user
+     *
+     * @return A reference to shared FrameBuffer matching the display
+     * dimensions.
+     */
+    auto build() -> FrameBuffer& override;
+
+    /**
+     * @brief Set the delivered energy
+     *
+     * @param[in] value Energy in uWh
+     * @return reference to this statistics screen object
+     */
+    auto setEnergy(int64_t value) -> StatisticsScreen&;
+
+    /**
+     * @brief Set the delivered charge
+     *
+     * @param[in] value Charge in uAh
+     * @return reference to this statistics screen object
+     */
+    auto setCharge(int64_t value) -> StatisticsScreen&;
+
+    /**
+     * @brief Set the duration of the session
+     *
+     * @param[in] value Elapsed time in s
+     * @return reference to this statistics screen object
+     */
+    auto setElapsedTime(uint32_t value) -> StatisticsScreen&;
+
+    /**
+     * @brief Set whether the session is running
+     *
+     * @param[in] value True while the output is enabled
+     * @return reference to this statistics screen object
+     */
+    auto setRunning(bool value) -> StatisticsScreen&;
+
+  private:
+    int32_t m_energy{0};          // mWh
+    int32_t m_charge{0};          // 0.1 mAh
+    uint32_t m_elapsed_time{0};   // s
+    bool m_is_running{false};
+};
+
+#endif   // statistics_screen_hpp
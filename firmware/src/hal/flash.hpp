@@ -0,0 +1,29 @@
+#ifndef flash_hpp
+#define flash_hpp
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+namespace hal::flash {
+/**
+ * @brief Concept for a reserved region of non-volatile memory.
+ *
+ * Addresses are relative to the start of the region. Erasing sets whole
+ * sectors to 0xFF, programming can only clear bits and is done in whole pages.
+ */
+template <typename T>
+concept Flash = requires(const T flash, uint32_t address, uint32_t size,
+                         std::span<uint8_t> rx_data,
+                         std::span<const uint8_t> tx_data) {
+    { flash.read(address, rx_data) } -> std::same_as<bool>;
+    { flash.erase(address, size) } -> std::same_as<bool>;
+    { flash.program(address, tx_data) } -> std::same_as<bool>;
+    { flash.getSize() } -> std::same_as<uint32_t>;
+    { T::getSectorSize() } -> std::same_as<uint32_t>;
+    { T::getPageSize() } -> std::same_as<uint32_t>;
+};
+
+}   // namespace hal::flash
+
+#endif   // flash_hpp
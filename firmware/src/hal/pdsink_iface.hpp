@@ -52,6 +52,9 @@ class IPdSink {
         uint16_t current_min{1000};   // mV
         uint16_t current_max{1000};   // mA
         uint16_t current_step{0};     // mA
+        // Lowest possible voltage_min when the source only reports a range,
+        // voltage_min is the upper end of it then. 0 if voltage_min is exact.
+        uint16_t voltage_min_floor{0};   // mV
     };
 
     /**
@@ -63,6 +66,16 @@ class IPdSink {
         bool has_fault{false};       // Any protection (OVP/OCP/OTP) tripped
     };
 
+    /**
+     * @brief Progress of the last PDO request.
+     */
+    enum class RequestResult {
+        Pending,    // Negotiation with the source is still running
+        Accepted,   // The source accepted the request, the output follows
+        Rejected,   // The source or the sink refused the request
+        Timeout     // The source did not answer
+    };
+
     /**
      * @brief Represents specific hardware fault conditions for a PD Sink.
      */
@@ -123,6 +136,17 @@ class IPdSink {
      */
     virtual auto getPDSourcePowerCapabilities() -> uint8_t = 0;
 
+    /**
+     * @brief Get a fingerprint of the source power capabilities
+     *
+     * Computed from the raw PDOs read by the last
+     * getPDSourcePowerCapabilities() call, so it is cheap and the same source
+     * always gives the same fingerprint.
+     *
+     * @return CRC-32 of the raw PDOs, 0 if they could not be read
+     */
+    virtual auto getSourceFingerprint() const -> uint32_t = 0;
+
     /**
      * @brief Retrieves the Power Data Object (PDO) at the specified index.
      *
@@ -139,24 +163,32 @@ class IPdSink {
     virtual auto getPdo(uint8_t index, Pdo& pdo) -> bool = 0;
 
     /**
-     * @brief Selects a Power Data Object (PDO) and sets the output voltage and
-     * current.
+     * @brief Starts the request of a Power Data Object (PDO) with the given
+     * output voltage and current.
      *
-     * This function configures the power supply to use the specified PDO index
-     * and applies the requested voltage and current.
+     * This function only sends the request and returns right away, the
+     * negotiation with the source continues in the background. Its progress is
+     * reported by getRequestResult(). A new request replaces the previous one.
      *
      * @param index   The PDO index to select (starting from 0).
      * @param voltage Desired output voltage in millivolts (mV).
      * @param current Desired output current in milliamps (mA).
      *
-     * @return true  If the PDO was successfully applied.
-     * @return false If the PDO selection or voltage/current setting failed.
+     * @return true  If the request was sent to the source.
+     * @return false If the arguments are invalid or the sink did not respond.
      *
      * @note Ensure that the requested voltage and current are within the limits
      *       of the selected PDO to prevent unexpected behavior.
      */
-    virtual auto setPdoOutput(uint8_t index, uint16_t voltage, uint16_t current)
+    virtual auto requestPdo(uint8_t index, uint16_t voltage, uint16_t current)
         -> bool = 0;
+
+    /**
+     * @brief Get the progress of the last request without blocking.
+     *
+     * @return Pending until the negotiation is finished, then the outcome
+     */
+    virtual auto getRequestResult() -> RequestResult = 0;
 };
 
 #endif   // pdsink_iface_hpp
@@ -0,0 +1,25 @@
+#ifndef serial_hpp
+#define serial_hpp
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+namespace hal::serial {
+/**
+ * @brief Concept for a byte stream to a host, like a USB CDC port.
+ *
+ * Neither function waits for the host. read() returns the number of bytes
+ * received so far, 0 if none, and write() the number of bytes accepted, fewer
+ * than passed while the host does not keep up.
+ */
+template <typename T>
+concept Serial = requires(const T serial, std::span<uint8_t> rx_data,
+                          std::span<const uint8_t> tx_data) {
+    { serial.read(rx_data) } -> std::same_as<int>;
+    { serial.write(tx_data) } -> std::same_as<int>;
+};
+
+}   // namespace hal::serial
+
+#endif   // serial_hpp
@@ -1,13 +1,34 @@
 #ifndef hardware_config_hpp
 #define hardware_config_hpp
 
+#ifdef TINYPPS_HOST_HAL
+// Host builds share one I2C bus between fakes of the devices, keep the
+// non-volatile data in RAM, let the host drive the pins and the timer and
+// serve the remote control interface on a pseudo-terminal
+#include "host_gpio_pin.hpp"
+#include "host_i2c_bus.hpp"
+#include "host_timer.hpp"
+#include "pty_serial.hpp"
+#include "ram_flash.hpp"
+
+using Flash = RamFlash;
+using GpioPin = HostGpioPin;
+using I2c = HostI2cBus;
+using RepeatingTimer = HostRepeatingTimer;
+using Serial = PtySerial;
+#else
+#include "pico_flash.hpp"
 #include "pico_gpio.hpp"
 #include "pico_i2c.hpp"
 #include "pico_timer.hpp"
+#include "pico_usb_serial.hpp"
 
+using Flash = PicoFlash;
 using GpioPin = PicoGpioPin;
 using I2c = PicoI2c;
 using RepeatingTimer = PicoRepeatingTimer;
+using Serial = PicoUsbSerial;
+#endif
 
 #include "ssd1306.hpp"
 
@@ -0,0 +1,31 @@
+#ifndef hardware_context_hpp
+#define hardware_context_hpp
+
+#include "flash_record.hpp"
+#include "hardware_config.hpp"
+#include "ina226.hpp"
+#include "log_store.hpp"
+#include "output_sequencer.hpp"
+#include "pd_request_queue.hpp"
+#include "pdsink_iface.hpp"
+
+using CalibrationStore = FlashRecord<Flash, Ina226::Calibration>;
+// Keys for the setpoints and lowest voltages of every PDO, the known sources
+// and their setpoints and the UI preferences, about 42 in use
+using SettingsStore = LogStore<Flash, 64>;
+
+/**
+ * @brief Struct containing references to hardware components
+ */
+struct HardwareContext {
+    IPdSink& pdsink;
+    PdRequestQueue& pd_requests;   // output requests, rate limited
+    OutputSequencer& sequencer;    // list of output steps, kept statically
+    const GpioPin& output_enable;
+    Ssd1306_128x64& oled;
+    Ina226& sensor;
+    const CalibrationStore& calibration_store;
+    SettingsStore& settings;
+};
+
+#endif   // hardware_context_hpp
@@ -0,0 +1,186 @@
+#include "ap33772s_i2c_target.hpp"
+
+#include <algorithm>
+
+// AP33772S Data Sheet - Register Map, only the ones the driver uses
+static constexpr uint8_t k_reg_status = 0x01;
+static constexpr uint8_t k_reg_mask = 0x02;
+static constexpr uint8_t k_reg_temp = 0x13;
+static constexpr uint8_t k_reg_srcpdo = 0x20;
+static constexpr uint8_t k_reg_src_pdo1 = 0x21;
+static constexpr uint8_t k_reg_pd_reqmsg = 0x31;
+static constexpr uint8_t k_reg_pd_msgrlt = 0x33;
+
+static constexpr uint8_t k_response_busy = 0;
+static constexpr uint8_t k_response_success = 1;
+static constexpr uint8_t k_response_rejected = 2;
+
+static constexpr uint8_t k_first_epr_index = 7;
+// Units of the voltage and current fields in mV and mA
+static constexpr uint16_t k_spr_voltage_unit = 100;
+static constexpr uint16_t k_epr_voltage_unit = 200;
+static constexpr uint16_t k_current_unit = 250;
+static constexpr uint16_t k_current_base = 1000;
+// Lowest voltages of adjustable PDOs in mV, a PPS with VOLTAGE_MIN = 2 only
+// reports that it is above 3.3 V and at most 5 V
+static constexpr uint16_t k_pps_voltage_min = 3300;
+static constexpr uint16_t k_pps_voltage_min_high = 5000;
+static constexpr uint16_t k_avs_voltage_min = 15000;
+
+// SRC_SPR_PDOX fields
+static auto getVoltageMax(uint16_t pdo) -> uint16_t { return pdo & 0xff; }
+static auto getVoltageMinCode(uint16_t pdo) -> uint8_t {
+    return (pdo >> 8) & 0x03;
+}
+static auto getCurrentMaxCode(uint16_t pdo) -> uint8_t {
+    return (pdo >> 10) & 0x0f;
+}
+static auto isAdjustable(uint16_t pdo) -> bool {
+    return ((pdo >> 14) & 0x01) != 0;
+}
+
+auto Ap33772sI2cTarget::writeTo(uint8_t addr,
+                                std::span<const uint8_t> tx_data) const
+    -> int {
+    if (addr != k_i2c_addr || tx_data.empty()) {
+        return -1;
+    }
+    m_pointer = tx_data[0];
+    if (tx_data.size() > 1) {
+        writeRegister(m_pointer, tx_data.subspan(1));
+    }
+    return static_cast<int>(tx_data.size());
+}
+
+auto Ap33772sI2cTarget::readFrom(uint8_t addr,
+                                 std::span<uint8_t> rx_data) const -> int {
+    if (addr != k_i2c_addr) {
+        return -1;
+    }
+    std::fill(rx_data.begin(), rx_data.end(), 0);
+    readRegister(m_pointer, rx_data);
+    return static_cast<int>(rx_data.size());
+}
+
+auto Ap33772sI2cTarget::attachSource(std::span<const uint16_t> pdos) -> void {
+    m_pdos = {};
+    m_voltage_min = {};
+    std::copy_n(pdos.begin(), std::min(pdos.size(), m_pdos.size()),
+                m_pdos.begin());
+    for (size_t i = 0; i < m_pdos.size(); ++i) {
+        if (!isAdjustable(m_pdos[i])) {
+            continue;
+        }
+        if (i >= k_first_epr_index) {
+            m_voltage_min[i] = k_avs_voltage_min;
+        } else {
+            m_voltage_min[i] = (getVoltageMinCode(m_pdos[i]) == 2)
+                                   ? k_pps_voltage_min_high
+                                   : k_pps_voltage_min;
+        }
+    }
+    m_contract = {.index = 0,
+                  .voltage = static_cast<uint16_t>(getVoltageMax(m_pdos[0]) *
+                                                   k_spr_voltage_unit),
+                  .current = 0};
+    m_status |= Started | Ready | NewPdo;
+}
+
+auto Ap33772sI2cTarget::setVoltageMin(uint8_t index, uint16_t voltage_min)
+    -> void {
+    if (index < m_voltage_min.size()) {
+        m_voltage_min[index] = voltage_min;
+    }
+}
+
+auto Ap33772sI2cTarget::writeRegister(uint8_t reg,
+                                      std::span<const uint8_t> value) const
+    -> void {
+    switch (reg) {
+    case k_reg_mask:
+        m_mask = value[0];
+        break;
+    case k_reg_pd_reqmsg:
+        if (value.size() < 2) {
+            break;
+        }
+        m_request = static_cast<uint16_t>(value[0] | (value[1] << 8));
+        m_response = k_response_busy;
+        m_pending_polls = m_response_delay;
+        ++m_request_count;
+        if (m_pending_polls == 0) {
+            m_response = evaluateRequest(m_request);
+        }
+        break;
+    default:
+        // The NTC, protection and system settings are not emulated
+        break;
+    }
+}
+
+auto Ap33772sI2cTarget::readRegister(uint8_t reg,
+                                     std::span<uint8_t> value) const -> void {
+    if (reg >= k_reg_src_pdo1 && reg < k_reg_src_pdo1 + k_max_pdo_entries &&
+        value.size() >= 2) {
+        uint16_t pdo = m_pdos[reg - k_reg_src_pdo1];
+        value[0] = static_cast<uint8_t>(pdo);
+        value[1] = static_cast<uint8_t>(pdo >> 8);
+        return;
+    }
+    switch (reg) {
+    case k_reg_status:
+        value[0] = m_status;
+        m_status = 0;
+        break;
+    case k_reg_mask:
+        value[0] = m_mask;
+        break;
+    case k_reg_temp:
+        value[0] = m_temperature;
+        break;
+    case k_reg_srcpdo:
+        for (size_t i = 0; i < value.size(); ++i) {
+            uint16_t pdo = (i / 2 < m_pdos.size()) ? m_pdos[i / 2] : 0;
+            value[i] = static_cast<uint8_t>(pdo >> (8 * (i % 2)));
+        }
+        break;
+    case k_reg_pd_msgrlt:
+        if (m_pending_polls > 0 && --m_pending_polls == 0) {
+            m_response = evaluateRequest(m_request);
+        }
+        value[0] = m_response;
+        break;
+    default:
+        break;
+    }
+}
+
+auto Ap33772sI2cTarget::evaluateRequest(uint16_t request) const -> uint8_t {
+    uint8_t position = request >> 12;
+    if (position == 0 || position > m_pdos.size() ||
+        m_pdos[position - 1] == 0) {
+        return k_response_rejected;
+    }
+    uint8_t index = position - 1;
+    uint16_t pdo = m_pdos[index];
+    uint16_t unit = (index >= k_first_epr_index) ? k_epr_voltage_unit
+                                                 : k_spr_voltage_unit;
+    uint16_t voltage_max = getVoltageMax(pdo) * unit;
+    auto voltage = static_cast<uint16_t>((request & 0xff) * unit);
+    auto current =
+        static_cast<uint16_t>((((request >> 8) & 0x0f) + 4) * k_current_unit);
+    uint16_t current_max =
+        k_current_base + (getCurrentMaxCode(pdo) * k_current_unit);
+    if (current > current_max) {
+        return k_response_rejected;
+    }
+    if (!isAdjustable(pdo)) {
+        // The voltage selection is ignored for a fixed PDO
+        voltage = voltage_max;
+    } else if (voltage < m_voltage_min[index] || voltage > voltage_max) {
+        return k_response_rejected;
+    }
+    m_contract = {.index = index, .voltage = voltage, .current = current};
+    m_status |= Ready;
+    return k_response_success;
+}
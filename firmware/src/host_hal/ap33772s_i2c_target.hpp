@@ -0,0 +1,148 @@
+#ifndef ap33772s_i2c_target_hpp
+#define ap33772s_i2c_target_hpp
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "i2c.hpp"
+
+/**
+ * @brief Host side AP33772S attached to an emulated USB PD source
+ *
+ * Implements the hal::i2c::I2c concept with the registers the Ap33772s driver
+ * uses. The host attaches a source with its raw SRCPDO words, requests
+ * written to PD_REQMSG are answered in PD_MSGRLT after a number of polls.
+ * Fixed PDOs accept any request up to their current. A PPS PDO accepts the
+ * voltages of its range, the exact lower end can be set apart from the one
+ * the SRCPDO word reports, like sources that only report 3.3 V to 5 V.
+ */
+class Ap33772sI2cTarget {
+  public:
+    static constexpr uint8_t k_i2c_addr = 0x52;
+    static constexpr uint8_t k_max_pdo_entries = 13;
+
+    /**
+     * @brief Status register bits
+     */
+    enum StatusFlag : uint8_t {
+        Started = 0x01,
+        Ready = 0x02,
+        NewPdo = 0x04,
+        UnderVoltage = 0x08,
+        OverVoltage = 0x10,
+        OverCurrent = 0x20,
+        OverTemperature = 0x40,
+    };
+
+    /**
+     * @brief Contract accepted last by the source
+     */
+    struct Contract {
+        uint8_t index{0};      // PDO index, starting from 0
+        uint16_t voltage{0};   // mV
+        uint16_t current{0};   // mA
+    };
+
+    /**
+     * @brief Attempt to write specified number of bytes to address
+     *
+     * @return Number of bytes written, or -1 if the address is not the one of
+     * the chip
+     */
+    auto writeTo(uint8_t addr, std::span<const uint8_t> tx_data) const -> int;
+
+    /**
+     * @brief Attempt to read specified number of bytes from address
+     *
+     * Reads the register selected by the last write, little endian. Reading
+     * the status register clears it.
+     *
+     * @return Number of bytes read, or -1 if the address is not the one of
+     * the chip
+     */
+    auto readFrom(uint8_t addr, std::span<uint8_t> rx_data) const -> int;
+
+    /**
+     * @brief Attach a source, it starts with the 5 V contract of the first PDO
+     *
+     * @param[in] pdos Raw SRCPDO words, at most k_max_pdo_entries
+     */
+    auto attachSource(std::span<const uint16_t> pdos) -> void;
+
+    /**
+     * @brief Set the voltages a PPS PDO really accepts
+     *
+     * @param[in] index PDO index, starting from 0
+     * @param[in] voltage_min Lowest accepted voltage [mV]
+     */
+    auto setVoltageMin(uint8_t index, uint16_t voltage_min) -> void;
+
+    /**
+     * @brief Set the number of PD_MSGRLT polls that are answered with busy
+     *
+     * @param[in] poll_count Polls before the result of a request is known
+     */
+    auto setResponseDelay(uint8_t poll_count) -> void {
+        m_response_delay = poll_count;
+    }
+
+    /**
+     * @brief Set the NTC temperature
+     *
+     * @param[in] temperature Temperature [Celsius]
+     */
+    auto setTemperature(uint8_t temperature) -> void {
+        m_temperature = temperature;
+    }
+
+    /**
+     * @brief Raise status flags, e.g. a protection that tripped
+     *
+     * @param[in] flags StatusFlag bits, kept until the status is read
+     */
+    auto raiseStatus(uint8_t flags) -> void { m_status |= flags; }
+
+    /**
+     * @brief Get the contract accepted last
+     *
+     * @return Contract, the voltage is 0 while no source is attached
+     */
+    [[nodiscard]] auto getContract() const -> Contract { return m_contract; }
+
+    /**
+     * @brief Get the number of requests written to PD_REQMSG
+     *
+     * @return Requests since construction
+     */
+    [[nodiscard]] auto getRequestCount() const -> uint32_t {
+        return m_request_count;
+    }
+
+  private:
+    auto writeRegister(uint8_t reg, std::span<const uint8_t> value) const
+        -> void;
+    auto readRegister(uint8_t reg, std::span<uint8_t> value) const -> void;
+    // Answer a PD_REQMSG request like the source would
+    auto evaluateRequest(uint16_t request) const -> uint8_t;
+
+    std::array<uint16_t, k_max_pdo_entries> m_pdos{};
+    std::array<uint16_t, k_max_pdo_entries> m_voltage_min{};
+    uint8_t m_response_delay{0};
+    uint8_t m_temperature{25};
+    // The I2c concept only allows const access, the registers change on every
+    // transfer
+    mutable uint8_t m_pointer{0};
+    mutable uint8_t m_status{0};
+    mutable uint8_t m_mask{0};
+    mutable uint8_t m_response{0};
+    mutable uint8_t m_pending_polls{0};
+    mutable uint16_t m_request{0};
+    mutable uint32_t m_request_count{0};
+    mutable Contract m_contract{};
+};
+
+static_assert(hal::i2c::I2c<Ap33772sI2cTarget>,
+              "Ap33772sI2cTarget must implement hal::i2c::I2c concept!");
+
+#endif   // ap33772s_i2c_target_hpp
@@ -0,0 +1,43 @@
+#include "host_gpio_pin.hpp"
+
+using hal::gpio::Direction;
+using hal::gpio::Edge;
+using hal::gpio::Pull;
+
+auto HostGpioPin::configure(Direction dir, Pull pull) const -> bool {
+    m_direction = dir;
+    if (dir == Direction::Input && pull != Pull::None) {
+        m_level = (pull == Pull::Up);
+    }
+    return true;
+}
+
+auto HostGpioPin::write(bool value) const -> bool {
+    if (m_direction != Direction::Output) {
+        return false;
+    }
+    m_level = value;
+    return true;
+}
+
+auto HostGpioPin::attachInterrupt(Edge edge,
+                                  hal::gpio::IrqCallback<HostGpioPin> callback,
+                                  void* user) const -> bool {
+    m_edge = edge;
+    m_callback = callback;
+    m_user = user;
+    return true;
+}
+
+auto HostGpioPin::setLevel(bool level) const -> void {
+    if (level == m_level) {
+        return;
+    }
+    m_level = level;
+    bool is_edge = (m_edge == Edge::Both) ||
+                   (m_edge == Edge::Rising && level) ||
+                   (m_edge == Edge::Falling && !level);
+    if (m_is_interrupt_enabled && m_callback != nullptr && is_edge) {
+        m_callback(*this, m_user);
+    }
+}
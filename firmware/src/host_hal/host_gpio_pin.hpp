@@ -0,0 +1,86 @@
+#ifndef host_gpio_pin_hpp
+#define host_gpio_pin_hpp
+
+#include "gpio.hpp"
+
+/**
+ * @brief Host side GPIO pin
+ *
+ * Implements the hal::gpio::GpioPin concept. An output keeps the level the
+ * firmware writes. The host drives an input with setLevel(), which calls the
+ * attached callback right away on a matching edge while the interrupt is
+ * enabled, like the interrupt would on the board. An input without a driven
+ * level follows its pull resistor.
+ */
+class HostGpioPin {
+  public:
+    /**
+     * @brief Configure the GPIO pin.
+     *
+     * @param dir  Pin direction (input or output)
+     * @param pull Internal pull resistor configuration
+     *
+     * @return Always true
+     */
+    auto configure(hal::gpio::Direction dir,
+                   hal::gpio::Pull pull = hal::gpio::Pull::None) const -> bool;
+
+    /**
+     * @brief Write a value to a digital pin.
+     *
+     * @param[in] value true - high, false - low
+     * @return False if the pin is an input
+     */
+    auto write(bool value) const -> bool;
+
+    /**
+     * @brief Reads the value from a specified digital pin.
+     *
+     * @return true - high, false - low
+     */
+    auto read() const -> bool { return m_level; }
+
+    /**
+     * @brief Attach an interrupt callback to the GPIO pin.
+     *
+     * @param edge Interrupt trigger edge
+     * @param callback Callback function
+     * @param user Optional user-defined context pointer
+     *
+     * @return Always true
+     */
+    auto attachInterrupt(hal::gpio::Edge edge,
+                         hal::gpio::IrqCallback<HostGpioPin> callback,
+                         void* user = nullptr) const -> bool;
+
+    /**
+     * @brief Enable or disable the GPIO interrupt.
+     *
+     * @param enable true to enable the interrupt, false to disable it
+     */
+    auto enableInterrupt(bool enable) const -> void {
+        m_is_interrupt_enabled = enable;
+    }
+
+    /**
+     * @brief Drive the level of an input from the host
+     *
+     * @param[in] level true - high, false - low
+     */
+    auto setLevel(bool level) const -> void;
+
+  private:
+    // The GpioPin concept only allows const access, like the registers of the
+    // pin on the board
+    mutable hal::gpio::Direction m_direction{hal::gpio::Direction::Input};
+    mutable bool m_level{false};
+    mutable hal::gpio::Edge m_edge{hal::gpio::Edge::Both};
+    mutable hal::gpio::IrqCallback<HostGpioPin> m_callback{nullptr};
+    mutable void* m_user{nullptr};
+    mutable bool m_is_interrupt_enabled{false};
+};
+
+static_assert(hal::gpio::GpioPin<HostGpioPin>,
+              "HostGpioPin must implement hal::gpio::GpioPin concept!");
+
+#endif   // host_gpio_pin_hpp
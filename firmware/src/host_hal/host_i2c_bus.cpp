@@ -0,0 +1,24 @@
+#include "host_i2c_bus.hpp"
+
+auto HostI2cBus::writeTo(uint8_t addr, std::span<const uint8_t> tx_data) const
+    -> int {
+    const auto* target = findTarget(addr);
+    return (target != nullptr) ? target->write(target->target, addr, tx_data)
+                               : -1;
+}
+
+auto HostI2cBus::readFrom(uint8_t addr, std::span<uint8_t> rx_data) const
+    -> int {
+    const auto* target = findTarget(addr);
+    return (target != nullptr) ? target->read(target->target, addr, rx_data)
+                               : -1;
+}
+
+auto HostI2cBus::findTarget(uint8_t address) const -> const Target* {
+    for (size_t i = 0; i < m_target_count; ++i) {
+        if (m_targets[i].address == address) {
+            return &m_targets[i];
+        }
+    }
+    return nullptr;
+}
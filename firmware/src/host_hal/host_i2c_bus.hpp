@@ -0,0 +1,87 @@
+#ifndef host_i2c_bus_hpp
+#define host_i2c_bus_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "i2c.hpp"
+
+/**
+ * @brief Host side I2C bus that routes every transfer to a target by address
+ *
+ * Implements the hal::i2c::I2c concept, so every driver of the firmware can
+ * share one bus like on the board. The targets are host fakes of the
+ * devices, each one an I2c implementation itself that only answers its own
+ * address. An address without a target is not acknowledged and the transfer
+ * fails, like a device that is not mounted.
+ */
+class HostI2cBus {
+  public:
+    static constexpr size_t k_max_targets = 4;
+
+    /**
+     * @brief Attach a target to the bus
+     *
+     * @param[in] address 7-bit address the target answers
+     * @param[in] target Target, must outlive the bus
+     * @return False if the address is taken or there is no free slot
+     */
+    template <hal::i2c::I2c T>
+    auto attach(uint8_t address, const T& target) -> bool {
+        if (m_target_count >= k_max_targets || findTarget(address) != nullptr) {
+            return false;
+        }
+        m_targets[m_target_count++] = {
+            .address = address,
+            .target = &target,
+            .write = [](const void* context, uint8_t addr,
+                        std::span<const uint8_t> tx_data) -> int {
+                return static_cast<const T*>(context)->writeTo(addr, tx_data);
+            },
+            .read = [](const void* context, uint8_t addr,
+                       std::span<uint8_t> rx_data) -> int {
+                return static_cast<const T*>(context)->readFrom(addr, rx_data);
+            }};
+        return true;
+    }
+
+    /**
+     * @brief Attempt to write specified number of bytes to address
+     *
+     * @param addr 7-bit address of device to write to
+     * @param data A constant view of the data buffer to be sent
+     * @return Number of bytes written, or -1 if no target has the address
+     */
+    auto writeTo(uint8_t addr, std::span<const uint8_t> tx_data) const -> int;
+
+    /**
+     * @brief Attempt to read specified number of bytes from address
+     *
+     * @param addr 7-bit address of device to read from
+     * @param data A view of the buffer to receive the data
+     * @return Number of bytes read, or -1 if no target has the address
+     */
+    auto readFrom(uint8_t addr, std::span<uint8_t> rx_data) const -> int;
+
+  private:
+    struct Target {
+        uint8_t address{0};
+        const void* target{nullptr};
+        int (*write)(const void* context, uint8_t addr,
+                     std::span<const uint8_t> tx_data){nullptr};
+        int (*read)(const void* context, uint8_t addr,
+                    std::span<uint8_t> rx_data){nullptr};
+    };
+
+    [[nodiscard]] auto findTarget(uint8_t address) const -> const Target*;
+
+    std::array<Target, k_max_targets> m_targets{};
+    size_t m_target_count{0};
+};
+
+static_assert(hal::i2c::I2c<HostI2cBus>,
+              "HostI2cBus must implement hal::i2c::I2c concept!");
+
+#endif   // host_i2c_bus_hpp
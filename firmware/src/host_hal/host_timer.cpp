@@ -0,0 +1,24 @@
+#include "host_timer.hpp"
+
+auto HostRepeatingTimer::start(uint32_t period_ms,
+                               hal::timer::Callback callback, void* context)
+    -> bool {
+    if (period_ms == 0 || callback == nullptr) {
+        return false;
+    }
+    m_callback = callback;
+    m_context = context;
+    m_period = period_ms;
+    m_elapsed = 0;
+    m_is_running = true;
+    return true;
+}
+
+auto HostRepeatingTimer::advance(uint32_t elapsed_ms) -> void {
+    m_elapsed += elapsed_ms;
+    // The callback may stop the timer
+    while (m_is_running && m_elapsed >= m_period) {
+        m_elapsed -= m_period;
+        m_callback(m_context);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef host_timer_hpp
+#define host_timer_hpp
+
+#include <cstdint>
+
+#include "timer.hpp"
+
+/**
+ * @brief Host side repeating timer driven by the host clock
+ *
+ * Implements the hal::timer::RepeatingTimer concept. There is no interrupt on
+ * the host, the callback is called from advance() once per elapsed period,
+ * so a simulation decides whether time follows the wall clock or runs as
+ * fast as possible.
+ */
+class HostRepeatingTimer {
+  public:
+    /**
+     * @brief Start a repeating timer.
+     *
+     * A running timer is restarted with the new parameters.
+     *
+     * @param period_ms Timer period in milliseconds, not 0
+     * @param callback Callback function to be called on each timer expiration.
+     * @param ctx User-defined context pointer passed to the callback.
+     *
+     * @return False if the period is 0 or the callback is missing
+     */
+    auto start(uint32_t period_ms, hal::timer::Callback callback, void* context)
+        -> bool;
+
+    /**
+     * @brief Stop the repeating timer.
+     */
+    auto stop() -> void { m_is_running = false; }
+
+    /**
+     * @brief Check whether the timer is running.
+     *
+     * @return true  Timer is running.
+     * @return false Timer is stopped.
+     */
+    [[nodiscard]] auto isRunning() const -> bool { return m_is_running; }
+
+    /**
+     * @brief Let time pass
+     *
+     * @param[in] elapsed_ms Time since the last call [ms]
+     */
+    auto advance(uint32_t elapsed_ms) -> void;
+
+  private:
+    hal::timer::Callback m_callback{nullptr};
+    void* m_context{nullptr};
+    uint32_t m_period{0};
+    uint32_t m_elapsed{0};
+    bool m_is_running{false};
+};
+
+static_assert(hal::timer::RepeatingTimer<HostRepeatingTimer>,
+              "HostRepeatingTimer must implement the "
+              "hal::timer::RepeatingTimer concept!");
+
+#endif   // host_timer_hpp
@@ -0,0 +1,158 @@
+#include "ina226_i2c_target.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+// INA226 Data Sheet - 7.6 Register Maps
+static constexpr uint8_t k_reg_manufacturer_id = 0xfe;
+static constexpr uint8_t k_reg_die_id = 0xff;
+static constexpr uint16_t k_manufacturer_id = 0x5449;
+static constexpr uint16_t k_die_id = 0x2260;
+static constexpr uint16_t k_configuration_reset = 0x4127;
+static constexpr uint16_t k_configuration_mask_reset = 0x8000;
+
+// INA226 Data Sheet - 7.6.7 Mask/Enable Register
+static constexpr uint16_t k_mask_shunt_over_voltage = 0x8000;
+static constexpr uint16_t k_mask_alert_function_flag = 0x0010;
+static constexpr uint16_t k_mask_overflow = 0x0004;
+static constexpr uint16_t k_mask_latch_enable = 0x0001;
+static constexpr uint16_t k_mask_flags = 0x001C;   // read only
+
+static constexpr int32_t k_shunt_voltage_lsb_pv = 2'500'000;   // 2.5 uV
+static constexpr int32_t k_bus_voltage_lsb_uv = 1250;
+// INA226 Data Sheet - 7.5 Programming, Current = Shunt x CAL / 2048 and
+// Power = Current x Bus Voltage / 20000
+static constexpr int32_t k_current_divider = 2048;
+static constexpr int32_t k_power_divider = 20000;
+
+Ina226I2cTarget::Ina226I2cTarget(int32_t shunt) : m_shunt(shunt) {
+    m_registers[Configuration] = k_configuration_reset;
+}
+
+auto Ina226I2cTarget::writeTo(uint8_t addr,
+                              std::span<const uint8_t> tx_data) const -> int {
+    if (addr != k_i2c_addr || tx_data.empty()) {
+        return -1;
+    }
+    m_pointer = tx_data[0];
+    if (tx_data.size() >= 3) {
+        writeRegister(m_pointer,
+                      static_cast<uint16_t>((tx_data[1] << 8) | tx_data[2]));
+    }
+    return static_cast<int>(tx_data.size());
+}
+
+auto Ina226I2cTarget::readFrom(uint8_t addr, std::span<uint8_t> rx_data) const
+    -> int {
+    if (addr != k_i2c_addr) {
+        return -1;
+    }
+    uint16_t value = readRegister(m_pointer);
+    for (size_t i = 0; i < rx_data.size(); ++i) {
+        rx_data[i] = (i == 0) ? static_cast<uint8_t>(value >> 8)
+                              : static_cast<uint8_t>(value);
+    }
+    return static_cast<int>(rx_data.size());
+}
+
+auto Ina226I2cTarget::setMeasurement(int32_t bus_voltage, int32_t current)
+    -> void {
+    // The shunt ADC saturates at +-81.92 mV
+    auto shunt_code = static_cast<int64_t>(current) * m_shunt /
+                      k_shunt_voltage_lsb_pv;
+    shunt_code = std::clamp<int64_t>(shunt_code, INT16_MIN, INT16_MAX);
+    m_registers[ShuntVoltage] = static_cast<uint16_t>(shunt_code);
+    m_registers[BusVoltage] = static_cast<uint16_t>(
+        std::clamp(bus_voltage / k_bus_voltage_lsb_uv, 0, INT16_MAX));
+    updateResults();
+    updateAlert();
+}
+
+auto Ina226I2cTarget::isAlert() const -> bool {
+    return (m_registers[MaskEnable] & k_mask_alert_function_flag) != 0;
+}
+
+auto Ina226I2cTarget::isOverflow() const -> bool {
+    return (m_registers[MaskEnable] & k_mask_overflow) != 0;
+}
+
+auto Ina226I2cTarget::writeRegister(uint8_t reg, uint16_t value) const
+    -> void {
+    switch (reg) {
+    case Configuration:
+        if ((value & k_configuration_mask_reset) != 0) {
+            m_registers = {};
+            m_registers[Configuration] = k_configuration_reset;
+            return;
+        }
+        m_registers[Configuration] = value;
+        return;
+    case Calibration:
+        // Bit 15 is not used
+        m_registers[Calibration] = value & INT16_MAX;
+        updateResults();
+        return;
+    case MaskEnable:
+        m_registers[MaskEnable] = (value & ~k_mask_flags) |
+                                  (m_registers[MaskEnable] & k_mask_flags);
+        updateAlert();
+        return;
+    case AlertLimit:
+        m_registers[AlertLimit] = value;
+        updateAlert();
+        return;
+    default:
+        // The result registers are read only
+        return;
+    }
+}
+
+auto Ina226I2cTarget::readRegister(uint8_t reg) const -> uint16_t {
+    switch (reg) {
+    case k_reg_manufacturer_id:
+        return k_manufacturer_id;
+    case k_reg_die_id:
+        return k_die_id;
+    case MaskEnable: {
+        // Reading clears the latched alert
+        uint16_t value = m_registers[MaskEnable];
+        m_registers[MaskEnable] &= ~k_mask_alert_function_flag;
+        return value;
+    }
+    default:
+        return (reg < Count) ? m_registers[reg] : 0;
+    }
+}
+
+auto Ina226I2cTarget::updateResults() const -> void {
+    auto shunt_code = static_cast<int16_t>(m_registers[ShuntVoltage]);
+    int64_t current =
+        static_cast<int64_t>(shunt_code) * m_registers[Calibration] /
+        k_current_divider;
+    int64_t power = std::abs(current) * m_registers[BusVoltage] /
+                    k_power_divider;
+    bool is_overflow = current < INT16_MIN || current > INT16_MAX ||
+                       power > UINT16_MAX;
+    m_registers[Current] = static_cast<uint16_t>(
+        std::clamp<int64_t>(current, INT16_MIN, INT16_MAX));
+    m_registers[Power] =
+        static_cast<uint16_t>(std::min<int64_t>(power, UINT16_MAX));
+    if (is_overflow) {
+        m_registers[MaskEnable] |= k_mask_overflow;
+    } else {
+        m_registers[MaskEnable] &= ~k_mask_overflow;
+    }
+}
+
+auto Ina226I2cTarget::updateAlert() const -> void {
+    auto& mask = m_registers[MaskEnable];
+    bool is_over = (mask & k_mask_shunt_over_voltage) != 0 &&
+                   static_cast<int16_t>(m_registers[ShuntVoltage]) >
+                       static_cast<int16_t>(m_registers[AlertLimit]);
+    if (is_over) {
+        mask |= k_mask_alert_function_flag;
+    } else if ((mask & k_mask_latch_enable) == 0) {
+        // Transparent mode follows the last conversion
+        mask &= ~k_mask_alert_function_flag;
+    }
+}
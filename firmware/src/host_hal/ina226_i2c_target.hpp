@@ -0,0 +1,103 @@
+#ifndef ina226_i2c_target_hpp
+#define ina226_i2c_target_hpp
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "i2c.hpp"
+
+/**
+ * @brief Host side INA226 with a register model of the chip
+ *
+ * Implements the hal::i2c::I2c concept. The host sets the bus voltage and the
+ * current through the shunt, every call is one completed conversion. The
+ * shunt, bus voltage, current and power registers are derived from it with
+ * the arithmetic of the chip, including the saturation of the shunt ADC and
+ * the math overflow flag of a current register that does not fit the
+ * calibration. The shunt over-voltage alert is latched like on the chip and
+ * cleared by reading the Mask/Enable register.
+ */
+class Ina226I2cTarget {
+  public:
+    static constexpr uint8_t k_i2c_addr = 0x40;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] shunt Shunt resistance [uOhm]
+     */
+    explicit Ina226I2cTarget(int32_t shunt);
+
+    /**
+     * @brief Attempt to write specified number of bytes to address
+     *
+     * One byte sets the register pointer, three bytes also write the register.
+     *
+     * @return Number of bytes written, or -1 if the address is not the one of
+     * the chip
+     */
+    auto writeTo(uint8_t addr, std::span<const uint8_t> tx_data) const -> int;
+
+    /**
+     * @brief Attempt to read specified number of bytes from address
+     *
+     * Reads the register selected by the last write, big endian.
+     *
+     * @return Number of bytes read, or -1 if the address is not the one of
+     * the chip
+     */
+    auto readFrom(uint8_t addr, std::span<uint8_t> rx_data) const -> int;
+
+    /**
+     * @brief Complete a conversion
+     *
+     * @param[in] bus_voltage Bus voltage [uV]
+     * @param[in] current Current through the shunt [uA]
+     */
+    auto setMeasurement(int32_t bus_voltage, int32_t current) -> void;
+
+    /**
+     * @brief Check the ALERT pin
+     *
+     * @return True while the latched alert is asserted
+     */
+    [[nodiscard]] auto isAlert() const -> bool;
+
+    /**
+     * @brief Check the math overflow flag of the last conversion
+     *
+     * @return True if the current or power register did not fit
+     */
+    [[nodiscard]] auto isOverflow() const -> bool;
+
+  private:
+    enum Register : uint8_t {
+        Configuration = 0x00,
+        ShuntVoltage = 0x01,
+        BusVoltage = 0x02,
+        Power = 0x03,
+        Current = 0x04,
+        Calibration = 0x05,
+        MaskEnable = 0x06,
+        AlertLimit = 0x07,
+        Count
+    };
+
+    auto writeRegister(uint8_t reg, uint16_t value) const -> void;
+    auto readRegister(uint8_t reg) const -> uint16_t;
+    // Derive the current and power registers from the last conversion
+    auto updateResults() const -> void;
+    auto updateAlert() const -> void;
+
+    int32_t m_shunt;
+    // The I2c concept only allows const access, the registers change on every
+    // write
+    mutable std::array<uint16_t, Count> m_registers{};
+    mutable uint8_t m_pointer{0};
+};
+
+static_assert(hal::i2c::I2c<Ina226I2cTarget>,
+              "Ina226I2cTarget must implement hal::i2c::I2c concept!");
+
+#endif   // ina226_i2c_target_hpp
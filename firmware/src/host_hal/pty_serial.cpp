@@ -0,0 +1,68 @@
+#include "pty_serial.hpp"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+PtySerial::~PtySerial() {
+    if (m_slave >= 0) {
+        close(m_slave);
+    }
+    if (m_master >= 0) {
+        close(m_master);
+    }
+}
+
+auto PtySerial::open() -> bool {
+    if (m_master >= 0) {
+        return true;
+    }
+    m_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_master < 0) {
+        return false;
+    }
+    const char* name = nullptr;
+    if (grantpt(m_master) == 0 && unlockpt(m_master) == 0) {
+        name = ptsname(m_master);
+    }
+    if (name != nullptr) {
+        m_slave = ::open(name, O_RDWR | O_NOCTTY);
+    }
+    // Pass every byte as is, no echo and no line editing
+    termios attributes{};
+    if (m_slave >= 0 && tcgetattr(m_slave, &attributes) == 0) {
+        cfmakeraw(&attributes);
+        if (tcsetattr(m_slave, TCSANOW, &attributes) == 0) {
+            return true;
+        }
+    }
+    if (m_slave >= 0) {
+        close(m_slave);
+        m_slave = -1;
+    }
+    close(m_master);
+    m_master = -1;
+    return false;
+}
+
+auto PtySerial::getPortName() const -> const char* {
+    const char* name = (m_master >= 0) ? ptsname(m_master) : nullptr;
+    return (name != nullptr) ? name : "";
+}
+
+auto PtySerial::read(std::span<uint8_t> rx_data) const -> int {
+    if (m_master < 0) {
+        return 0;
+    }
+    ssize_t count = ::read(m_master, rx_data.data(), rx_data.size());
+    return (count > 0) ? static_cast<int>(count) : 0;
+}
+
+auto PtySerial::write(std::span<const uint8_t> tx_data) const -> int {
+    if (m_master < 0) {
+        return 0;
+    }
+    ssize_t count = ::write(m_master, tx_data.data(), tx_data.size());
+    return (count > 0) ? static_cast<int>(count) : 0;
+}
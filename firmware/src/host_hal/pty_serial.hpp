@@ -0,0 +1,51 @@
+#ifndef pty_serial_hpp
+#define pty_serial_hpp
+
+#include <cstdint>
+#include <span>
+
+#include "serial.hpp"
+
+/**
+ * @brief Host side serial port backed by a pseudo-terminal
+ *
+ * Implements the hal::serial::Serial concept on the master side of a raw mode
+ * pseudo-terminal, host tools open the slave side like the USB CDC port of
+ * the device. Neither side waits for the other, a client that does not read
+ * stalls the writes once the terminal buffer is full.
+ */
+class PtySerial {
+  public:
+    PtySerial() = default;
+    PtySerial(const PtySerial&) = delete;
+    auto operator=(const PtySerial&) -> PtySerial& = delete;
+    ~PtySerial();
+
+    /**
+     * @brief Create the pseudo-terminal
+     *
+     * @return True on success
+     */
+    auto open() -> bool;
+
+    /**
+     * @brief Get the path host tools open
+     *
+     * @return Path of the slave side, empty if not open
+     */
+    [[nodiscard]] auto getPortName() const -> const char*;
+
+    auto read(std::span<uint8_t> rx_data) const -> int;
+
+    auto write(std::span<const uint8_t> tx_data) const -> int;
+
+  private:
+    int m_master{-1};
+    // Kept open, the master side reports a hang-up while no slave is open
+    int m_slave{-1};
+};
+
+static_assert(hal::serial::Serial<PtySerial>,
+              "PtySerial must implement hal::serial::Serial concept!");
+
+#endif   // pty_serial_hpp
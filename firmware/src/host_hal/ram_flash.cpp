@@ -0,0 +1,74 @@
+#include "ram_flash.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+auto RamFlash::read(uint32_t address, std::span<uint8_t> rx_data) const
+    -> bool {
+    if (!isInRange(address, rx_data.size())) {
+        return false;
+    }
+    std::memcpy(rx_data.data(), m_storage.data() + address, rx_data.size());
+    return true;
+}
+
+auto RamFlash::erase(uint32_t address, uint32_t size) const -> bool {
+    if (!isInRange(address, size) || (address % k_sector_size) != 0 ||
+        (size % k_sector_size) != 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+        if (!hasPower()) {
+            return false;
+        }
+        m_storage[address + i] = 0xFF;
+    }
+    m_erase_count += size / k_sector_size;
+    return true;
+}
+
+auto RamFlash::program(uint32_t address,
+                       std::span<const uint8_t> tx_data) const -> bool {
+    if (!isInRange(address, tx_data.size()) || (address % k_page_size) != 0 ||
+        (tx_data.size() % k_page_size) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < tx_data.size(); ++i) {
+        if (!hasPower()) {
+            return false;
+        }
+        m_storage[address + i] &= tx_data[i];
+    }
+    return true;
+}
+
+auto RamFlash::loadImage(const char* path) -> bool {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    size_t size = std::fread(m_storage.data(), 1, m_storage.size(), file);
+    bool is_eof = std::fgetc(file) == EOF;
+    std::fclose(file);
+    return size == m_storage.size() && is_eof;
+}
+
+auto RamFlash::saveImage(const char* path) const -> bool {
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    size_t size = std::fwrite(m_storage.data(), 1, m_storage.size(), file);
+    return (std::fclose(file) == 0) && size == m_storage.size();
+}
+
+auto RamFlash::hasPower() const -> bool {
+    if (m_power_budget == k_unlimited) {
+        return true;
+    }
+    if (m_power_budget == 0) {
+        return false;
+    }
+    --m_power_budget;
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef ram_flash_hpp
+#define ram_flash_hpp
+
+#include <cstdint>
+#include <span>
+
+#include "flash.hpp"
+
+/**
+ * @brief Host side flash region backed by a RAM buffer
+ *
+ * Implements the hal::flash::Flash concept with the constraints of NOR flash,
+ * erases set whole sectors to 0xFF and programming can only clear bits, so a
+ * store that programs without erasing produces the same corrupted data it
+ * would on the device. Erases are counted to measure the wear, and a power
+ * loss can be injected in the middle of any erase or program operation. The
+ * content can be kept in an image file between runs.
+ */
+class RamFlash {
+  public:
+    static constexpr uint32_t k_sector_size = 4096;
+    static constexpr uint32_t k_page_size = 256;
+    static constexpr uint32_t k_unlimited = UINT32_MAX;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] storage Backing buffer, a multiple of the sector size. It is
+     * kept as is, erase it first to start from a blank flash.
+     */
+    explicit RamFlash(std::span<uint8_t> storage) : m_storage(storage) {}
+
+    auto read(uint32_t address, std::span<uint8_t> rx_data) const -> bool;
+
+    auto erase(uint32_t address, uint32_t size) const -> bool;
+
+    auto program(uint32_t address, std::span<const uint8_t> tx_data) const
+        -> bool;
+
+    [[nodiscard]] auto getSize() const -> uint32_t {
+        return static_cast<uint32_t>(m_storage.size());
+    }
+
+    static constexpr auto getSectorSize() -> uint32_t { return k_sector_size; }
+
+    static constexpr auto getPageSize() -> uint32_t { return k_page_size; }
+
+    /**
+     * @brief Get the number of erased sectors
+     *
+     * @return Sector erases since construction
+     */
+    [[nodiscard]] auto getEraseCount() const -> uint32_t {
+        return m_erase_count;
+    }
+
+    /**
+     * @brief Cut the power after a number of erased or programmed bytes
+     *
+     * The operation in progress stops at that byte and returns false, like
+     * every later erase or program, until the budget is set again.
+     *
+     * @param[in] byte_count Bytes that are still written, k_unlimited to
+     * restore the power
+     */
+    auto setPowerBudget(uint32_t byte_count) -> void {
+        m_power_budget = byte_count;
+    }
+
+    /**
+     * @brief Load the content from an image file
+     *
+     * @param[in] path Image file path, must match the storage size
+     * @return True on success
+     */
+    auto loadImage(const char* path) -> bool;
+
+    /**
+     * @brief Write the content to an image file
+     *
+     * @param[in] path Image file path
+     * @return True on success
+     */
+    auto saveImage(const char* path) const -> bool;
+
+  private:
+    [[nodiscard]] auto isInRange(uint32_t address, size_t size) const -> bool {
+        return address <= m_storage.size() &&
+               size <= m_storage.size() - address;
+    }
+
+    // Consume the power budget of one byte
+    auto hasPower() const -> bool;
+
+    std::span<uint8_t> m_storage;
+    mutable uint32_t m_erase_count{0};
+    mutable uint32_t m_power_budget{k_unlimited};
+};
+
+static_assert(hal::flash::Flash<RamFlash>,
+              "RamFlash must implement hal::flash::Flash concept!");
+
+#endif   // ram_flash_hpp
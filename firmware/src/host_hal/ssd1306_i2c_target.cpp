@@ -0,0 +1,196 @@
+#include "ssd1306_i2c_target.hpp"
+
+#include <cstdio>
+
+// Control byte bits
+static constexpr uint8_t k_control_continuation = 0x80;
+static constexpr uint8_t k_control_data = 0x40;
+
+// Number of parameter bytes that follow a command
+static auto getParameterCount(uint8_t cmd) -> uint8_t {
+    switch (cmd) {
+    case 0x20:   // memory addressing mode
+    case 0x81:   // contrast
+    case 0x8D:   // charge pump
+    case 0xA8:   // multiplex ratio
+    case 0xD3:   // display offset
+    case 0xD5:   // display clock divide ratio
+    case 0xD9:   // pre-charge period
+    case 0xDA:   // COM pins hardware configuration
+    case 0xDB:   // VCOMH deselect level
+        return 1;
+    case 0x21:   // column address
+    case 0x22:   // page address
+    case 0xA3:   // vertical scroll area
+        return 2;
+    case 0x29:   // continuous vertical and horizontal scroll
+    case 0x2A:
+        return 5;
+    case 0x26:   // continuous horizontal scroll
+    case 0x27:
+        return 6;
+    case 0x2C:   // one column content scroll
+    case 0x2D:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+auto Ssd1306I2cTarget::writeTo(uint8_t addr,
+                               std::span<const uint8_t> tx_data) const
+    -> int {
+    if (addr != k_i2c_addr) {
+        return -1;
+    }
+    ++m_statistics.transactions;
+    m_statistics.bytes += tx_data.size();
+
+    size_t index = 0;
+    while (index < tx_data.size()) {
+        uint8_t control = tx_data[index++];
+        bool is_data = (control & k_control_data) != 0;
+        // Co = 1 means a single byte follows and then another control byte,
+        // Co = 0 means the rest of the transaction is data or commands
+        size_t count = ((control & k_control_continuation) != 0)
+                           ? 1
+                           : tx_data.size() - index;
+        for (; count > 0 && index < tx_data.size(); --count) {
+            uint8_t byte = tx_data[index++];
+            if (is_data) {
+                ++m_statistics.data_bytes;
+                writeData(byte);
+            } else {
+                ++m_statistics.command_bytes;
+                handleCommand(byte);
+            }
+        }
+    }
+    return static_cast<int>(tx_data.size());
+}
+
+auto Ssd1306I2cTarget::readFrom(uint8_t, std::span<uint8_t>) const -> int {
+    return -1;
+}
+
+auto Ssd1306I2cTarget::writePbm(const char* path, uint16_t height) const
+    -> bool {
+    if (height > k_page_count * 8) {
+        return false;
+    }
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "P4\n%u %u\n", k_width, height);
+    for (uint16_t y = 0; y < height; ++y) {
+        std::array<uint8_t, k_width / 8> row{};
+        for (uint16_t x = 0; x < k_width; ++x) {
+            uint8_t column = m_ram[((y / 8) * k_width) + x];
+            bool is_lit = ((column >> (y % 8)) & 1) != 0;
+            // PBM uses 1 for black
+            if (!is_lit) {
+                row[x / 8] |= static_cast<uint8_t>(0x80 >> (x % 8));
+            }
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    return std::fclose(file) == 0;
+}
+
+auto Ssd1306I2cTarget::handleCommand(uint8_t byte) const -> void {
+    m_command[m_command_size++] = byte;
+    if (m_command_size > getParameterCount(m_command[0])) {
+        executeCommand();
+        m_command_size = 0;
+    }
+}
+
+auto Ssd1306I2cTarget::executeCommand() const -> void {
+    const uint8_t cmd = m_command[0];
+    // The page and column start commands are documented for page addressing
+    // only, the controller applies them to the pointer in every mode
+    if (cmd <= 0x0F) {
+        m_column = static_cast<uint8_t>((m_column & 0xF0) | cmd);
+    } else if (cmd <= 0x1F) {
+        m_column =
+            static_cast<uint8_t>((m_column & 0x0F) | ((cmd & 0x07) << 4));
+    } else if (cmd >= 0xB0 && cmd <= 0xB7) {
+        m_page = cmd & 0x07;
+    }
+    switch (cmd) {
+    case 0x20:
+        m_mode = static_cast<AddressingMode>(m_command[1] & 0x03);
+        break;
+    case 0x21:
+        m_column_start = m_command[1] & 0x7F;
+        m_column_end = m_command[2] & 0x7F;
+        m_column = m_column_start;
+        break;
+    case 0x22:
+        m_page_start = m_command[1] & 0x07;
+        m_page_end = m_command[2] & 0x07;
+        m_page = m_page_start;
+        break;
+    case 0x2C:
+    case 0x2D:
+        scrollContent(cmd == 0x2D);
+        break;
+    case 0xAE:
+    case 0xAF:
+        m_is_display_on = cmd == 0xAF;
+        break;
+    default:
+        break;
+    }
+}
+
+auto Ssd1306I2cTarget::writeData(uint8_t byte) const -> void {
+    m_ram[(m_page * k_width) + m_column] = byte;
+    switch (m_mode) {
+    case AddressingMode::horizontal:
+        if (m_column++ >= m_column_end) {
+            m_column = m_column_start;
+            m_page = (m_page >= m_page_end) ? m_page_start : m_page + 1;
+        }
+        break;
+    case AddressingMode::vertical:
+        if (m_page++ >= m_page_end) {
+            m_page = m_page_start;
+            m_column =
+                (m_column >= m_column_end) ? m_column_start : m_column + 1;
+        }
+        break;
+    case AddressingMode::page:
+        // the column pointer wraps within the page
+        m_column = (m_column >= k_width - 1) ? 0 : m_column + 1;
+        break;
+    }
+}
+
+auto Ssd1306I2cTarget::scrollContent(bool is_left) const -> void {
+    const uint8_t start_page = m_command[2] & 0x07;
+    const uint8_t end_page = m_command[4] & 0x07;
+    const uint8_t start_column = m_command[6] & 0x7F;
+    const uint8_t end_column = m_command[7] & 0x7F;
+    if (start_column >= end_column) {
+        return;
+    }
+    for (uint8_t page = start_page; page <= end_page; ++page) {
+        auto* row = &m_ram[page * k_width];
+        // The column scrolled out of the range re-enters on the other side
+        if (is_left) {
+            uint8_t first = row[start_column];
+            for (uint8_t x = start_column; x < end_column; ++x) {
+                row[x] = row[x + 1];
+            }
+            row[end_column] = first;
+        } else {
+            uint8_t last = row[end_column];
+            for (uint8_t x = end_column; x > start_column; --x) {
+                row[x] = row[x - 1];
+            }
+            row[start_column] = last;
+        }
+    }
+}
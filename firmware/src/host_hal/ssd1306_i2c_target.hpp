@@ -0,0 +1,122 @@
+#ifndef ssd1306_i2c_target_hpp
+#define ssd1306_i2c_target_hpp
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "i2c.hpp"
+
+/**
+ * @brief Host side SSD1306 that decodes the I2C byte stream
+ *
+ * Implements the hal::i2c::I2c concept so it can be handed to the Ssd1306
+ * driver in host builds. Every write is decoded like the controller would do
+ * it, control bytes, commands with their parameters, addressing modes and
+ * data, and the graphic display RAM (GDDRAM) is reconstructed. Bus usage is
+ * counted, so the cost of a driver change can be measured at the wire level.
+ */
+class Ssd1306I2cTarget {
+  public:
+    /**
+     * @brief Counters of the bus traffic
+     */
+    struct BusStatistics {
+        uint32_t transactions{0};    // I2C write transactions
+        uint32_t bytes{0};           // all bytes including control bytes
+        uint32_t command_bytes{0};   // command and parameter bytes
+        uint32_t data_bytes{0};      // bytes written into the GDDRAM
+    };
+
+    static constexpr uint8_t k_i2c_addr = 0x3C;
+    static constexpr uint16_t k_width = 128;
+    static constexpr uint16_t k_page_count = 8;
+
+    /**
+     * @brief Attempt to write specified number of bytes to address
+     *
+     * @param addr 7-bit address of device to write to
+     * @param data A constant view of the data buffer to be sent
+     * @return Number of bytes written, or -1 if the address is not the one
+     * of the display
+     */
+    auto writeTo(uint8_t addr, std::span<const uint8_t> tx_data) const -> int;
+
+    /**
+     * @brief Attempt to read specified number of bytes from address
+     *
+     * Reading is not supported, the driver never reads from the display.
+     *
+     * @return Always -1
+     */
+    auto readFrom(uint8_t addr, std::span<uint8_t> rx_data) const -> int;
+
+    /**
+     * @brief Get the reconstructed display RAM
+     *
+     * @return Display RAM, one byte per column and page in page order
+     */
+    [[nodiscard]] auto getRam() const -> std::span<const uint8_t> {
+        return m_ram;
+    }
+
+    /**
+     * @brief Check whether the display is turned on
+     *
+     * @return True if the display on command was received
+     */
+    [[nodiscard]] auto isDisplayOn() const -> bool { return m_is_display_on; }
+
+    /**
+     * @brief Get the bus counters
+     *
+     * @return Bus traffic since construction or the last reset
+     */
+    [[nodiscard]] auto getStatistics() const -> BusStatistics {
+        return m_statistics;
+    }
+
+    /**
+     * @brief Reset the bus counters, e.g. at the start of a frame
+     */
+    auto resetStatistics() -> void { m_statistics = {}; }
+
+    /**
+     * @brief Write the first rows of the display RAM as a binary PBM image
+     *
+     * Lit pixels are written white, like they look on the panel.
+     *
+     * @param[in] path Output file path
+     * @param[in] height Number of rows to write, the display height
+     * @return True on success
+     */
+    auto writePbm(const char* path, uint16_t height = 64) const -> bool;
+
+  private:
+    enum class AddressingMode : uint8_t { horizontal, vertical, page };
+
+    auto handleCommand(uint8_t byte) const -> void;
+    auto executeCommand() const -> void;
+    auto writeData(uint8_t byte) const -> void;
+    auto scrollContent(bool is_left) const -> void;
+
+    // The I2c concept only allows const access, the decoder state changes on
+    // every write
+    mutable std::array<uint8_t, k_width * k_page_count> m_ram{};
+    mutable std::array<uint8_t, 8> m_command{};
+    mutable uint8_t m_command_size{0};
+    mutable AddressingMode m_mode{AddressingMode::page};
+    mutable uint8_t m_column{0};
+    mutable uint8_t m_page{0};
+    mutable uint8_t m_column_start{0};
+    mutable uint8_t m_column_end{k_width - 1};
+    mutable uint8_t m_page_start{0};
+    mutable uint8_t m_page_end{k_page_count - 1};
+    mutable bool m_is_display_on{false};
+    mutable BusStatistics m_statistics;
+};
+
+static_assert(hal::i2c::I2c<Ssd1306I2cTarget>,
+              "Ssd1306I2cTarget must implement hal::i2c::I2c concept!");
+
+#endif   // ssd1306_i2c_target_hpp
@@ -1,7 +1,9 @@
 #include "ina226.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 
 static constexpr uint8_t k_cmd_configuration = 0x00;
 static constexpr uint8_t k_cmd_shunt_voltage = 0x01;
@@ -20,11 +22,28 @@ static constexpr uint16_t k_conf_mask_busvc = 0x01C0;
 static constexpr uint16_t k_conf_mask_shuntvc = 0x0038;
 static constexpr uint16_t k_conf_mask_mode = 0x0007;
 
+// INA226 Data Sheet - 7.1.7 Mask/Enable Register
+static constexpr uint16_t k_mask_shunt_over_voltage = 0x8000;
+static constexpr uint16_t k_mask_alert_function_flag = 0x0010;
+static constexpr uint16_t k_mask_latch_enable = 0x0001;
+
+// The poll periods the firmware relies on
+static_assert(Ina226::getPollPeriod(Ina226::Profile::FastTransient) == 1);
+static_assert(Ina226::getPollPeriod(Ina226::Profile::Balanced) == 19);
+static_assert(Ina226::getPollPeriod(Ina226::Profile::Precision) == 1056);
+
 static constexpr float k_max_shunt_voltage = 81.92e-3F;
 static constexpr float k_adc_resolution = 32768.0F;
 static constexpr float k_internal_calibration_multiplier = 5.12e-3F;
 static constexpr float k_bus_voltage_lsb = 1.25e-3F;
 static constexpr float k_shunt_voltage_lsb = 2.5e-6F;
+static constexpr float k_micro_per_unit = 1e6F;
+static constexpr int32_t k_bus_voltage_lsb_uv = 1250;
+// INA226 Data Sheet - 7.1.4 Power Register, Power LSB = 25 x Current LSB
+static constexpr int32_t k_power_lsb_multiplier = 25;
+// Shunt voltage LSB is 2.5 uV, applied as 5 / 2
+static constexpr int32_t k_shunt_voltage_lsb_num_uv = 5;
+static constexpr int32_t k_shunt_voltage_lsb_den = 2;
 
 Ina226::Ina226(const I2c& i2c, uint8_t address) : m_i2c(i2c), m_addr(address) {}
 
@@ -37,8 +56,13 @@ auto Ina226::calibrate(float max_current, float shunt) -> bool {
         return false;
     }
     // INA226 Data Sheet - 6.5 Programming
-    // (2) Calculate Current LSB (Maximum current divided over 2^15)
-    m_current_lsb = max_current / k_adc_resolution;
+    // (2) Calculate Current LSB (Maximum current divided over 2^15), rounded
+    // up to a whole uA as the data sheet suggests rounding to a round number
+    m_current_lsb_ua = static_cast<int32_t>(
+        std::ceil(max_current * k_micro_per_unit / k_adc_resolution));
+    m_current_lsb = static_cast<float>(m_current_lsb_ua) / k_micro_per_unit;
+    m_shunt_micro_ohm =
+        static_cast<int32_t>(std::lround(shunt * k_micro_per_unit));
     // (1) Compute Calibration Register value
     float calib_raw =
         k_internal_calibration_multiplier / (m_current_lsb * shunt);
@@ -77,6 +101,101 @@ auto Ina226::getCurrent() -> float {
     return signed_val * m_current_lsb;
 }
 
+auto Ina226::readBusVoltageCode(uint16_t& code) -> bool {
+    return readRegister(k_cmd_bus_voltage, code);
+}
+
+auto Ina226::readShuntVoltageCode(int16_t& code) -> bool {
+    uint16_t val = 0;
+    if (!readRegister(k_cmd_shunt_voltage, val)) {
+        return false;
+    }
+    code = static_cast<int16_t>(val);
+    return true;
+}
+
+auto Ina226::readPowerCode(uint16_t& code) -> bool {
+    return readRegister(k_cmd_power, code);
+}
+
+auto Ina226::readCurrentCode(int16_t& code) -> bool {
+    uint16_t val = 0;
+    if (!readRegister(k_cmd_current, val)) {
+        return false;
+    }
+    code = static_cast<int16_t>(val);
+    return true;
+}
+
+auto Ina226::getBusVoltageMicro() -> int32_t {
+    uint16_t code = 0;
+    if (!readBusVoltageCode(code)) {
+        return 0;
+    }
+    return m_calibration.voltage.apply(code * k_bus_voltage_lsb_uv);
+}
+
+auto Ina226::getShuntVoltageMicro() -> int32_t {
+    int16_t code = 0;
+    if (!readShuntVoltageCode(code)) {
+        return 0;
+    }
+    return code * k_shunt_voltage_lsb_num_uv / k_shunt_voltage_lsb_den;
+}
+
+auto Ina226::getCurrentMicro() -> int32_t {
+    int16_t code = 0;
+    if (!readCurrentCode(code)) {
+        return 0;
+    }
+    return m_calibration.current.apply(code * m_current_lsb_ua);
+}
+
+auto Ina226::getPowerMicro() -> int32_t {
+    uint16_t code = 0;
+    if (!readPowerCode(code)) {
+        return 0;
+    }
+    auto power = code * k_power_lsb_multiplier * m_current_lsb_ua;
+    power = LinearCorrection{.gain = m_calibration.voltage.gain}.apply(power);
+    return LinearCorrection{.gain = m_calibration.current.gain}.apply(power);
+}
+
+auto Ina226::setOverCurrentLimit(int32_t current) -> bool {
+    if (current <= 0) {
+        return writeRegister(k_cmd_mask_enable, 0);
+    }
+    if (m_shunt_micro_ohm == 0) {
+        return false;
+    }
+    // The chip compares uncorrected shunt voltages, undo the calibration
+    constexpr int64_t k_micro_per_milli = 1000;
+    const auto& correction = m_calibration.current;
+    auto raw_current =
+        ((current * k_micro_per_milli - correction.offset)
+         << LinearCorrection::k_gain_shift) /
+        correction.gain;
+    // uA * uOhm = pV, the shunt voltage LSB is 2.5 uV = 2500000 pV
+    constexpr int64_t k_shunt_voltage_lsb_pv = 2'500'000;
+    auto limit = raw_current * m_shunt_micro_ohm / k_shunt_voltage_lsb_pv;
+    limit = std::min<int64_t>(limit, INT16_MAX);
+    if (!writeRegister(k_cmd_alert_limit, static_cast<uint16_t>(limit))) {
+        return false;
+    }
+    return writeRegister(k_cmd_mask_enable,
+                         k_mask_shunt_over_voltage | k_mask_latch_enable);
+}
+
+auto Ina226::readAlertFlag(bool& is_alert) -> bool {
+    uint16_t mask = 0;
+    // Reading the register clears the latched alert
+    if (!readRegister(k_cmd_mask_enable, mask)) {
+        return false;
+    }
+    is_alert = (mask & k_mask_alert_function_flag) != 0;
+    return true;
+}
+
 auto Ina226::reset() -> bool {
     uint16_t config = 0;
     if (!readRegister(k_cmd_configuration, config)) {
@@ -87,6 +206,8 @@ auto Ina226::reset() -> bool {
         return false;
     }
     m_current_lsb = 0.0F;
+    m_current_lsb_ua = 0;
+    m_shunt_micro_ohm = 0;
     return false;
 }
 
@@ -171,6 +292,23 @@ auto Ina226::setMode(Mode mode) -> bool {
     return writeRegister(k_cmd_configuration, config);
 }
 
+auto Ina226::setProfile(Profile profile) -> bool {
+    uint16_t config = 0;
+    if (!readRegister(k_cmd_configuration, config)) {
+        return false;
+    }
+    const auto settings = getProfileSettings(profile);
+    config &= ~(k_conf_mask_average | k_conf_mask_busvc | k_conf_mask_shuntvc);
+    config |= (static_cast<uint8_t>(settings.averaging) << 9);
+    config |= (static_cast<uint8_t>(settings.bus_conversion_time) << 6);
+    config |= (static_cast<uint8_t>(settings.shunt_conversion_time) << 3);
+    if (!writeRegister(k_cmd_configuration, config)) {
+        return false;
+    }
+    m_profile = profile;
+    return true;
+}
+
 auto Ina226::getManufacturerID() -> uint16_t {
     uint16_t value = 0;
     readRegister(k_cmd_manufacturer_id, value);
@@ -2,8 +2,12 @@
 #define ina226_hpp
 
 #include "hardware_config.hpp"
+#include "linear_correction.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <string_view>
 
 /**
  * @brief Class representing INA226
@@ -54,6 +58,38 @@ class Ina226 {
         ShuntBusContinuous = 7,
     };
 
+    /**
+     * @brief Acquisition settings used in continuous shunt and bus mode
+     */
+    struct AcquisitionSettings {
+        AveragingMode averaging;
+        VoltageConversionTime bus_conversion_time;
+        VoltageConversionTime shunt_conversion_time;
+    };
+
+    /**
+     * @brief Named acquisition profiles
+     */
+    enum class Profile : uint8_t {
+        FastTransient,   // single 140 us conversions, follows fast changes
+        Balanced,        // 16 averaged 588 us conversions
+        Precision,       // 64 averaged 8.244 ms conversions, lowest noise
+        Count
+    };
+
+    /**
+     * @brief Per-unit correction of the bus voltage [uV] and current [uA]
+     *
+     * Compensates the shunt tolerance and the gain and offset errors of the
+     * chip, applied by the integer getters.
+     */
+    struct Calibration {
+        LinearCorrection voltage{};
+        LinearCorrection current{};
+
+        constexpr auto operator==(const Calibration&) const -> bool = default;
+    };
+
     /**
      * @brief Constructor
      * Table with Address Pins and Slave Addresses:
@@ -84,6 +120,9 @@ class Ina226 {
     /**
      * @brief Calibrate function
      *
+     * The current LSB is rounded up to a whole uA, so currents convert to uA
+     * with a single integer multiplication.
+     *
      * @param[in] max_current Maximum expected Current in Amperes
      * @param[in] shunt Shunt Resistance in Ohms
      */
@@ -110,6 +149,136 @@ class Ina226 {
      */
     auto getCurrent() -> float;
 
+    /**
+     * @brief Read the raw bus voltage register
+     *
+     * @param[out] code Bus voltage in units of 1.25 mV
+     * @return True if the register is correctly read
+     */
+    auto readBusVoltageCode(uint16_t& code) -> bool;
+
+    /**
+     * @brief Read the raw shunt voltage register
+     *
+     * @param[out] code Shunt voltage in units of 2.5 uV
+     * @return True if the register is correctly read
+     */
+    auto readShuntVoltageCode(int16_t& code) -> bool;
+
+    /**
+     * @brief Read the raw power register
+     *
+     * @param[out] code Power in units of 25 current LSBs times 1.25 mV
+     * @return True if the register is correctly read
+     */
+    auto readPowerCode(uint16_t& code) -> bool;
+
+    /**
+     * @brief Read the raw current register
+     *
+     * @param[out] code Current in units of the current LSB
+     * @return True if the register is correctly read
+     */
+    auto readCurrentCode(int16_t& code) -> bool;
+
+    /**
+     * @brief Read bus voltage without floating point math
+     *
+     * The voltage calibration is applied.
+     *
+     * @return voltage [uV]
+     */
+    auto getBusVoltageMicro() -> int32_t;
+
+    /**
+     * @brief Read shunt voltage without floating point math
+     *
+     * @return voltage [uV]
+     */
+    auto getShuntVoltageMicro() -> int32_t;
+
+    /**
+     * @brief Read current without floating point math
+     *
+     * The current calibration is applied.
+     *
+     * @return Current [uA]
+     */
+    auto getCurrentMicro() -> int32_t;
+
+    /**
+     * @brief Read power without floating point math
+     *
+     * The power is calculated by the chip from the same conversion as the
+     * current and the bus voltage. The voltage and current gains are applied,
+     * the offsets are not as they can not be separated from the product.
+     *
+     * @return Power [uW]
+     */
+    auto getPowerMicro() -> int32_t;
+
+    /**
+     * @brief Program the ALERT pin to fire when the current exceeds a limit
+     *
+     * Uses the shunt over-voltage alert with the limit converted to a shunt
+     * voltage, so it does not depend on the current register. The alert is
+     * latched, the ALERT pin stays asserted until readAlertFlag() is called.
+     * The chip compares every completed (averaged) conversion, the response
+     * time is one conversion period of the active profile.
+     *
+     * @param[in] current Current limit in mA, 0 disables the alert
+     * @return True if the alert is correctly configured
+     */
+    auto setOverCurrentLimit(int32_t current) -> bool;
+
+    /**
+     * @brief Read and clear the latched alert
+     *
+     * @param[out] is_alert True if the alert limit was exceeded
+     * @return True if the register is correctly read
+     */
+    auto readAlertFlag(bool& is_alert) -> bool;
+
+    /**
+     * @brief Set the per-unit measurement correction
+     *
+     * @param[in] calibration Correction, the default one does not change the
+     * readings
+     */
+    auto setCalibration(const Calibration& calibration) -> void {
+        m_calibration = calibration;
+    }
+
+    /**
+     * @brief Get the per-unit measurement correction
+     *
+     * @return Correction
+     */
+    [[nodiscard]] auto getCalibration() const -> const Calibration& {
+        return m_calibration;
+    }
+
+    /**
+     * @brief Get the current LSB chosen by calibrate()
+     *
+     * @return Current LSB [uA]
+     */
+    [[nodiscard]] auto getCurrentLsb() const -> int32_t {
+        return m_current_lsb_ua;
+    }
+
+    /**
+     * @brief Get the largest current the current register can hold
+     *
+     * Larger currents saturate the register, set by calibrate().
+     *
+     * @return Current [mA]
+     */
+    [[nodiscard]] auto getCurrentRange() const -> int32_t {
+        return static_cast<int32_t>(int64_t{m_current_lsb_ua} * INT16_MAX /
+                                    1000);
+    }
+
     /**
      * @brief reset configuration
      */
@@ -201,6 +370,83 @@ class Ina226 {
      */
     auto setMode(Mode mode = Mode::ShuntBusContinuous) -> bool;
 
+    /**
+     * @brief Set the averaging and conversion times of a profile
+     *
+     * The configuration register is written at once, the calibration is kept.
+     *
+     * @param[in] profile Acquisition profile
+     * @return True if the profile is correctly set
+     */
+    auto setProfile(Profile profile) -> bool;
+
+    /**
+     * @brief Get the active acquisition profile
+     *
+     * @return Acquisition profile
+     */
+    [[nodiscard]] auto getProfile() const -> Profile { return m_profile; }
+
+    /**
+     * @brief Get the period to poll the measurements with the active profile
+     *
+     * @return Poll period in ms
+     */
+    [[nodiscard]] auto getPollPeriod() const -> uint32_t {
+        return getPollPeriod(m_profile);
+    }
+
+    /**
+     * @brief Get the settings of an acquisition profile
+     *
+     * @param[in] profile Acquisition profile
+     * @return Acquisition settings
+     */
+    static constexpr auto getProfileSettings(Profile profile)
+        -> AcquisitionSettings {
+        return k_profiles[static_cast<uint8_t>(profile)].settings;
+    }
+
+    /**
+     * @brief Get the display name of an acquisition profile
+     *
+     * @param[in] profile Acquisition profile
+     * @return Short name
+     */
+    static constexpr auto getProfileName(Profile profile) -> std::string_view {
+        return k_profiles[static_cast<uint8_t>(profile)].name;
+    }
+
+    /**
+     * @brief Get the time the chip needs to produce a new averaged shunt and
+     * bus measurement
+     *
+     * @param[in] settings Acquisition settings
+     * @return Conversion period in us
+     */
+    static constexpr auto getConversionPeriod(
+        const AcquisitionSettings& settings) -> uint32_t {
+        return (getConversionTime(settings.bus_conversion_time) +
+                getConversionTime(settings.shunt_conversion_time)) *
+               getSampleCount(settings.averaging);
+    }
+
+    /**
+     * @brief Get the period to poll the measurements of a profile
+     *
+     * Reading faster than the chip converts only returns the same values
+     * again, so the period is the conversion period rounded up to whole ms.
+     *
+     * @param[in] profile Acquisition profile
+     * @return Poll period in ms
+     */
+    static constexpr auto getPollPeriod(Profile profile) -> uint32_t {
+        constexpr uint32_t k_us_per_ms = 1000;
+        auto period = getConversionPeriod(getProfileSettings(profile));
+        return std::max<uint32_t>((period + k_us_per_ms - 1) / k_us_per_ms,
+                                  1);
+    }
+
     /**
      * @brief Get Manufacturer ID
      *
@@ -226,6 +472,48 @@ class Ina226 {
     static const uint16_t k_die_id = 0x2260;
 
   private:
+    struct NamedProfile {
+        std::string_view name;
+        AcquisitionSettings settings;
+    };
+
+    static constexpr std::array<NamedProfile,
+                                static_cast<uint8_t>(Profile::Count)>
+        k_profiles = {{
+            {.name = "FAST",
+             .settings = {.averaging = AveragingMode::Samples1,
+                          .bus_conversion_time =
+                              VoltageConversionTime::Time140_us,
+                          .shunt_conversion_time =
+                              VoltageConversionTime::Time140_us}},
+            {.name = "BAL",
+             .settings = {.averaging = AveragingMode::Samples16,
+                          .bus_conversion_time =
+                              VoltageConversionTime::Time588_us,
+                          .shunt_conversion_time =
+                              VoltageConversionTime::Time588_us}},
+            {.name = "PREC",
+             .settings = {.averaging = AveragingMode::Samples64,
+                          .bus_conversion_time =
+                              VoltageConversionTime::Time8300_us,
+                          .shunt_conversion_time =
+                              VoltageConversionTime::Time8300_us}},
+        }};
+
+    // INA226 Data Sheet - 7.1.1 Configuration Register, typical values
+    static constexpr auto getConversionTime(VoltageConversionTime time)
+        -> uint32_t {
+        constexpr std::array<uint32_t, 8> k_conversion_times = {
+            140, 204, 332, 588, 1100, 2116, 4156, 8244};
+        return k_conversion_times[static_cast<uint8_t>(time)];
+    }
+
+    static constexpr auto getSampleCount(AveragingMode avg) -> uint32_t {
+        constexpr std::array<uint32_t, 8> k_sample_counts = {
+            1, 4, 16, 64, 128, 256, 512, 1024};
+        return k_sample_counts[static_cast<uint8_t>(avg)];
+    }
+
     template <typename T>
     auto min(const T& left, const T& right) -> const T& {
         return (right < left) ? right : left;   // Returns the first if equal
@@ -236,6 +524,10 @@ class Ina226 {
     const I2c& m_i2c;
     uint8_t m_addr;
     float m_current_lsb;
+    int32_t m_current_lsb_ua{0};
+    int32_t m_shunt_micro_ohm{0};
+    Profile m_profile{Profile::Balanced};
+    Calibration m_calibration{};
 };
 
 #endif   // ina226_hpp
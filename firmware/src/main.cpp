@@ -1,16 +1,22 @@
 #include <cstdint>
 #include <functional>
+#include <optional>
 
 #include "ap33772.hpp"
 #include "ap33772s.hpp"
 #include "config.hpp"
 #include "event.hpp"
 #include "hardware_config.hpp"
+#include "hardware_context.hpp"
 #include "ina226.hpp"
+#include "output_sequencer.hpp"
 #include "pdsink_iface.hpp"
+#include "pico/time.h"
 #include "rotary_encoder.hpp"
+#include "scpi_interpreter.hpp"
 #include "ssd1306.hpp"
 #include "state_machine.hpp"
+#include "task_scheduler.hpp"
 
 using hal::gpio::Direction;
 using hal::gpio::Edge;
@@ -30,6 +36,10 @@ static constexpr unsigned int k_g_output_enable_pin = 17;
 static constexpr unsigned int k_g_vout_status_pin = 14;
 
 static constexpr uint8_t k_ina226_addr = 0x40;
+// The INA226 ALERT output is not routed to the MCU on the current board
+// revision, set the GPIO it is wired to in order to enable the hardware cutoff
+static constexpr std::optional<unsigned int> k_g_ina226_alert_pin =
+    std::nullopt;
 
 // https://product.tdk.com/system/files/dam/doc/product/sensor/ntc/chip-ntc-thermistor/data_sheet/datasheet_ntcgs103jx103dt8.pdf
 // based on B value:
@@ -43,7 +53,39 @@ static constexpr unsigned int k_ntc_tr100 = 987;
 static constexpr uint16_t k_ap33772s_vsel_min = 3300;
 static constexpr uint8_t k_otp_threshold = 85;
 
-static constexpr uint32_t k_sensor_read_period = 20;
+// The last sector of the 2 MB W25Q16 flash holds the per-unit sensor
+// calibration and the four sectors below it the settings log, the program
+// image never reaches them
+static constexpr uint32_t k_flash_size = 2 * 1024 * 1024;
+static constexpr uint32_t k_calibration_flash_offset =
+    k_flash_size - PicoFlash::getSectorSize();
+static constexpr uint32_t k_calibration_magic = 0x494E4131;   // "INA1"
+static constexpr uint32_t k_settings_flash_size =
+    4 * PicoFlash::getSectorSize();
+static constexpr uint32_t k_settings_flash_offset =
+    k_calibration_flash_offset - k_settings_flash_size;
+static constexpr uint32_t k_settings_magic = 0x53455431;   // "SET1"
+
+static constexpr Ina226::Profile k_sensor_profile = Ina226::Profile::Balanced;
+static constexpr float k_sensor_current_range = 8.0F;   // A
+static constexpr float k_shunt_resistance = 0.01F;      // Ohm
+static constexpr int32_t k_ocp_limit = 5500;            // mA
+// The NTC follows the board temperature within seconds, V/I polling runs
+// first when both are due until the temperature read is an aging period late
+static constexpr uint32_t k_temperature_period = 1'000'000;   // us
+static constexpr uint8_t k_temperature_priority = 0;
+static constexpr uint8_t k_measurement_priority = 1;
+// The sequencer steps are deadlines, its tick runs first whenever it is due,
+// only while a list plays
+static constexpr uint32_t k_sequencer_period = 1000;   // us
+static constexpr uint8_t k_sequencer_priority = 2;
+static constexpr size_t k_task_count = 3;
+static constexpr uint32_t k_microseconds_per_millisecond = 1000;
+// Let the display controller scroll the chart, the panel must support the one
+// column content scroll command (2Dh), not all SSD1306 clones do
+static constexpr bool k_oled_hardware_scroll = false;
+// Answer to *IDN? of the remote control interface on the USB CDC port
+static constexpr std::string_view k_remote_identity = "TinyPPS,TinyPPS,0,2.0";
 
 static constexpr PicoGpioPin g_rot_enc_a_pin{k_rot_enc_a_pin};
 static constexpr PicoGpioPin g_rot_enc_b_pin{k_g_rot_enc_b_pin};
@@ -52,6 +94,14 @@ static constexpr PicoGpioPin g_output_enable{k_g_output_enable_pin};
 static constexpr PicoGpioPin g_vout_status{k_g_vout_status_pin};
 static constexpr PicoGpioPin g_pd_int{k_g_pd_int_pin};
 static constexpr PicoI2c g_i2c{k_i2c};
+static constexpr PicoUsbSerial g_usb_serial{};
+static constexpr PicoFlash g_calibration_flash{k_calibration_flash_offset,
+                                               PicoFlash::getSectorSize()};
+static constexpr CalibrationStore g_calibration_store{g_calibration_flash,
+                                                      k_calibration_magic};
+static constexpr PicoFlash g_settings_flash{k_settings_flash_offset,
+                                            k_settings_flash_size};
+SettingsStore g_settings{g_settings_flash, k_settings_magic};
 PicoRepeatingTimer g_timer;
 RotaryEncoder g_rotary_encoder{g_rot_enc_a_pin, g_rot_enc_b_pin,
                                g_rot_enc_btn_pin};
@@ -60,14 +110,51 @@ Ina226 g_ina226{g_i2c, k_ina226_addr};
 Ap33772 g_ap33772{g_i2c};
 Ap33772s g_ap33772s{g_i2c};
 std::reference_wrapper<IPdSink> g_pdsink = g_ap33772;
+OutputSequencer g_sequencer;
+ScpiInterpreter<PicoUsbSerial> g_remote{g_usb_serial, k_remote_identity};
 
 volatile uint32_t g_system_time = 0;
 volatile bool g_is_g_pd_interrupt_pending = false;
 volatile bool g_is_g_vout_status_interrupt_pending = false;
+volatile bool g_is_g_ocp_interrupt_pending = false;
 static std::array<uint8_t, Ssd1306_128x64::getFrameBufferSize()> g_frame_buffer;
 
+// Round a value in micro units to the nearest milli unit
+static auto microToMilli(int32_t value) -> int32_t {
+    constexpr int32_t k_micro_per_milli = 1000;
+    constexpr int32_t k_half = k_micro_per_milli / 2;
+    return (value >= 0) ? (value + k_half) / k_micro_per_milli
+                        : (value - k_half) / k_micro_per_milli;
+}
+
+// Voltage, current and power are consecutive register reads, a new INA226
+// conversion can finish in between, so they may stem from adjacent samples
+static auto readMeasurement(uint32_t timestamp, void* context) -> void {
+    int32_t voltage = g_ina226.getBusVoltageMicro();
+    int32_t current = g_ina226.getCurrentMicro();
+    int32_t power = g_ina226.getPowerMicro();
+    static_cast<StateMachine*>(context)->dispatch(
+        SensorUpdateEvent{.voltage = microToMilli(voltage),
+                          .current = microToMilli(current),
+                          .power = microToMilli(power),
+                          .timestamp = timestamp,
+                          .current_micro = current,
+                          .power_micro = power});
+}
+
+static auto readTemperature(uint32_t timestamp, void* context) -> void {
+    static_cast<StateMachine*>(context)->dispatch(TemperatureUpdateEvent{
+        .temperature = g_pdsink.get().getTemp(), .timestamp = timestamp});
+}
+
+static auto runSequencer(uint32_t timestamp, void* context) -> void {
+    static_cast<StateMachine*>(context)->dispatch(
+        SequencerTickEvent{.timestamp = timestamp});
+}
+
 auto initialize() -> void {
     g_i2c.initialize(k_i2c_sda_pin, k_i2c_scl_pin, k_i2c_speed);
+    g_usb_serial.initialize();
     g_rotary_encoder.initialize();
     g_output_enable.configure(Direction::Output, Pull::Down);
     g_vout_status.configure(Direction::Input, Pull::Down);
@@ -85,9 +172,33 @@ auto initialize() -> void {
         },
         nullptr);
     g_pd_int.enableInterrupt(true);
+    if constexpr (k_g_ina226_alert_pin.has_value()) {
+        static constexpr PicoGpioPin g_ina226_alert{
+            k_g_ina226_alert_pin.value_or(0)};
+        g_ina226_alert.configure(Direction::Input, Pull::Up);
+        // Cut the output right in the interrupt, without waiting for the main
+        // loop to handle the event
+        g_ina226_alert.attachInterrupt(
+            Edge::Falling,
+            [](const GpioPin&, void*) -> void {
+                g_output_enable.write(false);
+                g_is_g_ocp_interrupt_pending = true;
+            },
+            nullptr);
+        g_ina226_alert.enableInterrupt(true);
+    }
     g_oled.initialize();
-    g_ina226.setAveragingMode(Ina226::AveragingMode::Samples128);
-    g_ina226.calibrate(5, 0.01);
+    g_oled.enableHardwareScroll(k_oled_hardware_scroll, time_us_32);
+    g_ina226.setProfile(k_sensor_profile);
+    // Headroom above the over-current limit, the software fallback of the
+    // alert compares the current register, which saturates at the maximum
+    g_ina226.calibrate(k_sensor_current_range, k_shunt_resistance);
+    // Units without a stored calibration use the nominal shunt value
+    Ina226::Calibration calibration{};
+    if (g_calibration_store.load(calibration)) {
+        g_ina226.setCalibration(calibration);
+    }
+    g_settings.mount();
     Screen::initialize(g_frame_buffer, Ssd1306_128x64::getWidth(),
                        Ssd1306_128x64::getHeight(),
                        Ssd1306_128x64::getPageHeight());
@@ -96,6 +207,10 @@ auto initialize() -> void {
         g_ap33772.setNtc(k_ntc_tr25, k_ntc_tr50, k_ntc_tr75, k_ntc_tr100);
         g_ap33772.setOtpThreshold(k_otp_threshold);
         Ap33772::MaskReg mask;
+        // SUCCESS and the OVP/OCP/OTP flags resolve a PDO request without
+        // waiting for a poll, READY only feeds is_ready of the status
+        mask.bits.ready_en = 1;
+        mask.bits.success_en = 1;
         mask.bits.newpdo_en = 1;
         mask.bits.ocp_en = 1;
         mask.bits.otp_en = 1;
@@ -120,14 +235,34 @@ auto initialize() -> void {
 
 auto main() -> int {
     initialize();
-    HardwareContext hardware{.pdsink = g_pdsink.get(),
-                             .output_enable = g_output_enable,
-                             .oled = g_oled};
+    // The state machine holds the screens with their caches, several KB, so
+    // it is kept out of the 2 KB main stack
+    static PdRequestQueue pd_requests{g_pdsink.get()};
+    static HardwareContext hardware{.pdsink = g_pdsink.get(),
+                                    .pd_requests = pd_requests,
+                                    .sequencer = g_sequencer,
+                                    .output_enable = g_output_enable,
+                                    .oled = g_oled,
+                                    .sensor = g_ina226,
+                                    .calibration_store = g_calibration_store,
+                                    .settings = g_settings};
 
-    StateMachine state_machine{hardware};
+    static StateMachine state_machine{hardware};
+    state_machine.dispatch(OcpLimitUpdateEvent{k_ocp_limit});
+
+    TaskScheduler<k_task_count> scheduler{time_us_32};
+    size_t temperature_task = 0;
+    size_t measurement_task = 0;
+    size_t sequencer_task = 0;
+    scheduler.addTask(k_temperature_period, k_temperature_priority,
+                      readTemperature, &state_machine, temperature_task);
+    scheduler.addTask(0, k_measurement_priority, readMeasurement,
+                      &state_machine, measurement_task);
+    scheduler.addTask(k_sequencer_period, k_sequencer_priority, runSequencer,
+                      &state_machine, sequencer_task);
 
     uint32_t last_tick_time = 0;
-    uint32_t last_sensor_read_time = 0;
+    uint32_t settings_failure_count = 0;
 
     while (true) {
         uint32_t current_time = g_system_time;
@@ -142,12 +277,13 @@ auto main() -> int {
             g_rotary_encoder.clearState();
         }
 
-        if (current_time - last_sensor_read_time >= k_sensor_read_period) {
-            last_sensor_read_time = current_time;
-            state_machine.dispatch(SensorUpdateEvent{g_ina226.getBusVoltage(),
-                                                     g_ina226.getCurrent(),
-                                                     g_pdsink.get().getTemp()});
-        }
+        // Poll V/I as fast as the active acquisition profile converts, at
+        // most one sensor read or sequencer tick per loop
+        scheduler.setPeriod(
+            measurement_task,
+            g_ina226.getPollPeriod() * k_microseconds_per_millisecond);
+        scheduler.setEnabled(sequencer_task, g_sequencer.isRunning());
+        scheduler.run();
 
         if (g_is_g_pd_interrupt_pending) {
             g_is_g_pd_interrupt_pending = false;
@@ -155,11 +291,40 @@ auto main() -> int {
                 PdSinkStatusUpdateEvent{g_pdsink.get().getStatus()});
         }
 
+        PdRequestQueue::Outcome outcome;
+        if (pd_requests.process(current_time, outcome)) {
+            state_machine.dispatch(PdRequestStatusEvent{
+                .request = outcome.request, .result = outcome.result});
+        }
+
         if (g_is_g_vout_status_interrupt_pending) {
             g_is_g_vout_status_interrupt_pending = false;
             state_machine.dispatch(VoutStatusUpdateEvent{g_vout_status.read()});
         }
 
+        if (g_is_g_ocp_interrupt_pending) {
+            g_is_g_ocp_interrupt_pending = false;
+            // Release the latched ALERT pin
+            bool is_alert = false;
+            g_ina226.readAlertFlag(is_alert);
+            state_machine.dispatch(OverCurrentEvent{});
+        }
+
+        // At most one remote command per loop, the reply is sent while the
+        // next loops run
+        RemoteCommand command;
+        if (g_remote.poll(command)) {
+            state_machine.dispatch(RemoteCommandEvent{
+                .command = command, .reply = &g_remote.getReply()});
+        }
+
         state_machine.dispatch(SystemTickEvent{delta});
+        state_machine.flushUI();
+
+        // A setting that could not be stored is lost at the next start
+        if (state_machine.getSettingsFailureCount() != settings_failure_count) {
+            settings_failure_count = state_machine.getSettingsFailureCount();
+            g_remote.reportError(ScpiError::SystemError);
+        }
     }
 }
@@ -0,0 +1,41 @@
+#include "pico_flash.hpp"
+
+#include <cstring>
+
+#include "hardware/regs/addressmap.h"
+#include "hardware/sync.h"
+
+auto PicoFlash::read(uint32_t address, std::span<uint8_t> rx_data) const
+    -> bool {
+    if (!isInRange(address, rx_data.size())) {
+        return false;
+    }
+    const auto* source =
+        reinterpret_cast<const uint8_t*>(XIP_BASE + m_offset + address);
+    std::memcpy(rx_data.data(), source, rx_data.size());
+    return true;
+}
+
+auto PicoFlash::erase(uint32_t address, uint32_t size) const -> bool {
+    if (!isInRange(address, size) || (address % getSectorSize()) != 0 ||
+        (size % getSectorSize()) != 0) {
+        return false;
+    }
+    uint32_t interrupts = save_and_disable_interrupts();
+    flash_range_erase(m_offset + address, size);
+    restore_interrupts(interrupts);
+    return true;
+}
+
+auto PicoFlash::program(uint32_t address,
+                        std::span<const uint8_t> tx_data) const -> bool {
+    if (!isInRange(address, tx_data.size()) ||
+        (address % getPageSize()) != 0 ||
+        (tx_data.size() % getPageSize()) != 0) {
+        return false;
+    }
+    uint32_t interrupts = save_and_disable_interrupts();
+    flash_range_program(m_offset + address, tx_data.data(), tx_data.size());
+    restore_interrupts(interrupts);
+    return true;
+}
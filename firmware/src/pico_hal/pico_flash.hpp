@@ -0,0 +1,82 @@
+#ifndef pico_flash_hpp
+#define pico_flash_hpp
+
+#include <cstdint>
+#include <span>
+
+#include "flash.hpp"
+#include "hardware/flash.h"
+
+class PicoFlash {
+  public:
+    /**
+     * @brief Create a view of a region of the on-board QSPI flash
+     *
+     * The region must not overlap the program image. It should be placed at
+     * the end of the flash, where it survives flashing a new firmware.
+     *
+     * @param[in] offset Offset of the region from the start of the flash,
+     * sector aligned
+     * @param[in] size Size of the region in bytes, multiple of the sector size
+     */
+    constexpr PicoFlash(uint32_t offset, uint32_t size)
+        : m_offset(offset), m_size(size) {}
+
+    /**
+     * @brief Read from the region through the XIP window
+     *
+     * @param[in] address Address relative to the region
+     * @param[out] rx_data Destination buffer
+     * @return True if the range lies within the region
+     */
+    auto read(uint32_t address, std::span<uint8_t> rx_data) const -> bool;
+
+    /**
+     * @brief Erase whole sectors
+     *
+     * Interrupts are disabled while the flash is busy, the code running from
+     * flash can not be fetched meanwhile. Erasing a sector takes tens of ms.
+     *
+     * @param[in] address Sector aligned address relative to the region
+     * @param[in] size Multiple of the sector size
+     * @return True if the sectors are erased
+     */
+    auto erase(uint32_t address, uint32_t size) const -> bool;
+
+    /**
+     * @brief Program whole pages
+     *
+     * @param[in] address Page aligned address relative to the region
+     * @param[in] tx_data Data, a multiple of the page size
+     * @return True if the pages are programmed
+     */
+    auto program(uint32_t address, std::span<const uint8_t> tx_data) const
+        -> bool;
+
+    /**
+     * @brief Get the size of the region
+     *
+     * @return Size in bytes
+     */
+    [[nodiscard]] auto getSize() const -> uint32_t { return m_size; }
+
+    static constexpr auto getSectorSize() -> uint32_t {
+        return FLASH_SECTOR_SIZE;
+    }
+
+    static constexpr auto getPageSize() -> uint32_t { return FLASH_PAGE_SIZE; }
+
+  private:
+    [[nodiscard]] auto isInRange(uint32_t address, uint32_t size) const
+        -> bool {
+        return address <= m_size && size <= m_size - address;
+    }
+
+    uint32_t m_offset;
+    uint32_t m_size;
+};
+
+static_assert(hal::flash::Flash<PicoFlash>,
+              "PicoFlash must implement hal::flash::Flash concept!");
+
+#endif   // pico_flash_hpp
@@ -0,0 +1,38 @@
+#include "pico_usb_serial.hpp"
+
+#include <algorithm>
+
+#include "hardware/sync.h"
+#include "pico/stdio/driver.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+
+// The stdio driver services the device stack from an interrupt and guards
+// the CDC buffers against it. The data goes through the driver, only the free
+// space of the transmit buffer is read directly, with the interrupts masked.
+
+auto PicoUsbSerial::initialize() const -> bool { return stdio_usb_init(); }
+
+auto PicoUsbSerial::read(std::span<uint8_t> rx_data) const -> int {
+    int count = stdio_usb.in_chars(reinterpret_cast<char*>(rx_data.data()),
+                                   static_cast<int>(rx_data.size()));
+    return (count > 0) ? count : 0;
+}
+
+auto PicoUsbSerial::write(std::span<const uint8_t> tx_data) const -> int {
+    if (!stdio_usb_connected()) {
+        return static_cast<int>(tx_data.size());
+    }
+    // Never pass more than fits, the driver would wait for the host. The
+    // background task only drains the buffer, the space is still free when
+    // the driver takes its lock.
+    uint32_t interrupts = save_and_disable_interrupts();
+    uint32_t available = tud_cdc_write_available();
+    restore_interrupts(interrupts);
+    auto count = static_cast<int>(std::min<size_t>(tx_data.size(), available));
+    if (count > 0) {
+        stdio_usb.out_chars(reinterpret_cast<const char*>(tx_data.data()),
+                            count);
+    }
+    return count;
+}
@@ -0,0 +1,45 @@
+#ifndef pico_usb_serial_hpp
+#define pico_usb_serial_hpp
+
+#include <cstdint>
+#include <span>
+
+#include "serial.hpp"
+
+class PicoUsbSerial {
+  public:
+    /**
+     * @brief Create a view of the USB CDC port of the stdio driver
+     */
+    constexpr PicoUsbSerial() = default;
+
+    /**
+     * @brief Initialize the USB device stack
+     *
+     * @return True on success
+     */
+    auto initialize() const -> bool;
+
+    /**
+     * @brief Read the bytes received so far, never waits
+     *
+     * @param[out] rx_data Destination buffer
+     * @return Number of bytes read, 0 if none
+     */
+    auto read(std::span<uint8_t> rx_data) const -> int;
+
+    /**
+     * @brief Write as many bytes as the transmit buffer takes, never waits
+     *
+     * The data is dropped while no host has the port open.
+     *
+     * @param[in] tx_data Data to send
+     * @return Number of bytes accepted
+     */
+    auto write(std::span<const uint8_t> tx_data) const -> int;
+};
+
+static_assert(hal::serial::Serial<PicoUsbSerial>,
+              "PicoUsbSerial must implement hal::serial::Serial concept!");
+
+#endif   // pico_usb_serial_hpp
@@ -16,6 +16,8 @@ class Ssd1306 {
                   "Unsupported oled display height");
 
   public:
+    using Clock = uint32_t (*)();
+
     /**
      * @brief Constructor
      *
@@ -35,11 +37,85 @@ class Ssd1306 {
      * Instead of pushing the full buffer over I2C, this method only transmits
      * 128-byte segments (pages) that actually contains changes.
      *
+     * This call blocks until the whole frame is sent. A frame that is still
+     * being flushed in the background is completed first.
+     *
      * @param[in] frame_buffer A constant view of the contiguous image or pixel
      * data.
      */
     auto display(std::span<const uint8_t> frame_buffer) -> void;
 
+    /**
+     * @brief Hand a frame over to the background flush.
+     *
+     * Dirty pages of the frame are copied into the front buffer owned by the
+     * driver, so the caller can start building the next frame right away. The
+     * frame is rejected while the previous one is still being sent, a half
+     * sent frame is never overwritten.
+     *
+     * @param[in] frame_buffer A constant view of the contiguous image or pixel
+     * data.
+     * @return True if the frame is accepted, false if the display is busy or
+     * the buffer size does not match
+     */
+    auto submit(std::span<const uint8_t> frame_buffer) -> bool;
+
+    /**
+     * @brief Send the next dirty page of the submitted frame.
+     *
+     * Call this function in a loop. Every call transmits at most one page, so
+     * the time spent on I2C per call is bounded by a single page transfer.
+     *
+     * @return True if there are still pages waiting to be sent
+     */
+    auto flush() -> bool;
+
+    /**
+     * @brief Check whether a submitted frame is still being sent
+     *
+     * @return True if the flush of the last submitted frame is not finished
+     */
+    [[nodiscard]] auto isBusy() const -> bool {
+        return m_dirty_pages != 0 || m_scroll_pages != 0;
+    }
+
+    /**
+     * @brief Enable scrolling pages in the display RAM
+     *
+     * When enabled, submit() detects a run of pages whose new content is the
+     * old content moved left by one column. Those pages are scrolled by the
+     * controller with the one column content scroll command and only the new
+     * right most column is written, instead of sending the whole pages. The
+     * front buffer is shifted the same way, so page diffing stays in sync
+     * with the display RAM.
+     *
+     * The controller needs two display frames between two scrolls. A frame
+     * submitted sooner after the last scroll is sent as whole pages.
+     *
+     * @param[in] enable True to enable hardware scrolling
+     * @param[in] clock Free running microsecond clock, may wrap around
+     */
+    auto enableHardwareScroll(bool enable, Clock clock) -> void {
+        m_is_hardware_scroll_enabled = enable && clock != nullptr;
+        m_clock = clock;
+        if (m_is_hardware_scroll_enabled) {
+            m_scroll_time = m_clock() - k_scroll_interval;
+        }
+    }
+
+    /**
+     * @brief Return the sequence number of the last frame that is completely
+     * shown on the display
+     *
+     * The sequence number is incremented every time an accepted frame is
+     * fully flushed, frames without changes included.
+     *
+     * @return Frame sequence number
+     */
+    [[nodiscard]] auto getFrameSequence() const -> uint32_t {
+        return m_frame_sequence;
+    }
+
     /**
      * @brief Return screen width
      *
@@ -79,6 +155,9 @@ class Ssd1306 {
   private:
     static constexpr uint16_t k_width = 128;
     static constexpr uint16_t k_page_height = Height / 8;
+    // Two frames of about 11.4 ms with the clock settings of initialize(),
+    // with margin for the oscillator tolerance
+    static constexpr uint32_t k_scroll_interval = 30'000;   // us
     // SSD1306 commands
     static constexpr uint8_t k_i2c_addr = 0x3C;
     static constexpr uint8_t k_set_mem_mode = 0x20;
@@ -86,6 +165,7 @@ class Ssd1306 {
     static constexpr uint8_t k_page_addr = 0x22;
     static constexpr uint8_t k_horiz_scroll = 0x26;
     static constexpr uint8_t k_set_scroll = 0x2E;
+    static constexpr uint8_t k_content_scroll_left = 0x2D;
     static constexpr uint8_t k_disp_start_line = 0x40;
     static constexpr uint8_t k_set_contrast = 0x81;
     static constexpr uint8_t k_set_charge_pump = 0x8D;
@@ -118,8 +198,42 @@ class Ssd1306 {
      */
     auto sendCommands(std::span<const uint8_t> cmds) -> void;
 
+    /**
+     * @brief Send a single page of the front buffer to display via I2C
+     *
+     * @param[in] page Page index
+     */
+    auto sendPage(uint8_t page) -> void;
+
+    /**
+     * @brief Scroll the pending pages left by one column and send the new
+     * right most column of each of them
+     */
+    auto sendScroll() -> void;
+
+    /**
+     * @brief Find pages of the frame that are the front buffer pages moved
+     * left by one column
+     *
+     * @param[in] frame_buffer New frame
+     * @return Bit mask of a contiguous run of pages that can be scrolled
+     */
+    auto findScrolledPages(std::span<const uint8_t> frame_buffer) const
+        -> uint8_t;
+
     const I2c& m_i2c;
-    std::array<uint8_t, k_width * k_page_height> m_old_fb;
+    // Front buffer, the content the display shows once all dirty pages are
+    // sent
+    std::array<uint8_t, k_width * k_page_height> m_front_fb;
+    // Bit mask of pages in the front buffer that are not sent yet
+    uint8_t m_dirty_pages{0};
+    // Bit mask of pages to be scrolled left by one column before their last
+    // column is sent
+    uint8_t m_scroll_pages{0};
+    bool m_is_hardware_scroll_enabled{false};
+    Clock m_clock{nullptr};
+    uint32_t m_scroll_time{0};   // us, last scroll command
+    uint32_t m_frame_sequence{0};
 };
 
 #include "ssd1306.inl"
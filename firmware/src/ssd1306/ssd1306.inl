@@ -1,10 +1,11 @@
 #include <algorithm>
+#include <bit>
 
 template <uint16_t Height>
 Ssd1306<Height>::Ssd1306(const I2c& i2c) : m_i2c(i2c) {
     // Initialize the buffer to values other than 0x00 to detect the first
     // update
-    m_old_fb.fill(0xff);
+    m_front_fb.fill(0xff);
 }
 
 template <uint16_t Height>
@@ -64,33 +65,167 @@ auto Ssd1306<Height>::initialize() -> void {
 
 template <uint16_t Height>
 auto Ssd1306<Height>::display(std::span<const uint8_t> frame_buffer) -> void {
-    if (m_old_fb.size() != frame_buffer.size()) {
+    // finish the frame that is currently being sent
+    while (flush()) {
+    }
+    if (!submit(frame_buffer)) {
         return;
     }
+    while (flush()) {
+    }
+}
+
+template <uint16_t Height>
+auto Ssd1306<Height>::submit(std::span<const uint8_t> frame_buffer) -> bool {
+    if (isBusy() || m_front_fb.size() != frame_buffer.size()) {
+        return false;
+    }
+    m_scroll_pages = findScrolledPages(frame_buffer);
     for (uint8_t page = 0; page < k_page_height; page++) {
         const auto offset = page * k_width;
-        const auto old_fb_slice = std::span{m_old_fb}.subspan(offset, k_width);
-        if (std::ranges::equal(old_fb_slice,
-                               frame_buffer.subspan(offset, k_width))) {
+        const auto front_fb_slice =
+            std::span{m_front_fb}.subspan(offset, k_width);
+        const auto frame_slice = frame_buffer.subspan(offset, k_width);
+        if ((m_scroll_pages & (1 << page)) != 0) {
+            // mirror the hardware scroll, the last column is sent afterwards
+            std::ranges::copy(frame_slice, front_fb_slice.begin());
+            continue;
+        }
+        if (std::ranges::equal(front_fb_slice, frame_slice)) {
             // new page is same as old, no update required
             continue;
         }
-        // Update only dirty pages
-        const auto cmds = std::to_array<uint8_t>({
-            0x00,
-            static_cast<uint8_t>(0xB0 |
-                                 page),   // Set target page (0xB0 to 0xB7)
-            0x00,                         // Set lower column start (0)
-            0x10                          // Set higher column start (0)
-        });
-        m_i2c.writeTo(k_i2c_addr, cmds);
-        std::array<uint8_t, k_width + 1> temp_buf;
-        temp_buf[0] = 0x40;
-        std::ranges::copy(frame_buffer.subspan(offset, k_width),
-                          temp_buf.begin() + 1);
-        m_i2c.writeTo(k_i2c_addr, temp_buf);
-    }
-    std::ranges::copy(frame_buffer, m_old_fb.begin());
+        std::ranges::copy(frame_slice, front_fb_slice.begin());
+        m_dirty_pages |= (1 << page);
+    }
+    if (!isBusy()) {
+        // nothing to send, the frame is already on the display
+        ++m_frame_sequence;
+    }
+    return true;
+}
+
+template <uint16_t Height>
+auto Ssd1306<Height>::flush() -> bool {
+    if (!isBusy()) {
+        return false;
+    }
+    if (m_scroll_pages != 0) {
+        sendScroll();
+        m_scroll_pages = 0;
+        if (!isBusy()) {
+            ++m_frame_sequence;
+        }
+        return isBusy();
+    }
+    // Update only dirty pages, one page per call
+    auto page = static_cast<uint8_t>(std::countr_zero(m_dirty_pages));
+    sendPage(page);
+    m_dirty_pages &= ~(1 << page);
+    if (!isBusy()) {
+        ++m_frame_sequence;
+    }
+    return isBusy();
+}
+
+template <uint16_t Height>
+auto Ssd1306<Height>::sendPage(uint8_t page) -> void {
+    const auto cmds = std::to_array<uint8_t>({
+        0x00,
+        static_cast<uint8_t>(0xB0 | page),   // Set target page (0xB0 to 0xB7)
+        0x00,                                // Set lower column start (0)
+        0x10                                 // Set higher column start (0)
+    });
+    m_i2c.writeTo(k_i2c_addr, cmds);
+    std::array<uint8_t, k_width + 1> temp_buf;
+    temp_buf[0] = 0x40;
+    std::ranges::copy(std::span{m_front_fb}.subspan(page * k_width, k_width),
+                      temp_buf.begin() + 1);
+    m_i2c.writeTo(k_i2c_addr, temp_buf);
+}
+
+template <uint16_t Height>
+auto Ssd1306<Height>::findScrolledPages(
+    std::span<const uint8_t> frame_buffer) const -> uint8_t {
+    if (!m_is_hardware_scroll_enabled ||
+        m_clock() - m_scroll_time < k_scroll_interval) {
+        return 0;
+    }
+    uint8_t shifted_pages = 0;
+    uint8_t changed_pages = 0;
+    for (uint8_t page = 0; page < k_page_height; page++) {
+        const auto offset = page * k_width;
+        const auto front_fb_slice =
+            std::span{m_front_fb}.subspan(offset, k_width);
+        const auto frame_slice = frame_buffer.subspan(offset, k_width);
+        if (std::ranges::equal(front_fb_slice.subspan(1),
+                               frame_slice.first(k_width - 1))) {
+            shifted_pages |= (1 << page);
+        }
+        if (!std::ranges::equal(front_fb_slice, frame_slice)) {
+            changed_pages |= (1 << page);
+        }
+    }
+    const auto scrolled_pages =
+        static_cast<uint8_t>(shifted_pages & changed_pages);
+    if (scrolled_pages == 0) {
+        return 0;
+    }
+    // The scroll command takes a single page range. Unchanged pages inside the
+    // range are fine as long as scrolling does not change them, e.g. empty
+    // ones. Otherwise fall back to sending whole pages.
+    const auto first = std::countr_zero(scrolled_pages);
+    const auto last = 7 - std::countl_zero(scrolled_pages);
+    const auto range =
+        static_cast<uint8_t>((0xFF >> (7 - last + first)) << first);
+    if ((range & shifted_pages) != range) {
+        return 0;
+    }
+    return range;
+}
+
+template <uint16_t Height>
+auto Ssd1306<Height>::sendScroll() -> void {
+    const auto start_page =
+        static_cast<uint8_t>(std::countr_zero(m_scroll_pages));
+    const auto end_page =
+        static_cast<uint8_t>(7 - std::countl_zero(m_scroll_pages));
+    const auto cmds = std::to_array<uint8_t>({
+        k_content_scroll_left,
+        0x00,          // dummy byte
+        start_page,    // start page address
+        0x01,          // dummy byte
+        end_page,      // end page address
+        0x00,          // dummy byte
+        0x00,          // start column address
+        k_width - 1,   // end column address
+        /* write the new column of the scrolled pages */
+        k_col_addr,
+        k_width - 1,
+        k_width - 1,
+        k_page_addr,
+        start_page,
+        end_page,
+    });
+    sendCommands(cmds);
+    m_scroll_time = m_clock();
+    std::array<uint8_t, k_page_height + 1> temp_buf;
+    temp_buf[0] = 0x40;
+    uint8_t length = 1;
+    for (auto page = start_page; page <= end_page; page++) {
+        temp_buf[length++] = m_front_fb[(page * k_width) + k_width - 1];
+    }
+    m_i2c.writeTo(k_i2c_addr, std::span{temp_buf}.first(length));
+    // restore the full address window used by sendPage()
+    const auto restore_cmds = std::to_array<uint8_t>({
+        k_col_addr,
+        0x00,
+        k_width - 1,
+        k_page_addr,
+        0x00,
+        k_page_height - 1,
+    });
+    sendCommands(restore_cmds);
 }
 
 template <uint16_t Height>
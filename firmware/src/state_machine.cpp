@@ -14,13 +14,72 @@ static constexpr uint32_t k_double_click_period = 1000;       // ms
 static constexpr uint32_t k_ui_refresh_period = 20;           // ms
 static constexpr uint32_t k_fault_recovery_period = 1000;     // ms
 static constexpr uint32_t k_sensor_update_period = 200;       // ms
-static constexpr uint32_t k_ramp_up_period = 500;             // ms
+static constexpr uint32_t k_ui_preferences_delay = 2000;      // ms
+
+// Per PDO, a source that stops answering keeps the reported upper end
+static constexpr uint32_t k_voltage_min_search_period = 2000;   // ms
+
+static constexpr uint32_t k_microseconds_per_second = 1'000'000;
 
 static constexpr uint16_t k_big_step_size = 250;
-static constexpr float k_low_voltage_threshold = 0.5F;
-static constexpr uint8_t k_low_voltage_reading_count = 10;
 
-static constexpr std::string_view k_menu_title = "Available PDOs";
+// Remote values are sent in V, A and W with the resolution of the sensor
+static constexpr NumberFormat k_remote_format{.decimals = 3, .scale = 3};
+
+// Keys of the values kept in the settings store
+static constexpr uint16_t k_settings_key_last_pdo = 0x0001;   // fingerprint
+static constexpr uint16_t k_settings_key_ui = 0x0002;         // UiPreferences
+static constexpr uint16_t k_settings_key_setpoint = 0x0100;   // + PDO index
+static constexpr uint16_t k_settings_key_vmin = 0x0200;       // + PDO index
+
+// Sources seen before, the least recently used slot is replaced by a new one
+static constexpr size_t k_max_known_sources = 4;
+static constexpr uint16_t k_settings_key_source = 0x0300;            // + slot
+static constexpr uint16_t k_settings_key_source_setpoint = 0x0310;   // + slot
+
+/**
+ * @brief Last voltage and current set for a PDO
+ */
+struct Setpoint {
+    uint32_t pdo_fingerprint;
+    uint16_t voltage;   // mV
+    uint16_t current;   // mA
+};
+
+/**
+ * @brief Lowest voltage found for a PDO that only reports a range
+ */
+struct VoltageMin {
+    uint32_t pdo_fingerprint;   // before the search
+    uint16_t voltage;           // mV, k_voltage_min_searching while probing
+};
+
+// Stored before the first probe, a search that never finished, e.g. because
+// a probe reset the board, is not repeated at the next start
+static constexpr uint16_t k_voltage_min_searching = 0;
+
+/**
+ * @brief Source seen before, recognized by its raw power capabilities
+ */
+struct KnownSource {
+    uint32_t fingerprint;
+    uint32_t sequence;   // the highest one is used last, 0 if free
+};
+
+/**
+ * @brief UI state restored after a restart
+ */
+struct UiPreferences {
+    uint8_t view;
+    uint8_t sensor_profile;
+    uint8_t is_voltage_trim_enabled;
+};
+
+static auto readSetpoint(const SettingsStore& settings, uint16_t key,
+                         const IPdSink::Pdo& pdo, Setpoint& setpoint) -> bool {
+    return settings.read(key, setpoint) &&
+           setpoint.pdo_fingerprint == getPdoFingerprint(pdo);
+}
 
 inline auto operator++(MainScreenSelection& selection) -> MainScreenSelection& {
     using T = std::underlying_type_t<MainScreenSelection>;
@@ -49,7 +108,25 @@ static auto adjustAndClamp(uint16_t& value, uint16_t step, uint16_t min_val,
         result, static_cast<int32_t>(min_val), static_cast<int32_t>(max_val)));
 }
 
+// Round to the nearest whole step of the source, a step of 0 keeps the value
+static auto roundToStep(int32_t value, uint16_t step, uint16_t min_val,
+                        uint16_t max_val) -> uint16_t {
+    if (step > 0) {
+        value = ((value + (step / 2)) / step) * step;
+    }
+    return static_cast<uint16_t>(std::clamp(
+        value, static_cast<int32_t>(min_val), static_cast<int32_t>(max_val)));
+}
+
 StateMachine::StateMachine(HardwareContext& hardware) : m_hw(hardware) {
+    UiPreferences preferences{};
+    if (m_hw.settings.read(k_settings_key_ui, preferences) &&
+        preferences.sensor_profile <
+            static_cast<uint8_t>(Ina226::Profile::Count)) {
+        m_hw.sensor.setProfile(
+            static_cast<Ina226::Profile>(preferences.sensor_profile));
+        m_is_voltage_trim_enabled = preferences.is_voltage_trim_enabled != 0;
+    }
     renderUI();
 }
 
@@ -69,8 +146,7 @@ auto StateMachine::handleEvent(InitState& state, const SystemTickEvent& event)
         state.transition_time += event.delta;
         if (state.transition_time >= k_state_transition_period) {
             insertConfig(ConfigBuilder::buildDefault());
-            m_current_state = MainStateBuilder::buildFromConfig(m_configs[0]);
-            ;
+            emplaceMainState(m_configs[0]);
         }
     }
     renderUI();
@@ -88,6 +164,7 @@ auto StateMachine::handleEvent(LoadingState& state,
     if (!state.are_pdos_loaded) {
         state.are_pdos_loaded = true;
         state.pdo_count = m_hw.pdsink.getPDSourcePowerCapabilities();
+        m_source_fingerprint = m_hw.pdsink.getSourceFingerprint();
         for (auto i = 0; i < state.pdo_count; ++i) {
             IPdSink::Pdo pdo;
             if (m_hw.pdsink.getPdo(i, pdo) &&
@@ -97,35 +174,59 @@ auto StateMachine::handleEvent(LoadingState& state,
             }
         }
         state.screen.setPdoProfileCount(state.pdo_count);
+        searchVoltageMin(state, 0);
+    } else if (state.search_config < k_max_configs) {
+        state.search_time += event.delta;
+        if (state.search_time >= k_voltage_min_search_period) {
+            finishVoltageMinSearch(state, false);
+        }
+    } else if (auto* source_config = findSourceConfig();
+               source_config != nullptr) {
+        // A source seen before goes straight back to the PDO used last on
+        // it, the output stays off
+        enterMainState(*source_config);
     } else {
         state.transition_time += event.delta;
         if (state.transition_time >= k_state_transition_period) {
+            // Skip the menu if there is nothing to choose or if the source
+            // still offers the PDO used last time, the output stays off
+            auto* last_config = findLastConfig();
             if (state.pdo_count == 1) {
-                auto next_state =
-                    MainStateBuilder::buildFromConfig(m_configs[0]);
-                m_hw.pdsink.setPdoOutput(next_state.config.pdo.index,
-                                         next_state.user_voltage,
-                                         next_state.user_current);
-                m_current_state = next_state;
+                enterMainState(m_configs[0]);
+            } else if (last_config != nullptr) {
+                enterMainState(*last_config);
             } else {
-                m_current_state =
-                    MenuStateBuilder::build(getActiveConfigs(), 0);
+                enterMenuState(0);
             }
         }
     }
     renderUI();
 }
 
+auto StateMachine::handleEvent(LoadingState& state,
+                               const PdRequestStatusEvent& event) -> void {
+    if (state.search_config >= k_max_configs || event.request != state.probe) {
+        return;
+    }
+    if (event.result == IPdSink::RequestResult::Timeout) {
+        finishVoltageMinSearch(state, false);
+        return;
+    }
+    state.voltage_min_search.addResult(event.result ==
+                                       IPdSink::RequestResult::Accepted);
+    if (state.voltage_min_search.isDone()) {
+        finishVoltageMinSearch(state, true);
+        return;
+    }
+    state.probe.voltage = state.voltage_min_search.getProbeVoltage();
+    m_hw.pd_requests.submit(state.probe);
+}
+
 auto StateMachine::handleEvent(MenuState& state,
                                const RotaryEncoderEvent& event) -> void {
     // Handle encoder states
     if (event.encoder_state == RotaryEncoder::State::btn_short_press) {
-        auto next_state = MainStateBuilder::MainStateBuilder::buildFromConfig(
-            m_configs[state.screen.getSelectedMenuItem()]);
-        m_hw.pdsink.setPdoOutput(next_state.config.pdo.index,
-                                 next_state.user_voltage,
-                                 next_state.user_current);
-        m_current_state = next_state;
+        enterMainState(m_configs[state.screen.getSelectedMenuItem()]);
     }
     // Update selected menu item based on encoder direction
     if (event.encoder_state == RotaryEncoder::State::rot_inc) {
@@ -153,6 +254,12 @@ auto StateMachine::handleEvent(MainState& state, const SystemTickEvent& event)
     state.screen.selectTargetVoltage(highlight_voltage)
         .selectTargetCurrent(highlight_current);
     state.handleFaultRecovery(m_hw);
+    // The view and the profile are saved once the encoder rests, not on
+    // every detent
+    if (state.is_ui_preferences_pending &&
+        state.ui_preferences_time >= k_ui_preferences_delay) {
+        saveUiPreferences();
+    }
     // Update screen with sensor data periodically
     if (state.sensor_update_time >= k_sensor_update_period) {
         state.sensor_update_time = 0;
@@ -160,7 +267,6 @@ auto StateMachine::handleEvent(MainState& state, const SystemTickEvent& event)
         state.screen.setMeasuredCurrent(state.measured_current);
         state.screen.setTemperature(state.measured_temperature);
     }
-    state.handleShortCircuitDetection(m_hw);
     // Update UI periodically
     if (state.ui_refresh_time >= k_ui_refresh_period) {
         state.ui_refresh_time = 0;
@@ -170,14 +276,48 @@ auto StateMachine::handleEvent(MainState& state, const SystemTickEvent& event)
 
 auto StateMachine::handleEvent(MainState& state,
                                const RotaryEncoderEvent& event) -> void {
+    // In the other views only the output toggle and switching the view work
+    // as usual. On the chart the rotation selects the acquisition profile.
+    if (state.view != MainView::Main) {
+        switch (event.encoder_state) {
+        case RotaryEncoder::State::rot_inc:
+        case RotaryEncoder::State::rot_dec: {
+            if (state.view != MainView::Chart) {
+                return;
+            }
+            constexpr auto k_count =
+                static_cast<uint8_t>(Ina226::Profile::Count);
+            uint8_t step =
+                (event.encoder_state == RotaryEncoder::State::rot_inc)
+                    ? 1
+                    : k_count - 1;
+            auto profile = static_cast<uint8_t>(m_hw.sensor.getProfile());
+            m_hw.sensor.setProfile(
+                static_cast<Ina226::Profile>((profile + step) % k_count));
+            state.chart_screen.setProfileName(
+                Ina226::getProfileName(m_hw.sensor.getProfile()));
+            state.deferUiPreferences();
+            renderUI();
+            return;
+        }
+        case RotaryEncoder::State::btn_long_press:
+        case RotaryEncoder::State::rot_dec_while_btn_press:
+        case RotaryEncoder::State::rot_inc_while_btn_press:
+            break;
+        default:
+            return;
+        }
+    }
     switch (event.encoder_state) {
     case RotaryEncoder::State::btn_short_press:
         if (state.selection > None) {
             // if tv or tc is selected enter editing mode of the value
             if (state.is_editing) {
-                m_hw.pdsink.setPdoOutput(state.config.pdo.index,
-                                         state.user_voltage,
-                                         state.user_current);
+                // While the current is limited the regulator keeps the
+                // lowered voltage below the new setpoint
+                state.updateTargets();
+                state.requestOutput(m_hw);
+                saveSetpoint(state);
             }
             state.is_editing = !state.is_editing;
         } else {
@@ -188,10 +328,11 @@ auto StateMachine::handleEvent(MainState& state,
                 break;
             }
             if (state.rotary_encoder_time <= k_double_click_period) {
-                // Switch to menu state
-                MenuScreen menu_screen{k_menu_title};
-                m_current_state = MenuStateBuilder::build(
-                    getActiveConfigs(), state.config.pdo.index);
+                // Switch to menu state, a change of the view is kept
+                if (state.is_ui_preferences_pending) {
+                    saveUiPreferences();
+                }
+                enterMenuState(state.config.pdo.index);
                 renderUI();
                 return;
             }
@@ -206,9 +347,6 @@ auto StateMachine::handleEvent(MainState& state,
         }
         // toggle output enable
         state.setOutputEnable(m_hw, !state.output_enable);
-        // reset ramp up timer to ignore checking for SCP for some time
-        // while the output voltage is rising
-        state.ramp_up_time = 0;
         break;
     case RotaryEncoder::State::rot_inc:
     case RotaryEncoder::State::rot_dec: {
@@ -260,20 +398,84 @@ auto StateMachine::handleEvent(MainState& state,
     }
     case RotaryEncoder::State::rot_dec_while_btn_press:
     case RotaryEncoder::State::rot_inc_while_btn_press:
-        // TODO implement me with constant current mode
-        // implementation...
+        // switch between the main screen, the chart and the statistics, not
+        // while editing
+        if (!state.is_editing) {
+            constexpr auto k_count = static_cast<uint8_t>(MainView::Count);
+            uint8_t step = (event.encoder_state ==
+                            RotaryEncoder::State::rot_inc_while_btn_press)
+                               ? 1
+                               : k_count - 1;
+            state.view = static_cast<MainView>(
+                (static_cast<uint8_t>(state.view) + step) % k_count);
+            state.deferUiPreferences();
+        }
         break;
     case RotaryEncoder::State::idle:
     case RotaryEncoder::State::processed:
         // do nothing
         break;
     }
+    // Show the result of the user input without waiting for the next refresh
+    renderUI();
 }
 
 auto StateMachine::handleEvent(MainState& state, const SensorUpdateEvent& event)
     -> void {
     state.measured_voltage = event.voltage;
     state.measured_current = event.current;
+    state.measured_power = event.power;
+    state.measured_time = event.timestamp;
+    state.measurements.push({.time = event.timestamp,
+                             .voltage = event.voltage,
+                             .current = event.current,
+                             .power = event.power});
+    // A step boundary may have passed since the last tick, the sample is
+    // captured for the step it was taken in
+    if (m_hw.sequencer.update(event.timestamp)) {
+        applySequencerOutput(state);
+    }
+    m_hw.sequencer.addSample(event.timestamp, event.voltage, event.current);
+    // Software fallback of the sensor alert, also catches the over-current
+    // when the ALERT pin is not wired
+    if (m_ocp_limit > 0 && state.output_enable &&
+        event.current >= m_ocp_limit) {
+        state.setOutputEnable(m_hw, false);
+    }
+    state.handleShortCircuitDetection(m_hw, event);
+    // The measured voltage only follows the trimmed request in CV
+    bool is_request_changed = false;
+    if (state.regulator.getMode() == SupplyMode::CC) {
+        state.voltage_trim.hold();
+    } else if (state.voltage_trim.addSample(event.timestamp, event.voltage)) {
+        state.updateTargets();
+        is_request_changed = true;
+    }
+    if (state.regulator.addSample(event.timestamp, event.voltage,
+                                  event.current)) {
+        is_request_changed = true;
+    }
+    if (is_request_changed) {
+        state.requestOutput(m_hw);
+    }
+    state.screen.setSupplyMode(state.regulator.getMode());
+    // The chart is fed with every sample, also while it is not visible. The
+    // sample period follows the acquisition profile.
+    state.chart_screen.setSamplePeriod(m_hw.sensor.getPollPeriod())
+        .setProfileName(Ina226::getProfileName(m_hw.sensor.getProfile()))
+        .addSample(event.voltage, event.current);
+    state.energy_meter.addSample(event.timestamp, event.power_micro,
+                                 event.current_micro);
+    state.statistics_screen.setEnergy(state.energy_meter.getEnergy())
+        .setCharge(state.energy_meter.getCharge())
+        .setElapsedTime(
+            static_cast<uint32_t>(state.energy_meter.getElapsedTime() /
+                                  k_microseconds_per_second))
+        .setRunning(state.energy_meter.isRunning());
+}
+
+auto StateMachine::handleEvent(MainState& state,
+                               const TemperatureUpdateEvent& event) -> void {
     state.measured_temperature = event.temperature;
 }
 
@@ -285,28 +487,672 @@ auto StateMachine::handleEvent(MainState& state,
     }
 }
 
+auto StateMachine::handleEvent(MainState& state,
+                               const PdRequestStatusEvent& event) -> void {
+    // Outcomes of requests for another PDO are left over from the menu
+    if (event.request.index != state.config.pdo.index) {
+        return;
+    }
+    // A rejected or unanswered setpoint is requested again by the fault
+    // recovery, the output does not match it
+    state.is_request_rejected =
+        event.result != IPdSink::RequestResult::Accepted;
+    if (state.is_request_rejected) {
+        state.fault_recovery_time = 0;
+    }
+}
+
 auto StateMachine::handleEvent(MainState& state, const VoutStatusUpdateEvent&)
     -> void {
     state.setOutputEnable(m_hw, false);
 }
 
-auto StateMachine::MenuStateBuilder::build(std::span<const Config> configs,
-                                           uint8_t selected_item) -> MenuState {
-    MenuScreen menu_screen{k_menu_title};
-    menu_screen.setConfig(configs).selectMenuItem(selected_item);
-    return MenuState{.screen = menu_screen};
+auto StateMachine::handleEvent(MainState& state, const OverCurrentEvent&)
+    -> void {
+    // The output has already been cut by the interrupt handler, keep the
+    // state in sync
+    state.setOutputEnable(m_hw, false);
+}
+
+// The software fallback compares the current register, a limit beyond its
+// range would never trip
+auto StateMachine::setOcpLimit(int32_t current) -> void {
+    m_ocp_limit = std::clamp<int32_t>(current, 0,
+                                      m_hw.sensor.getCurrentRange());
+    m_hw.sensor.setOverCurrentLimit(m_ocp_limit);
+}
+
+auto StateMachine::searchVoltageMin(LoadingState& state, size_t first_config)
+    -> void {
+    // Probe the lowest voltage of every PDO that only reports a range, the
+    // output is still disabled while loading
+    for (size_t i = first_config; i < m_active_config_count; ++i) {
+        auto& pdo = m_configs[i].pdo;
+        if (pdo.voltage_min_floor == 0) {
+            continue;
+        }
+        uint16_t key = k_settings_key_vmin + pdo.index;
+        VoltageMin cached{};
+        if (m_hw.settings.read(key, cached) &&
+            cached.pdo_fingerprint == getPdoFingerprint(pdo)) {
+            if (cached.voltage == k_voltage_min_searching) {
+                cached.voltage = pdo.voltage_min;
+                writeSetting(key, cached);
+            }
+            pdo.voltage_min = cached.voltage;
+            pdo.voltage_min_floor = 0;
+            continue;
+        }
+        // Without the marker the search is not safe to start, the advertised
+        // minimum is kept
+        if (!writeSetting(
+                key, VoltageMin{.pdo_fingerprint = getPdoFingerprint(pdo),
+                                .voltage = k_voltage_min_searching})) {
+            pdo.voltage_min_floor = 0;
+            continue;
+        }
+        state.search_config = i;
+        state.search_time = 0;
+        state.has_probed = true;
+        state.voltage_min_search = VoltageMinSearch{
+            pdo.voltage_min_floor, pdo.voltage_min, pdo.voltage_step};
+        state.probe = {.index = pdo.index,
+                       .voltage = state.voltage_min_search.getProbeVoltage(),
+                       .current = pdo.current_min};
+        m_hw.pd_requests.submit(state.probe);
+        return;
+    }
+    state.search_config = k_max_configs;
+    // Return to the default contract of the source after probing
+    if (state.has_probed) {
+        const auto& pdo = m_configs[0].pdo;
+        m_hw.pd_requests.submit({.index = pdo.index,
+                                 .voltage = pdo.voltage_min,
+                                 .current = pdo.current_min});
+    }
+}
+
+auto StateMachine::finishVoltageMinSearch(LoadingState& state, bool is_found)
+    -> void {
+    // A failed search stores the advertised minimum, it is not repeated
+    auto& pdo = m_configs[state.search_config].pdo;
+    uint16_t voltage_min = is_found ? state.voltage_min_search.getVoltageMin()
+                                    : pdo.voltage_min;
+    writeSetting(k_settings_key_vmin + pdo.index,
+                 VoltageMin{.pdo_fingerprint = getPdoFingerprint(pdo),
+                            .voltage = voltage_min});
+    pdo.voltage_min = voltage_min;
+    pdo.voltage_min_floor = 0;
+    searchVoltageMin(state, state.search_config + 1);
+}
+
+auto StateMachine::handleCalibration(const CalibrationEvent& event) -> void {
+    using Action = CalibrationEvent::Action;
+    auto& session = m_calibration;
+    // Captures and saves need a session, a save two captures of a quantity
+    session.is_failed = !session.is_active && event.action != Action::Start &&
+                        event.action != Action::Reset;
+    switch (event.action) {
+    case Action::Start:
+        // Capture uncorrected readings, the stored correction is kept until
+        // the new one is saved
+        if (!session.is_active) {
+            session.stored = m_hw.sensor.getCalibration();
+        }
+        session.voltage = {};
+        session.current = {};
+        session.is_active = true;
+        m_hw.sensor.setCalibration({});
+        break;
+    case Action::CaptureVoltage:
+        if (session.is_active) {
+            session.voltage.add({.measured = m_hw.sensor.getBusVoltageMicro(),
+                                 .reference = event.reference});
+        }
+        break;
+    case Action::CaptureCurrent:
+        if (session.is_active) {
+            session.current.add({.measured = m_hw.sensor.getCurrentMicro(),
+                                 .reference = event.reference});
+        }
+        break;
+    case Action::Save:
+        if (session.is_active && !saveCalibration()) {
+            m_hw.sensor.setCalibration(session.stored);
+            session.is_failed = true;
+        }
+        session.is_active = false;
+        break;
+    case Action::Cancel:
+        if (session.is_active) {
+            m_hw.sensor.setCalibration(session.stored);
+        }
+        session.is_active = false;
+        break;
+    case Action::Reset:
+        session.is_active = false;
+        m_hw.sensor.setCalibration({});
+        session.is_failed = !m_hw.calibration_store.save({});
+        break;
+    }
+    // The alert limit is programmed as an uncorrected shunt voltage
+    setOcpLimit(m_ocp_limit);
+}
+
+auto StateMachine::saveCalibration() -> bool {
+    // A quantity without two valid captures keeps its stored correction
+    auto calibration = m_calibration.stored;
+    bool is_voltage_valid =
+        m_calibration.voltage.getCorrection(calibration.voltage);
+    bool is_current_valid =
+        m_calibration.current.getCorrection(calibration.current);
+    if (!is_voltage_valid && !is_current_valid) {
+        return false;
+    }
+    m_hw.sensor.setCalibration(calibration);
+    return m_hw.calibration_store.save(calibration);
+}
+
+auto StateMachine::handleSequencer(const SequencerEvent& event) -> void {
+    using Action = SequencerEvent::Action;
+    auto& sequencer = m_hw.sequencer;
+    switch (event.action) {
+    case Action::Clear:
+        sequencer.clear();
+        break;
+    case Action::AddStep:
+        sequencer.addStep(event.step);
+        break;
+    case Action::SetLoopCount:
+        sequencer.setLoopCount(event.loop_count);
+        break;
+    case Action::Start:
+        // Started by the main state only
+        break;
+    case Action::Stop:
+        sequencer.stop();
+        break;
+    }
+}
+
+auto StateMachine::startSequencer(MainState& state) -> void {
+    // Only PPS can follow the steps, the output enable is left to the user
+    const auto& pdo = state.config.pdo;
+    if (pdo.type != IPdSink::PdoType::PPS) {
+        return;
+    }
+    m_hw.sequencer.setVoltageStep(pdo.voltage_step);
+    if (m_hw.sequencer.start(state.user_voltage)) {
+        state.is_editing = false;
+    }
 }
 
-auto StateMachine::MainStateBuilder::buildFromConfig(Config& config)
-    -> MainState {
-    auto main_state =
-        StateMachine::MainState{.config = config,
-                                .user_voltage = config.pdo.voltage_min,
-                                .user_current = config.pdo.current_min};
-    main_state.screen.setPdoType(config.pdo.type);
-    main_state.screen.setTargetVoltage(main_state.user_voltage);
-    main_state.screen.setTargetCurrent(main_state.user_current);
-    return main_state;
+auto StateMachine::applySequencerOutput(MainState& state) -> void {
+    // The steps are not saved as setpoints, that would wear the flash
+    const auto& pdo = state.config.pdo;
+    state.user_voltage = std::clamp(m_hw.sequencer.getVoltage(),
+                                    pdo.voltage_min, pdo.voltage_max);
+    state.user_current = std::clamp(m_hw.sequencer.getCurrent(),
+                                    pdo.current_min, pdo.current_max);
+    state.screen.setTargetVoltage(state.user_voltage)
+        .setTargetCurrent(state.user_current);
+    state.updateTargets();
+    state.requestOutput(m_hw);
+}
+
+auto StateMachine::handleEvent(MainState& state,
+                               const RemoteCommandEvent& event) -> void {
+    using Type = RemoteCommand::Type;
+    auto& reply = *event.reply;
+    const auto& values = event.command.values;
+    switch (event.command.type) {
+    case Type::MeasureVoltage:
+        reply.append(state.measured_voltage, k_remote_format);
+        break;
+    case Type::MeasureCurrent:
+        reply.append(state.measured_current, k_remote_format);
+        break;
+    case Type::MeasurePower:
+        reply.append(state.measured_power, k_remote_format);
+        break;
+    case Type::MeasureBinary: {
+        const std::array<Measurement, 1> measurement = {
+            Measurement{.time = state.measured_time,
+                        .voltage = state.measured_voltage,
+                        .current = state.measured_current,
+                        .power = state.measured_power}};
+        appendMeasurements(reply, measurement);
+        break;
+    }
+    case Type::MeasureArray: {
+        // The samples since the previous query, the oldest first
+        std::array<Measurement, k_measurement_history> measurements{};
+        size_t count = 0;
+        while (state.measurements.pop(measurements[count])) {
+            ++count;
+        }
+        appendMeasurements(reply, std::span(measurements).first(count));
+        break;
+    }
+    case Type::SetVoltage:
+        reply.setError(
+            setRemoteSetpoint(state, values[0], state.user_current));
+        break;
+    case Type::GetVoltage:
+        reply.append(state.user_voltage, k_remote_format);
+        break;
+    case Type::SetCurrent:
+        reply.setError(
+            setRemoteSetpoint(state, state.user_voltage, values[0]));
+        break;
+    case Type::GetCurrent:
+        reply.append(state.user_current, k_remote_format);
+        break;
+    case Type::SetOutput:
+        // Like the button, the output stays off until a fault is recovered
+        if (values[0] != 0 && state.is_fault_detected) {
+            reply.setError(ScpiError::SettingsConflict);
+            break;
+        }
+        state.setOutputEnable(m_hw, values[0] != 0);
+        break;
+    case Type::GetOutput:
+        reply.append(state.output_enable ? "1" : "0");
+        break;
+    case Type::ResetEnergy:
+        state.energy_meter.reset();
+        break;
+    default:
+        if (!handleRemoteCommand(event)) {
+            reply.setError(ScpiError::SettingsConflict);
+        }
+        break;
+    }
+}
+
+auto StateMachine::handleRemoteCommand(const RemoteCommandEvent& event)
+    -> bool {
+    using Type = RemoteCommand::Type;
+    auto& reply = *event.reply;
+    const auto& values = event.command.values;
+    auto& sequencer = m_hw.sequencer;
+    switch (event.command.type) {
+    case Type::ListClear:
+    case Type::ListStep:
+    case Type::ListRamp:
+    case Type::ListCount:
+    case Type::ListStart:
+    case Type::ListStop:
+        handleRemoteList(event);
+        return true;
+    case Type::CalibrationStart:
+    case Type::CalibrationVoltage:
+    case Type::CalibrationCurrent:
+    case Type::CalibrationSave:
+    case Type::CalibrationAbort:
+    case Type::CalibrationReset:
+        handleRemoteCalibration(event);
+        return true;
+    case Type::GetPdos: {
+        // Quoted and separated by commas, like "FIX 5.0V ^3.0A"
+        auto configs = getActiveConfigs();
+        for (size_t i = 0; i < configs.size(); ++i) {
+            std::array<char, 32> buffer{};
+            reply.append((i > 0) ? ",\"" : "\"")
+                .append(pdoToString(configs[i].pdo, buffer))
+                .append("\"");
+        }
+        return true;
+    }
+    case Type::SetOcpLimit:
+        if (values[0] < 0 || values[0] > m_hw.sensor.getCurrentRange()) {
+            reply.setError(ScpiError::DataOutOfRange);
+            return true;
+        }
+        dispatch(OcpLimitUpdateEvent{values[0]});
+        return true;
+    case Type::GetOcpLimit:
+        reply.append(m_ocp_limit, k_remote_format);
+        return true;
+    case Type::SetSensorProfile:
+        if (values[0] < 0 ||
+            values[0] >= static_cast<int32_t>(Ina226::Profile::Count)) {
+            reply.setError(ScpiError::DataOutOfRange);
+            return true;
+        }
+        m_hw.sensor.setProfile(static_cast<Ina226::Profile>(values[0]));
+        saveUiPreferences();
+        return true;
+    case Type::GetSensorProfile:
+        reply.append(static_cast<int32_t>(m_hw.sensor.getProfile()));
+        return true;
+    case Type::SetVoltageTrim:
+        dispatch(VoltageTrimEvent{values[0] != 0});
+        return true;
+    case Type::GetVoltageTrim:
+        reply.append(m_is_voltage_trim_enabled ? "1" : "0");
+        return true;
+    case Type::ListData: {
+        // Pass, sample count, average voltage and current and peak current
+        if (values[0] < 0 ||
+            static_cast<size_t>(values[0]) >= sequencer.getStepCount()) {
+            reply.setError(ScpiError::DataOutOfRange);
+            return true;
+        }
+        auto capture = sequencer.getCapture(static_cast<size_t>(values[0]));
+        reply.append(capture.loop)
+            .append(",")
+            .append(static_cast<int32_t>(capture.sample_count))
+            .append(",")
+            .append(capture.voltage, k_remote_format)
+            .append(",")
+            .append(capture.current, k_remote_format)
+            .append(",")
+            .append(capture.current_max, k_remote_format);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// The list commands go through the same events as any other client of the
+// sequencer, the outcome is read back from the sequencer
+auto StateMachine::handleRemoteList(const RemoteCommandEvent& event) -> void {
+    using Type = RemoteCommand::Type;
+    using Action = SequencerEvent::Action;
+    auto& reply = *event.reply;
+    const auto& values = event.command.values;
+    SequencerEvent list_event{};
+    switch (event.command.type) {
+    case Type::ListClear:
+        list_event.action = Action::Clear;
+        break;
+    case Type::ListStep:
+    case Type::ListRamp:
+        if (values[0] < 0 || values[0] > UINT16_MAX || values[1] < 0 ||
+            values[1] > UINT16_MAX || values[2] <= 0) {
+            reply.setError(ScpiError::DataOutOfRange);
+            return;
+        }
+        list_event.action = Action::AddStep;
+        list_event.step = {.voltage = static_cast<uint16_t>(values[0]),
+                           .current = static_cast<uint16_t>(values[1]),
+                           .duration = static_cast<uint32_t>(values[2]),
+                           .is_ramp = event.command.type == Type::ListRamp};
+        break;
+    case Type::ListCount:
+        if (values[0] < 0 || values[0] > UINT16_MAX) {
+            reply.setError(ScpiError::DataOutOfRange);
+            return;
+        }
+        list_event.action = Action::SetLoopCount;
+        list_event.loop_count = static_cast<uint16_t>(values[0]);
+        break;
+    case Type::ListStart:
+        list_event.action = Action::Start;
+        break;
+    default:
+        list_event.action = Action::Stop;
+        break;
+    }
+    size_t step_count = m_hw.sequencer.getStepCount();
+    dispatch(list_event);
+    // A full or running list rejects steps, only the main state starts it
+    bool is_rejected =
+        (list_event.action == Action::AddStep &&
+         m_hw.sequencer.getStepCount() == step_count) ||
+        (list_event.action == Action::Start && !m_hw.sequencer.isRunning());
+    if (is_rejected) {
+        reply.setError(ScpiError::SettingsConflict);
+    }
+}
+
+// The reference values are read on a meter at the output, the captures pair
+// them with the sensor readings at the time of the command
+auto StateMachine::handleRemoteCalibration(const RemoteCommandEvent& event)
+    -> void {
+    using Type = RemoteCommand::Type;
+    using Action = CalibrationEvent::Action;
+    CalibrationEvent calibration_event{.reference = event.command.values[0]};
+    switch (event.command.type) {
+    case Type::CalibrationStart:
+        calibration_event.action = Action::Start;
+        break;
+    case Type::CalibrationVoltage:
+        calibration_event.action = Action::CaptureVoltage;
+        break;
+    case Type::CalibrationCurrent:
+        calibration_event.action = Action::CaptureCurrent;
+        break;
+    case Type::CalibrationSave:
+        calibration_event.action = Action::Save;
+        break;
+    case Type::CalibrationAbort:
+        calibration_event.action = Action::Cancel;
+        break;
+    default:
+        calibration_event.action = Action::Reset;
+        break;
+    }
+    dispatch(calibration_event);
+    if (m_calibration.is_failed) {
+        event.reply->setError(ScpiError::SettingsConflict);
+    }
+}
+
+auto StateMachine::setRemoteSetpoint(MainState& state, int32_t voltage,
+                                     int32_t current) -> ScpiError {
+    const auto& pdo = state.config.pdo;
+    if (voltage < pdo.voltage_min || voltage > pdo.voltage_max ||
+        current < pdo.current_min || current > pdo.current_max) {
+        return ScpiError::DataOutOfRange;
+    }
+    // The list owns the output while it plays
+    if (m_hw.sequencer.isRunning()) {
+        return ScpiError::SettingsConflict;
+    }
+    // Remote setpoints are not saved, a script would wear the flash
+    state.user_voltage = roundToStep(voltage, pdo.voltage_step,
+                                     pdo.voltage_min, pdo.voltage_max);
+    state.user_current = roundToStep(current, pdo.current_step,
+                                     pdo.current_min, pdo.current_max);
+    state.is_editing = false;
+    state.screen.setTargetVoltage(state.user_voltage)
+        .setTargetCurrent(state.user_current);
+    state.updateTargets();
+    state.requestOutput(m_hw);
+    return ScpiError::None;
+}
+
+// The states are constructed in place, they hold the screens and do not fit
+// on the stack as temporaries
+auto StateMachine::enterMenuState(uint8_t selected_item) -> void {
+    auto& state = m_current_state.emplace<MenuState>();
+    state.screen.setConfig(getActiveConfigs()).selectMenuItem(selected_item);
+}
+
+auto StateMachine::MainState::initialize(const Config& pdo_config) -> void {
+    config = pdo_config;
+    user_voltage = config.pdo.voltage_min;
+    user_current = config.pdo.current_min;
+    regulator.setLimits(config.pdo.voltage_min, config.pdo.voltage_step);
+    voltage_trim.setLimits(config.pdo.voltage_max, config.pdo.voltage_step);
+    updateTargets();
+    screen.setPdoType(config.pdo.type);
+    screen.setTargetVoltage(user_voltage);
+    screen.setTargetCurrent(user_current);
+}
+
+auto StateMachine::emplaceMainState(const Config& config) -> MainState& {
+    auto& state = m_current_state.emplace<MainState>();
+    state.initialize(config);
+    state.is_voltage_trim_enabled = m_is_voltage_trim_enabled;
+    // The setpoint used last on this source comes first, another source with
+    // the same PDO may have changed the one saved for the PDO since
+    size_t slot = findSourceSlot();
+    Setpoint setpoint{};
+    if ((slot < k_max_known_sources &&
+         readSetpoint(m_hw.settings, k_settings_key_source_setpoint + slot,
+                      config.pdo, setpoint)) ||
+        readSetpoint(m_hw.settings,
+                     k_settings_key_setpoint + config.pdo.index, config.pdo,
+                     setpoint)) {
+        state.user_voltage = std::clamp(
+            setpoint.voltage, config.pdo.voltage_min, config.pdo.voltage_max);
+        state.user_current = std::clamp(
+            setpoint.current, config.pdo.current_min, config.pdo.current_max);
+        state.screen.setTargetVoltage(state.user_voltage)
+            .setTargetCurrent(state.user_current);
+        state.updateTargets();
+    }
+    UiPreferences preferences{};
+    if (m_hw.settings.read(k_settings_key_ui, preferences) &&
+        preferences.view < static_cast<uint8_t>(MainView::Count)) {
+        state.view = static_cast<MainView>(preferences.view);
+    }
+    return state;
+}
+
+auto StateMachine::enterMainState(const Config& config) -> void {
+    auto& state = emplaceMainState(config);
+    state.requestOutput(m_hw);
+    writeSetting(k_settings_key_last_pdo, getPdoFingerprint(config.pdo));
+    saveSource(state);
+}
+
+auto StateMachine::findLastConfig() -> Config* {
+    uint32_t fingerprint = 0;
+    if (!m_hw.settings.read(k_settings_key_last_pdo, fingerprint)) {
+        return nullptr;
+    }
+    return findConfig(fingerprint);
+}
+
+auto StateMachine::findSourceConfig() -> Config* {
+    size_t slot = findSourceSlot();
+    Setpoint setpoint{};
+    if (slot >= k_max_known_sources ||
+        !m_hw.settings.read(k_settings_key_source_setpoint + slot, setpoint)) {
+        return nullptr;
+    }
+    return findConfig(setpoint.pdo_fingerprint);
+}
+
+auto StateMachine::findConfig(uint32_t fingerprint) -> Config* {
+    for (size_t i = 0; i < m_active_config_count; ++i) {
+        if (getPdoFingerprint(m_configs[i].pdo) == fingerprint) {
+            return &m_configs[i];
+        }
+    }
+    return nullptr;
+}
+
+auto StateMachine::findSourceSlot() const -> size_t {
+    if (m_source_fingerprint == 0) {
+        return k_max_known_sources;
+    }
+    for (size_t slot = 0; slot < k_max_known_sources; ++slot) {
+        KnownSource source{};
+        if (m_hw.settings.read(k_settings_key_source + slot, source) &&
+            source.fingerprint == m_source_fingerprint) {
+            return slot;
+        }
+    }
+    return k_max_known_sources;
+}
+
+auto StateMachine::saveSetpoint(const MainState& state) -> void {
+    const auto& pdo = state.config.pdo;
+    writeSetting(k_settings_key_setpoint + pdo.index,
+                 Setpoint{.pdo_fingerprint = getPdoFingerprint(pdo),
+                          .voltage = state.user_voltage,
+                          .current = state.user_current});
+    saveSource(state);
+}
+
+auto StateMachine::saveSource(const MainState& state) -> void {
+    if (m_source_fingerprint == 0) {
+        return;
+    }
+    // Find the slot of the source, a new one takes the least recently used
+    size_t slot = findSourceSlot();
+    size_t oldest_slot = 0;
+    uint32_t oldest = UINT32_MAX;
+    uint32_t newest = 0;
+    uint32_t sequence = 0;
+    for (size_t i = 0; i < k_max_known_sources; ++i) {
+        KnownSource source{};
+        m_hw.settings.read(k_settings_key_source + i, source);
+        newest = std::max(newest, source.sequence);
+        if (source.sequence < oldest) {
+            oldest = source.sequence;
+            oldest_slot = i;
+        }
+        if (i == slot) {
+            sequence = source.sequence;
+        }
+    }
+    if (slot >= k_max_known_sources) {
+        slot = oldest_slot;
+    }
+    // Nothing is written again while the same source stays the latest one
+    if (sequence != newest || sequence == 0) {
+        sequence = newest + 1;
+    }
+    // The setpoint goes first, a source without it is never restored
+    const auto& pdo = state.config.pdo;
+    writeSetting(k_settings_key_source_setpoint + slot,
+                 Setpoint{.pdo_fingerprint = getPdoFingerprint(pdo),
+                          .voltage = state.user_voltage,
+                          .current = state.user_current});
+    writeSetting(
+        k_settings_key_source + slot,
+        KnownSource{.fingerprint = m_source_fingerprint, .sequence = sequence});
+}
+
+auto StateMachine::appendMeasurements(RemoteReply& reply,
+                                      std::span<const Measurement> measurements)
+    -> void {
+    // Timestamp in us, voltage in mV, current in mA and power in mW of every
+    // sample, little endian
+    static constexpr size_t k_record_size = 4 * sizeof(uint32_t);
+    std::array<uint8_t, k_measurement_history * k_record_size> block{};
+    size_t size = 0;
+    for (const auto& measurement : measurements.first(
+             std::min(measurements.size(), k_measurement_history))) {
+        const std::array<uint32_t, 4> fields = {
+            measurement.time, static_cast<uint32_t>(measurement.voltage),
+            static_cast<uint32_t>(measurement.current),
+            static_cast<uint32_t>(measurement.power)};
+        for (size_t i = 0; i < k_record_size; ++i) {
+            block[size++] =
+                static_cast<uint8_t>(fields[i / 4] >> (8 * (i % 4)));
+        }
+    }
+    reply.appendBlock(std::span(block).first(size));
+}
+
+template <typename T>
+auto StateMachine::writeSetting(uint16_t key, const T& value) -> bool {
+    if (m_hw.settings.write(key, value)) {
+        return true;
+    }
+    ++m_settings_failure_count;
+    return false;
+}
+
+auto StateMachine::saveUiPreferences() -> void {
+    // Outside of the main state the view saved last is kept
+    UiPreferences preferences{};
+    m_hw.settings.read(k_settings_key_ui, preferences);
+    if (auto* state = std::get_if<MainState>(&m_current_state)) {
+        preferences.view = static_cast<uint8_t>(state->view);
+        state->is_ui_preferences_pending = false;
+    }
+    preferences.sensor_profile = static_cast<uint8_t>(m_hw.sensor.getProfile());
+    preferences.is_voltage_trim_enabled = m_is_voltage_trim_enabled ? 1 : 0;
+    writeSetting(k_settings_key_ui, preferences);
 }
 
 auto StateMachine::MainState::updateStateTimers(const SystemTickEvent& event)
@@ -314,37 +1160,43 @@ auto StateMachine::MainState::updateStateTimers(const SystemTickEvent& event)
     blinking_time += event.delta;
     rotary_encoder_time += event.delta;
     ui_refresh_time += event.delta;
+    ui_preferences_time += event.delta;
     fault_recovery_time += event.delta;
-    ramp_up_time += event.delta;
     sensor_update_time += event.delta;
 }
 
+auto StateMachine::MainState::deferUiPreferences() -> void {
+    is_ui_preferences_pending = true;
+    ui_preferences_time = 0;
+}
+
 auto StateMachine::MainState::handleFaultRecovery(const HardwareContext& hw)
     -> void {
-    if (is_fault_detected && fault_recovery_time >= k_fault_recovery_period) {
-        fault_recovery_time = 0;
+    if ((!is_fault_detected && !is_request_rejected) ||
+        fault_recovery_time < k_fault_recovery_period) {
+        return;
+    }
+    fault_recovery_time = 0;
+    if (is_fault_detected) {
         if (!hw.pdsink.getStatus().has_fault) {
             // Fault is cleared, re negotiate the selected power profile
             is_fault_detected = false;
-            hw.pdsink.setPdoOutput(config.pdo.index, user_voltage,
-                                   user_current);
+            requestOutput(hw);
         }
+    } else if (!hw.pd_requests.isBusy()) {
+        // The source did not take the last setpoint, ask again
+        is_request_rejected = false;
+        requestOutput(hw);
     }
 }
 
 auto StateMachine::MainState::handleShortCircuitDetection(
-    const HardwareContext& hw) -> void {
-    // Handle when the LM73100 turns off the output due to a short circuit
-    // Ramp up time can be high (couple hundered ms), it is used to update UI
-    // and mark output as disabled. LM73100 immediately turns off output after
-    // short circuit is detected.
-    if (ramp_up_time >= k_ramp_up_period && output_enable &&
-        measured_voltage < k_low_voltage_threshold) {
-        ++low_voltage_reading_count;
-        if (low_voltage_reading_count >= k_low_voltage_reading_count) {
-            setOutputEnable(hw, false);
-            low_voltage_reading_count = 0;
-        }
+    const HardwareContext& hw, const SensorUpdateEvent& event) -> void {
+    // Handle when the LM73100 turns off the output due to a short circuit.
+    // LM73100 immediately turns off output after short circuit is detected,
+    // the detector is used to update UI and mark output as disabled.
+    if (short_circuit_detector.addSample(event.timestamp, event.voltage)) {
+        setOutputEnable(hw, false);
     }
 }
 
@@ -356,13 +1208,102 @@ auto StateMachine::MainState::setOutputEnable(const HardwareContext& hw,
     output_enable = enable;
     hw.output_enable.write(output_enable);
     screen.setOutputEnable(output_enable);
+    // The energy and charge count per output enable session, they are kept
+    // on the screen after the output is disabled
+    if (output_enable) {
+        energy_meter.reset();
+        energy_meter.start();
+        short_circuit_detector.arm();
+        // Only PPS can be requested in steps fine enough to regulate the
+        // current, the other profiles stay in CV
+        if (config.pdo.type == IPdSink::PdoType::PPS) {
+            regulator.start();
+            if (is_voltage_trim_enabled) {
+                voltage_trim.start();
+            }
+        }
+    } else {
+        energy_meter.stop();
+        short_circuit_detector.disarm();
+        // Return to the voltage setpoint if the current was limited or the
+        // voltage trimmed, the next load may not need it
+        bool is_adjusted = regulator.getRequestVoltage() != user_voltage;
+        regulator.stop();
+        voltage_trim.stop();
+        updateTargets();
+        screen.setSupplyMode(regulator.getMode());
+        if (is_adjusted) {
+            requestOutput(hw);
+        }
+    }
+}
+
+auto StateMachine::MainState::setVoltageTrim(const HardwareContext& hw,
+                                             bool enable) -> void {
+    if (is_voltage_trim_enabled == enable) {
+        return;
+    }
+    is_voltage_trim_enabled = enable;
+    if (!regulator.isRunning()) {
+        return;
+    }
+    if (enable) {
+        voltage_trim.start();
+    } else {
+        voltage_trim.stop();
+        updateTargets();
+        requestOutput(hw);
+    }
+}
+
+auto StateMachine::MainState::updateTargets() -> void {
+    // The trimmed voltage is the CV target and the CC limit of the regulator
+    voltage_trim.setTarget(user_voltage);
+    regulator.setTarget(voltage_trim.getRequestVoltage(), user_current);
+}
+
+auto StateMachine::MainState::requestOutput(const HardwareContext& hw)
+    -> void {
+    hw.pd_requests.submit({.index = config.pdo.index,
+                           .voltage = regulator.getRequestVoltage(),
+                           .current = user_current});
+}
+
+auto StateMachine::flushUI() -> void {
+    m_hw.oled.flush();
+    if (m_is_ui_render_pending && !m_hw.oled.isBusy()) {
+        renderUI();
+    }
 }
 
 auto StateMachine::renderUI() -> void {
     auto& current_screen = std::visit(
-        [](auto& state) -> Screen& { return state.screen; }, m_current_state);
+        [](auto& state) -> Screen& {
+            if constexpr (requires { state.getScreen(); }) {
+                return state.getScreen();
+            } else {
+                return state.screen;
+            }
+        },
+        m_current_state);
+
+    // Nothing changed since the last frame, skip building and sending it
+    if (current_screen.getGeneration() == m_rendered_generation) {
+        m_is_ui_render_pending = false;
+        ++m_render_statistics.skipped_frames;
+        return;
+    }
+    // The previous frame is still being sent, do not build a new one now.
+    // It is rendered by flushUI() as soon as the display is free.
+    if (m_hw.oled.isBusy()) {
+        m_is_ui_render_pending = true;
+        return;
+    }
+    m_is_ui_render_pending = false;
 
-    m_hw.oled.display(current_screen.build());
+    m_hw.oled.submit(current_screen.build());
+    m_rendered_generation = current_screen.getGeneration();
+    ++m_render_statistics.rendered_frames;
 }
 
 auto StateMachine::insertConfig(const Config& config) -> bool {
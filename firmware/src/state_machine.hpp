@@ -1,23 +1,46 @@
 #ifndef state_machine_hpp
 #define state_machine_hpp
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <span>
+#include <string_view>
+#include <type_traits>
 #include <variant>
 
+#include "chart_screen.hpp"
 #include "config.hpp"
+#include "current_regulator.hpp"
+#include "energy_meter.hpp"
 #include "event.hpp"
+#include "hardware_context.hpp"
 #include "loading_screen.hpp"
 #include "main_screen.hpp"
 #include "menu_screen.hpp"
+#include "ring_fifo.hpp"
+#include "short_circuit_detector.hpp"
+#include "statistics_screen.hpp"
+#include "voltage_min_search.hpp"
+#include "voltage_trim.hpp"
 
 constexpr size_t k_max_configs = 16;
 
 enum MainScreenSelection { None, Voltage, Current, Count };   // FIXME
 
+// Views of the main state, switched by pressing and turning the encoder
+enum class MainView : uint8_t { Main, Chart, Statistics, Count };
+
 class StateMachine {
   public:
+    /**
+     * @brief Counters of UI frames
+     */
+    struct RenderStatistics {
+        uint32_t rendered_frames{0};   // frames built and sent to the display
+        uint32_t skipped_frames{0};    // frames skipped, nothing changed
+    };
+
     /**
      * @brief Constructor
      * @param hardware The hardware context
@@ -34,7 +57,76 @@ class StateMachine {
                    m_current_state, event);
     }
 
+    /**
+     * @brief Advance the background display flush
+     *
+     * Sends at most one page of the frame that is currently being flushed and
+     * renders the UI once the display becomes free, if a render was requested
+     * while the display was busy. Call this function in a loop.
+     */
+    auto flushUI() -> void;
+
+    /**
+     * @brief Get the UI frame counters
+     *
+     * @return Number of rendered and skipped frames since start up
+     */
+    [[nodiscard]] auto getRenderStatistics() const -> RenderStatistics {
+        return m_render_statistics;
+    }
+
+    /**
+     * @brief Get the number of failed settings writes
+     *
+     * @return Writes the settings store rejected since the start
+     */
+    [[nodiscard]] auto getSettingsFailureCount() const -> uint32_t {
+        return m_settings_failure_count;
+    }
+
   private:
+    static constexpr std::string_view k_menu_title = "Available PDOs";
+    // Samples kept for MEASure:ARRay?, one block of them fills 512 bytes
+    static constexpr size_t k_measurement_history = 32;
+
+    struct Measurement {
+        uint32_t time{0};     // us
+        int32_t voltage{0};   // mV
+        int32_t current{0};   // mA
+        int32_t power{0};     // mW
+    };
+
+    struct CalibrationPoint {
+        int32_t measured{0};
+        int32_t reference{0};
+    };
+
+    // Last two captures of one quantity, older ones are dropped
+    struct CalibrationPoints {
+        std::array<CalibrationPoint, 2> points{};
+        uint8_t count{0};
+
+        auto add(const CalibrationPoint& point) -> void {
+            points[0] = points[1];
+            points[1] = point;
+            count = std::min<uint8_t>(count + 1, points.size());
+        }
+        auto getCorrection(LinearCorrection& correction) const -> bool {
+            return count == points.size() &&
+                   LinearCorrection::fromTwoPoints(
+                       points[0].measured, points[0].reference,
+                       points[1].measured, points[1].reference, correction);
+        }
+    };
+
+    struct CalibrationSession {
+        Ina226::Calibration stored{};
+        CalibrationPoints voltage{};
+        CalibrationPoints current{};
+        bool is_active{false};
+        bool is_failed{false};   // the last action was rejected
+    };
+
     struct InitState {
         LoadingScreen screen;
         uint8_t retry_count{0};
@@ -47,20 +139,29 @@ class StateMachine {
         bool are_pdos_loaded{false};
         uint8_t pdo_count{0};
         uint32_t transition_time{0};
+        // Config whose lowest voltage is probed, k_max_configs if none
+        size_t search_config{k_max_configs};
+        VoltageMinSearch voltage_min_search{};
+        PdRequestQueue::Request probe{};
+        uint32_t search_time{0};
+        bool has_probed{false};
     };
 
     struct MenuState {
-        MenuScreen screen;
-    };
-
-    struct MenuStateBuilder {
-        static auto build(std::span<const Config> configs,
-                          uint8_t selected_item) -> MenuState;
+        MenuScreen screen{k_menu_title};
     };
 
     struct MainState {
         Config config;
         MainScreen screen{};
+        ChartScreen chart_screen{};
+        StatisticsScreen statistics_screen{};
+        MainView view{MainView::Main};
+        EnergyMeter energy_meter{};
+        ShortCircuitDetector short_circuit_detector{};
+        CurrentRegulator regulator{};
+        VoltageTrim voltage_trim{};
+        bool is_voltage_trim_enabled{false};
         bool is_editing{false};
         uint32_t blinking_time{0};
         bool blinking_state{false};
@@ -68,25 +169,43 @@ class StateMachine {
         bool output_enable{false};
         uint32_t rotary_encoder_time{0};
         uint32_t ui_refresh_time{0};
+        // View or acquisition profile changed, saved once the encoder rests
+        bool is_ui_preferences_pending{false};
+        uint32_t ui_preferences_time{0};
         uint16_t user_voltage{0};
         uint16_t user_current{0};
         bool is_fault_detected{false};
+        bool is_request_rejected{false};
         uint32_t fault_recovery_time{0};
-        float measured_voltage{0.0F};
-        float measured_current{0.0F};
+        int32_t measured_voltage{0};   // mV
+        int32_t measured_current{0};   // mA
+        int32_t measured_power{0};     // mW
+        uint32_t measured_time{0};     // us, timestamp of the sample
+        RingFifo<Measurement, k_measurement_history> measurements{};
         uint8_t measured_temperature{0};
         uint32_t sensor_update_time{0};
-        uint32_t ramp_up_time{0};
-        uint32_t low_voltage_reading_count{0};
 
+        auto initialize(const Config& pdo_config) -> void;
+        auto getScreen() -> Screen& {
+            switch (view) {
+            case MainView::Chart:
+                return chart_screen;
+            case MainView::Statistics:
+                return statistics_screen;
+            default:
+                return screen;
+            }
+        }
         auto updateStateTimers(const SystemTickEvent& event) -> void;
+        auto deferUiPreferences() -> void;
         auto handleFaultRecovery(const HardwareContext& hw) -> void;
-        auto handleShortCircuitDetection(const HardwareContext& hw) -> void;
+        auto handleShortCircuitDetection(const HardwareContext& hw,
+                                         const SensorUpdateEvent& event)
+            -> void;
         auto setOutputEnable(const HardwareContext& hw, bool enable) -> void;
-    };
-
-    struct MainStateBuilder {
-        static auto buildFromConfig(Config& config) -> MainState;
+        auto setVoltageTrim(const HardwareContext& hw, bool enable) -> void;
+        auto updateTargets() -> void;
+        auto requestOutput(const HardwareContext& hw) -> void;
     };
 
     using State = std::variant<InitState, LoadingState, MenuState, MainState>;
@@ -96,21 +215,107 @@ class StateMachine {
         -> void;
 
     auto handleEvent(LoadingState& state, const SystemTickEvent& event) -> void;
+    auto handleEvent(LoadingState& state, const PdRequestStatusEvent& event)
+        -> void;
 
     auto handleEvent(MenuState& state, const RotaryEncoderEvent& event) -> void;
 
     auto handleEvent(MainState& state, const SystemTickEvent& event) -> void;
     auto handleEvent(MainState& state, const RotaryEncoderEvent& event) -> void;
     auto handleEvent(MainState& state, const SensorUpdateEvent& event) -> void;
+    auto handleEvent(MainState& state, const TemperatureUpdateEvent& event)
+        -> void;
     auto handleEvent(MainState& state, const PdSinkStatusUpdateEvent& event)
         -> void;
+    auto handleEvent(MainState& state, const PdRequestStatusEvent& event)
+        -> void;
     auto handleEvent(MainState& state, const VoutStatusUpdateEvent& event)
         -> void;
+    auto handleEvent(MainState& state, const OverCurrentEvent& event) -> void;
+    auto handleEvent(MainState& state, const RemoteCommandEvent& event)
+        -> void;
+
+    // The over-current limit, the voltage trim, the calibration and the
+    // sequencer list are kept across states
+    template <typename S>
+    auto handleEvent(S&, const OcpLimitUpdateEvent& event) -> void {
+        setOcpLimit(event.current);
+    }
+    template <typename S>
+    auto handleEvent(S& state, const VoltageTrimEvent& event) -> void {
+        m_is_voltage_trim_enabled = event.enable;
+        if constexpr (std::is_same_v<S, MainState>) {
+            state.setVoltageTrim(m_hw, event.enable);
+        }
+        saveUiPreferences();
+    }
+    template <typename S>
+    auto handleEvent(S&, const CalibrationEvent& event) -> void {
+        handleCalibration(event);
+    }
+    template <typename S>
+    auto handleEvent(S& state, const SequencerEvent& event) -> void {
+        handleSequencer(event);
+        if constexpr (std::is_same_v<S, MainState>) {
+            if (event.action == SequencerEvent::Action::Start) {
+                startSequencer(state);
+            }
+        }
+    }
+    // The list is only played in the main state, leaving it stops the list
+    template <typename S>
+    auto handleEvent(S& state, const SequencerTickEvent& event) -> void {
+        if (!m_hw.sequencer.isRunning()) {
+            return;
+        }
+        if constexpr (std::is_same_v<S, MainState>) {
+            if (m_hw.sequencer.update(event.timestamp)) {
+                applySequencerOutput(state);
+            }
+        } else {
+            m_hw.sequencer.stop();
+        }
+    }
+    // Remote commands that need the output fail outside of the main state
+    template <typename S>
+    auto handleEvent(S&, const RemoteCommandEvent& event) -> void {
+        if (!handleRemoteCommand(event)) {
+            event.reply->setError(ScpiError::SettingsConflict);
+        }
+    }
 
     template <typename S, typename E>
     auto handleEvent(S&, const E&) -> void {}
 
     auto renderUI() -> void;
+    auto setOcpLimit(int32_t current) -> void;
+    auto enterMenuState(uint8_t selected_item) -> void;
+    auto emplaceMainState(const Config& config) -> MainState&;
+    auto enterMainState(const Config& config) -> void;
+    auto findLastConfig() -> Config*;
+    auto findSourceConfig() -> Config*;
+    auto findConfig(uint32_t fingerprint) -> Config*;
+    auto findSourceSlot() const -> size_t;
+    auto saveSetpoint(const MainState& state) -> void;
+    auto saveSource(const MainState& state) -> void;
+    template <typename T>
+    auto writeSetting(uint16_t key, const T& value) -> bool;
+    auto saveUiPreferences() -> void;
+    auto searchVoltageMin(LoadingState& state, size_t first_config) -> void;
+    auto finishVoltageMinSearch(LoadingState& state, bool is_found) -> void;
+    auto handleCalibration(const CalibrationEvent& event) -> void;
+    auto handleSequencer(const SequencerEvent& event) -> void;
+    auto startSequencer(MainState& state) -> void;
+    auto applySequencerOutput(MainState& state) -> void;
+    auto handleRemoteCommand(const RemoteCommandEvent& event) -> bool;
+    auto handleRemoteList(const RemoteCommandEvent& event) -> void;
+    auto handleRemoteCalibration(const RemoteCommandEvent& event) -> void;
+    static auto appendMeasurements(RemoteReply& reply,
+                                   std::span<const Measurement> measurements)
+        -> void;
+    auto setRemoteSetpoint(MainState& state, int32_t voltage, int32_t current)
+        -> ScpiError;
+    auto saveCalibration() -> bool;
 
     auto insertConfig(const Config& config) -> bool;
     auto getActiveConfigs() const -> std::span<const Config>;
@@ -119,6 +324,14 @@ class StateMachine {
     State m_current_state{InitState{}};
     std::array<Config, k_max_configs> m_configs;
     size_t m_active_config_count = 0;
+    uint32_t m_source_fingerprint{0};   // raw capabilities, 0 if unknown
+    bool m_is_ui_render_pending{false};
+    uint32_t m_rendered_generation{0};
+    RenderStatistics m_render_statistics;
+    int32_t m_ocp_limit{0};   // mA, 0 if disabled
+    bool m_is_voltage_trim_enabled{false};
+    CalibrationSession m_calibration{};
+    uint32_t m_settings_failure_count{0};
 };
 
 #endif   // state_machine_hpp
@@ -1,7 +1,6 @@
 #ifndef config_hpp
 #define config_hpp
 
-#include "hardware_config.hpp"
 #include "pdsink_iface.hpp"
 
 /**
@@ -59,12 +58,4 @@ struct ConfigBuilder {
     static auto buildWithPdo(const IPdSink::Pdo& pdo) -> Config;
 };
 
-/**
- * @brief Struct containing references to hardware components
- */
-struct HardwareContext {
-    IPdSink& pdsink;
-    const GpioPin& output_enable;
-    Ssd1306_128x64& oled;
-};
 #endif   // config_hpp
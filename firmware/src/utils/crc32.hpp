@@ -0,0 +1,27 @@
+#ifndef crc32_hpp
+#define crc32_hpp
+
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief CRC-32 (IEEE 802.3), bitwise to avoid a 1 KiB table
+ *
+ * @param[in] data Data
+ * @param[in] crc CRC of the preceding data, to compute the CRC in chunks
+ * @return CRC of the data
+ */
+constexpr auto crc32(std::span<const uint8_t> data, uint32_t crc = 0)
+    -> uint32_t {
+    constexpr uint32_t k_polynomial = 0xEDB88320;
+    crc = ~crc;
+    for (auto byte : data) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1U) != 0 ? k_polynomial : 0U);
+        }
+    }
+    return ~crc;
+}
+
+#endif   // crc32_hpp
@@ -0,0 +1,261 @@
+#ifndef current_regulator_hpp
+#define current_regulator_hpp
+
+#include <algorithm>
+#include <cstdint>
+
+#include "config.hpp"
+
+/**
+ * @brief Constant current regulator driving a programmable voltage source
+ *
+ * Works like the CV/CC crossover of a lab supply. While the load draws less
+ * than the current setpoint the source is requested at the voltage setpoint
+ * (CV). Above it, a PI loop on the measured current lowers the requested
+ * voltage until the current matches the setpoint (CC), and raises it back up
+ * to the voltage setpoint once the load allows it.
+ *
+ * The loop runs in velocity form, so the output clamp is the anti-windup.
+ * The current error is converted to a voltage with an estimate of the
+ * incremental load resistance, taken from the last voltage and current
+ * changes, so the loop gain does not depend on the load. Resistive loads and
+ * diode-like loads with a steep I/V curve converge alike. Requests are
+ * quantized to the voltage step of the source and spaced by at least the
+ * request interval, the source needs time to settle to every new request.
+ */
+class CurrentRegulator {
+  public:
+    /**
+     * @brief Regulator settings
+     */
+    struct Settings {
+        int32_t kp{300};                     // per mille
+        int32_t ki{600};                     // per mille
+        uint32_t request_interval{100};      // ms
+        int32_t deadband{10};                // mA
+        int32_t default_resistance{10000};   // mOhm, before the first estimate
+        int32_t min_resistance{50};          // mOhm
+        int32_t max_resistance{100000};      // mOhm
+    };
+
+    /**
+     * @brief Constructor, uses the default settings
+     */
+    constexpr CurrentRegulator() = default;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] settings Regulator settings
+     */
+    constexpr explicit CurrentRegulator(const Settings& settings)
+        : m_settings(settings) {}
+
+    /**
+     * @brief Set the voltage range of the source
+     *
+     * @param[in] voltage_min Lowest voltage the source accepts in mV
+     * @param[in] voltage_step Voltage resolution of the source in mV
+     */
+    constexpr auto setLimits(uint16_t voltage_min, uint16_t voltage_step)
+        -> void {
+        m_voltage_min = voltage_min;
+        m_voltage_step = std::max<uint16_t>(voltage_step, 1);
+    }
+
+    /**
+     * @brief Set the voltage and the current setpoints
+     *
+     * If the regulator is not limiting the current, the requested voltage
+     * follows the voltage setpoint right away.
+     *
+     * @param[in] voltage Voltage setpoint in mV, the CV target and CC limit
+     * @param[in] current Current setpoint in mA, the CC target and CV limit
+     */
+    constexpr auto setTarget(uint16_t voltage, uint16_t current) -> void {
+        bool is_cv = m_command >= m_voltage * k_micro_per_milli;
+        m_voltage = voltage;
+        m_current = current;
+        int32_t limit = m_voltage * k_micro_per_milli;
+        m_command =
+            (!m_is_running || is_cv) ? limit : std::min(m_command, limit);
+        m_request = quantize(m_command);
+    }
+
+    /**
+     * @brief Start regulating, the first request is the voltage setpoint
+     */
+    constexpr auto start() -> void {
+        m_is_running = true;
+        m_has_reference = false;
+        m_has_previous = false;
+        m_resistance = m_settings.default_resistance;
+        m_command = m_voltage * k_micro_per_milli;
+        m_request = m_voltage;
+        m_mode = SupplyMode::CV;
+    }
+
+    /**
+     * @brief Stop regulating, the requested voltage returns to the setpoint
+     */
+    constexpr auto stop() -> void {
+        m_is_running = false;
+        m_command = m_voltage * k_micro_per_milli;
+        m_request = m_voltage;
+        m_mode = SupplyMode::CV;
+    }
+
+    /**
+     * @brief Process a sensor sample
+     *
+     * @param[in] timestamp Sample time in us, may wrap around
+     * @param[in] voltage Measured output voltage in mV
+     * @param[in] current Measured output current in mA
+     * @return True if a new voltage has to be requested, see
+     * getRequestVoltage()
+     */
+    constexpr auto addSample(uint32_t timestamp, int32_t voltage,
+                             int32_t current) -> bool {
+        if (!m_is_running) {
+            return false;
+        }
+        m_voltage_sum += voltage;
+        m_current_sum += current;
+        ++m_sample_count;
+        if (!m_has_reference) {
+            m_has_reference = true;
+            m_last_update = timestamp;
+            return false;
+        }
+        if (timestamp - m_last_update <
+            m_settings.request_interval * k_micro_per_milli) {
+            return false;
+        }
+        m_last_update = timestamp;
+        // Average the samples since the last request, the source has
+        // settled meanwhile
+        auto average_voltage =
+            static_cast<int32_t>(m_voltage_sum / m_sample_count);
+        auto average_current =
+            static_cast<int32_t>(m_current_sum / m_sample_count);
+        m_voltage_sum = 0;
+        m_current_sum = 0;
+        m_sample_count = 0;
+
+        updateResistance(average_voltage, average_current);
+        int32_t error = m_current - average_current;
+        if (error > -m_settings.deadband && error < m_settings.deadband) {
+            error = 0;
+        }
+        // per mille * mA * mOhm = nV, the command is kept in uV
+        int64_t correction =
+            (int64_t{m_settings.kp} * (error - m_previous_error) +
+             int64_t{m_settings.ki} * error) *
+            m_resistance / k_micro_per_milli;
+        m_previous_error = error;
+        int64_t limit = m_voltage * k_micro_per_milli;
+        m_command = static_cast<int32_t>(std::clamp<int64_t>(
+            m_command + correction,
+            std::min<int64_t>(m_voltage_min * k_micro_per_milli, limit),
+            limit));
+
+        bool is_limiting = m_command < limit ||
+                           average_current > m_current + m_settings.deadband;
+        m_mode = is_limiting ? SupplyMode::CC : SupplyMode::CV;
+
+        uint16_t next_request = quantize(m_command);
+        if (next_request == m_request) {
+            return false;
+        }
+        m_request = next_request;
+        return true;
+    }
+
+    /**
+     * @brief Get the operating mode
+     *
+     * @return CC while the current is limited, CV otherwise
+     */
+    [[nodiscard]] constexpr auto getMode() const -> SupplyMode {
+        return m_mode;
+    }
+
+    /**
+     * @brief Get the last requested voltage
+     *
+     * @return Voltage in mV
+     */
+    [[nodiscard]] constexpr auto getRequestVoltage() const -> uint16_t {
+        return m_request;
+    }
+
+    /**
+     * @brief Check whether the regulator is running
+     *
+     * @return True if started
+     */
+    [[nodiscard]] constexpr auto isRunning() const -> bool {
+        return m_is_running;
+    }
+
+  private:
+    static constexpr int32_t k_micro_per_milli = 1000;
+
+    // Incremental resistance from the change since the previous update, the
+    // static one until the current has moved enough
+    constexpr auto updateResistance(int32_t voltage, int32_t current) -> void {
+        if (m_has_previous) {
+            int32_t delta_current = current - m_previous_current;
+            int32_t delta_voltage = voltage - m_previous_voltage;
+            if ((delta_current >= m_settings.deadband ||
+                 delta_current <= -m_settings.deadband) &&
+                (delta_voltage > 0) == (delta_current > 0) &&
+                delta_voltage != 0) {
+                m_resistance = clampResistance(int64_t{delta_voltage} *
+                                               k_micro_per_milli /
+                                               delta_current);
+            }
+        } else if (current > m_settings.deadband) {
+            m_resistance = clampResistance(int64_t{voltage} *
+                                           k_micro_per_milli / current);
+        }
+        m_has_previous = true;
+        m_previous_voltage = voltage;
+        m_previous_current = current;
+    }
+
+    [[nodiscard]] constexpr auto clampResistance(int64_t resistance) const
+        -> int32_t {
+        return static_cast<int32_t>(std::clamp<int64_t>(
+            resistance, m_settings.min_resistance, m_settings.max_resistance));
+    }
+
+    // Round a voltage in uV to the nearest step of the source in mV
+    [[nodiscard]] constexpr auto quantize(int32_t voltage) const -> uint16_t {
+        int32_t step = m_voltage_step * k_micro_per_milli;
+        return static_cast<uint16_t>((voltage + (step / 2)) / step *
+                                     m_voltage_step);
+    }
+
+    Settings m_settings{};
+    uint16_t m_voltage_min{0};
+    uint16_t m_voltage_step{1};
+    uint16_t m_voltage{0};          // mV
+    uint16_t m_current{0};          // mA
+    int32_t m_command{0};           // uV
+    uint16_t m_request{0};          // mV
+    int32_t m_resistance{0};        // mOhm
+    int32_t m_previous_error{0};    // mA
+    int32_t m_previous_voltage{0};  // mV
+    int32_t m_previous_current{0};  // mA
+    int64_t m_voltage_sum{0};
+    int64_t m_current_sum{0};
+    uint32_t m_sample_count{0};
+    uint32_t m_last_update{0};
+    SupplyMode m_mode{SupplyMode::CV};
+    bool m_has_reference{false};
+    bool m_has_previous{false};
+    bool m_is_running{false};
+};
+
+#endif   // current_regulator_hpp
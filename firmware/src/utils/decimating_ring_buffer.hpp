@@ -0,0 +1,179 @@
+#ifndef decimating_ring_buffer_hpp
+#define decimating_ring_buffer_hpp
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed size ring buffer that reduces every `decimation` pushed samples
+ * to a single min/max bucket
+ *
+ * Keeping the extremes of every bucket instead of an average makes short
+ * transients visible even when many samples are merged. The minimum and
+ * maximum over the whole window are tracked while pushing, the window is only
+ * rescanned when the evicted bucket was holding one of the extremes.
+ *
+ * @tparam N Number of buckets in the window
+ */
+template <size_t N>
+class DecimatingRingBuffer {
+    static_assert(N > 0, "Window must not be empty");
+
+  public:
+    /**
+     * @brief Range of the samples merged into one bucket
+     */
+    struct Bucket {
+        int32_t min{0};
+        int32_t max{0};
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] decimation Number of samples merged into one bucket
+     */
+    explicit DecimatingRingBuffer(uint16_t decimation)
+        : m_decimation(std::max<uint16_t>(decimation, 1)) {}
+
+    /**
+     * @brief Push a sample
+     *
+     * @param[in] sample Sample
+     * @return True if the sample completed a bucket
+     */
+    auto push(int32_t sample) -> bool {
+        if (m_sample_count == 0) {
+            m_bucket = {.min = sample, .max = sample};
+        } else {
+            m_bucket.min = std::min(m_bucket.min, sample);
+            m_bucket.max = std::max(m_bucket.max, sample);
+        }
+        if (++m_sample_count < m_decimation) {
+            return false;
+        }
+        m_sample_count = 0;
+        insert(m_bucket);
+        return true;
+    }
+
+    /**
+     * @brief Change the number of samples merged into one bucket
+     *
+     * Buckets with a different decimation can not be mixed, the window is
+     * reset if the decimation changes.
+     *
+     * @param[in] decimation Number of samples merged into one bucket
+     */
+    auto setDecimation(uint16_t decimation) -> void {
+        decimation = std::max<uint16_t>(decimation, 1);
+        if (decimation != m_decimation) {
+            m_decimation = decimation;
+            reset();
+        }
+    }
+
+    /**
+     * @brief Get the number of samples merged into one bucket
+     *
+     * @return Decimation
+     */
+    [[nodiscard]] auto getDecimation() const -> uint16_t {
+        return m_decimation;
+    }
+
+    /**
+     * @brief Remove all buckets and the partially filled one
+     */
+    auto reset() -> void {
+        m_head = 0;
+        m_size = 0;
+        m_sample_count = 0;
+    }
+
+    /**
+     * @brief Get the number of completed buckets in the window
+     *
+     * @return Number of buckets
+     */
+    [[nodiscard]] auto size() const -> size_t { return m_size; }
+
+    /**
+     * @brief Check whether the window holds no buckets
+     *
+     * @return True if empty
+     */
+    [[nodiscard]] auto empty() const -> bool { return m_size == 0; }
+
+    /**
+     * @brief Access a bucket
+     *
+     * @param[in] index Index of the bucket, 0 is the oldest one
+     * @return Bucket
+     */
+    [[nodiscard]] auto operator[](size_t index) const -> const Bucket& {
+        return m_buckets[(m_head + N - m_size + index) % N];
+    }
+
+    /**
+     * @brief Access the newest bucket
+     *
+     * @return Bucket
+     */
+    [[nodiscard]] auto back() const -> const Bucket& {
+        return (*this)[m_size - 1];
+    }
+
+    /**
+     * @brief Get the smallest sample in the window
+     *
+     * @return Minimum
+     */
+    [[nodiscard]] auto getMin() const -> int32_t { return m_min; }
+
+    /**
+     * @brief Get the largest sample in the window
+     *
+     * @return Maximum
+     */
+    [[nodiscard]] auto getMax() const -> int32_t { return m_max; }
+
+  private:
+    auto insert(const Bucket& bucket) -> void {
+        bool is_extreme_evicted = false;
+        if (m_size == N) {
+            const auto& evicted = m_buckets[m_head];
+            is_extreme_evicted =
+                (evicted.min <= m_min) || (evicted.max >= m_max);
+        } else {
+            ++m_size;
+        }
+        m_buckets[m_head] = bucket;
+        m_head = (m_head + 1) % N;
+
+        if (m_size == 1 || is_extreme_evicted) {
+            m_min = bucket.min;
+            m_max = bucket.max;
+            for (size_t i = 0; i < m_size; ++i) {
+                m_min = std::min(m_min, (*this)[i].min);
+                m_max = std::max(m_max, (*this)[i].max);
+            }
+        } else {
+            m_min = std::min(m_min, bucket.min);
+            m_max = std::max(m_max, bucket.max);
+        }
+    }
+
+    std::array<Bucket, N> m_buckets{};
+    size_t m_head{0};
+    size_t m_size{0};
+    uint16_t m_decimation;
+    uint16_t m_sample_count{0};
+    Bucket m_bucket;
+    int32_t m_min{0};
+    int32_t m_max{0};
+};
+
+#endif   // decimating_ring_buffer_hpp
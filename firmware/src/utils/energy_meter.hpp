@@ -0,0 +1,117 @@
+#ifndef energy_meter_hpp
+#define energy_meter_hpp
+
+#include <cstdint>
+
+/**
+ * @brief Integrates power and current over time, like a USB power meter
+ *
+ * Every sample is weighted with the time since the previous sample, taken from
+ * microsecond timestamps, so irregular sample periods do not cause drift. The
+ * samples are taken in uW and uA and the integrals are kept as whole uWh/uAh
+ * plus an exact remainder, nothing is lost to rounding no matter how short the
+ * sample period is. The totals add up over every running period until
+ * reset() is called.
+ */
+class EnergyMeter {
+  public:
+    /**
+     * @brief Start or resume integrating, the totals are kept
+     *
+     * The first sample after start() only sets the time reference.
+     */
+    auto start() -> void {
+        m_is_running = true;
+        m_has_reference = false;
+    }
+
+    /**
+     * @brief Stop integrating, the totals are kept
+     */
+    auto stop() -> void { m_is_running = false; }
+
+    /**
+     * @brief Clear the totals, a running meter keeps running
+     */
+    auto reset() -> void {
+        m_energy = 0;
+        m_energy_remainder = 0;
+        m_charge = 0;
+        m_charge_remainder = 0;
+        m_elapsed_time = 0;
+    }
+
+    /**
+     * @brief Check whether the meter is running
+     *
+     * @return True if samples are integrated
+     */
+    [[nodiscard]] auto isRunning() const -> bool { return m_is_running; }
+
+    /**
+     * @brief Integrate a sample
+     *
+     * @param[in] timestamp Sample time in us, may wrap around
+     * @param[in] power Power in uW
+     * @param[in] current Current in uA
+     */
+    auto addSample(uint32_t timestamp, int32_t power, int32_t current)
+        -> void {
+        if (!m_is_running) {
+            return;
+        }
+        if (!m_has_reference) {
+            m_has_reference = true;
+            m_last_timestamp = timestamp;
+            return;
+        }
+        // The sample is the average over the time since the previous one
+        uint32_t delta = timestamp - m_last_timestamp;
+        m_last_timestamp = timestamp;
+        m_elapsed_time += delta;
+        m_energy_remainder += static_cast<int64_t>(power) * delta;
+        m_energy += m_energy_remainder / k_us_per_hour;
+        m_energy_remainder %= k_us_per_hour;
+        m_charge_remainder += static_cast<int64_t>(current) * delta;
+        m_charge += m_charge_remainder / k_us_per_hour;
+        m_charge_remainder %= k_us_per_hour;
+    }
+
+    /**
+     * @brief Get the delivered energy
+     *
+     * @return Energy in uWh
+     */
+    [[nodiscard]] auto getEnergy() const -> int64_t { return m_energy; }
+
+    /**
+     * @brief Get the delivered charge
+     *
+     * @return Charge in uAh
+     */
+    [[nodiscard]] auto getCharge() const -> int64_t { return m_charge; }
+
+    /**
+     * @brief Get the integrated time
+     *
+     * @return Elapsed time in us
+     */
+    [[nodiscard]] auto getElapsedTime() const -> uint64_t {
+        return m_elapsed_time;
+    }
+
+  private:
+    // 1 uWh = 1 uW * 3.6e9 us, the same factor holds for uAh
+    static constexpr int64_t k_us_per_hour = 3'600'000'000;
+
+    int64_t m_energy{0};             // uWh
+    int64_t m_energy_remainder{0};   // uW * us
+    int64_t m_charge{0};             // uAh
+    int64_t m_charge_remainder{0};   // uA * us
+    uint64_t m_elapsed_time{0};      // us
+    uint32_t m_last_timestamp{0};
+    bool m_has_reference{false};
+    bool m_is_running{false};
+};
+
+#endif   // energy_meter_hpp
@@ -0,0 +1,109 @@
+#ifndef flash_record_hpp
+#define flash_record_hpp
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "crc32.hpp"
+#include "flash.hpp"
+
+/**
+ * @brief Single record of plain data stored in the first sector of a flash
+ * region
+ *
+ * The record is guarded by a magic number, its size and a CRC, so an erased,
+ * partially written or outdated record is rejected instead of loaded.
+ *
+ * @tparam F Flash region type
+ * @tparam T Trivially copyable record type
+ */
+template <hal::flash::Flash F, typename T>
+class FlashRecord {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Record must be trivially copyable");
+
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param[in] flash Flash region reserved for the record
+     * @param[in] magic Identifies the record type, change it whenever the
+     * meaning of the record changes
+     */
+    constexpr FlashRecord(const F& flash, uint32_t magic)
+        : m_flash(flash), m_magic(magic) {}
+
+    /**
+     * @brief Load the record
+     *
+     * @param[out] value Record, only written if a valid record is found
+     * @return True if a valid record is found
+     */
+    auto load(T& value) const -> bool {
+        Buffer buffer{};
+        if (!m_flash.read(0, buffer)) {
+            return false;
+        }
+        Header header{};
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        if (header.magic != m_magic || header.size != sizeof(T) ||
+            header.crc != crc32(getPayload(buffer))) {
+            return false;
+        }
+        std::memcpy(&value, buffer.data() + sizeof(Header), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Store the record
+     *
+     * Nothing is written if the stored record is already equal.
+     *
+     * @param[in] value Record
+     * @return True if the record is stored
+     */
+    auto save(const T& value) const -> bool {
+        Buffer buffer{};
+        buffer.fill(0xFF);
+        std::memcpy(buffer.data() + sizeof(Header), &value, sizeof(T));
+        Header header{.magic = m_magic,
+                      .size = sizeof(T),
+                      .crc = crc32(getPayload(buffer))};
+        std::memcpy(buffer.data(), &header, sizeof(header));
+
+        Buffer stored{};
+        if (m_flash.read(0, stored) && stored == buffer) {
+            return true;
+        }
+        return m_flash.erase(0, F::getSectorSize()) &&
+               m_flash.program(0, buffer);
+    }
+
+  private:
+    struct Header {
+        uint32_t magic;
+        uint32_t size;
+        uint32_t crc;
+    };
+
+    static constexpr size_t k_record_size = sizeof(Header) + sizeof(T);
+    static constexpr size_t k_buffer_size =
+        (k_record_size + F::getPageSize() - 1) / F::getPageSize() *
+        F::getPageSize();
+    static_assert(k_buffer_size <= F::getSectorSize(),
+                  "Record must fit into one sector");
+
+    using Buffer = std::array<uint8_t, k_buffer_size>;
+
+    static auto getPayload(const Buffer& buffer) -> std::span<const uint8_t> {
+        return std::span(buffer).subspan(sizeof(Header), sizeof(T));
+    }
+
+    const F& m_flash;
+    uint32_t m_magic;
+};
+
+#endif   // flash_record_hpp
@@ -0,0 +1,71 @@
+#ifndef linear_correction_hpp
+#define linear_correction_hpp
+
+#include <cstdint>
+
+/**
+ * @brief Fixed-point gain and offset correction, y = gain * x + offset
+ *
+ * The gain is a Q2.30 number, a correction costs one 32x32 bit multiplication
+ * and a shift per sample.
+ */
+struct LinearCorrection {
+    static constexpr uint8_t k_gain_shift = 30;
+    static constexpr int32_t k_unity_gain = int32_t{1} << k_gain_shift;
+
+    int32_t gain{k_unity_gain};   // Q2.30
+    int32_t offset{0};            // in units of the corrected value
+
+    /**
+     * @brief Correct a value
+     *
+     * @param[in] value Measured value
+     * @return Corrected value, rounded to the nearest integer
+     */
+    [[nodiscard]] constexpr auto apply(int32_t value) const -> int32_t {
+        constexpr int64_t k_half = int64_t{1} << (k_gain_shift - 1);
+        auto scaled = (static_cast<int64_t>(value) * gain + k_half) >>
+                      k_gain_shift;
+        return static_cast<int32_t>(scaled + offset);
+    }
+
+    /**
+     * @brief Compute the correction from two measured points and the values
+     * shown by a reference meter
+     *
+     * @param[in] measured_a Measured value at point A
+     * @param[in] reference_a Reference value at point A
+     * @param[in] measured_b Measured value at point B
+     * @param[in] reference_b Reference value at point B
+     * @param[out] correction Computed correction
+     * @return False if the points are too close or the gain is not in the
+     * range (0, 2)
+     */
+    static constexpr auto fromTwoPoints(int32_t measured_a, int32_t reference_a,
+                                        int32_t measured_b, int32_t reference_b,
+                                        LinearCorrection& correction) -> bool {
+        int64_t measured_span = int64_t{measured_b} - measured_a;
+        int64_t reference_span = int64_t{reference_b} - reference_a;
+        if (measured_span < 0) {
+            measured_span = -measured_span;
+            reference_span = -reference_span;
+        }
+        if (measured_span == 0 || reference_span <= 0) {
+            return false;
+        }
+        // Round to nearest, the result is checked before narrowing
+        int64_t gain = ((reference_span << k_gain_shift) + measured_span / 2) /
+                       measured_span;
+        if (gain >= 2 * int64_t{k_unity_gain}) {
+            return false;
+        }
+        LinearCorrection result{.gain = static_cast<int32_t>(gain)};
+        result.offset = reference_a - result.apply(measured_a);
+        correction = result;
+        return true;
+    }
+
+    constexpr auto operator==(const LinearCorrection&) const -> bool = default;
+};
+
+#endif   // linear_correction_hpp
@@ -0,0 +1,349 @@
+#ifndef log_store_hpp
+#define log_store_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "crc32.hpp"
+#include "flash.hpp"
+
+/**
+ * @brief Wear-leveled key/value store, append-only log in a flash region
+ *
+ * Every write appends a CRC-protected record to the active sector, nothing is
+ * ever rewritten in place. When the sector is full, the latest value of every
+ * key is copied into the next sector, which becomes active once its header is
+ * programmed as the very last step. The sectors are used round robin, so the
+ * erases are spread evenly over the region.
+ *
+ * A power failure can only lose the write in progress: a torn record fails
+ * its CRC and is skipped, and an interrupted compaction leaves a sector
+ * without a valid header, the previous sector stays active.
+ *
+ * The latest values are cached in RAM, reading never touches the flash.
+ *
+ * @tparam F Flash region type, at least two sectors
+ * @tparam MaxKeys Maximum number of distinct keys
+ */
+template <hal::flash::Flash F, size_t MaxKeys = 16>
+class LogStore {
+  public:
+    static constexpr size_t k_max_value_size = 8;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] flash Flash region reserved for the store
+     * @param[in] magic Identifies the store format
+     */
+    constexpr LogStore(const F& flash, uint32_t magic)
+        : m_flash(flash), m_magic(magic) {}
+
+    /**
+     * @brief Find the active sector and load the latest values
+     *
+     * A region without any valid sector is formatted.
+     *
+     * @return True if the store is usable
+     */
+    auto mount() -> bool {
+        m_is_mounted = false;
+        m_entries = {};
+        m_sector_count = m_flash.getSize() / F::getSectorSize();
+        if (m_sector_count < 2) {
+            return false;
+        }
+        bool is_found = false;
+        for (uint32_t sector = 0; sector < m_sector_count; ++sector) {
+            SectorHeader header{};
+            if (readSectorHeader(sector, header) &&
+                (!is_found || isNewer(header.sequence, m_sequence))) {
+                is_found = true;
+                m_active_sector = sector;
+                m_sequence = header.sequence;
+            }
+        }
+        if (!is_found) {
+            m_active_sector = 0;
+            m_sequence = 0;
+            m_is_mounted = startSector(0, 1);
+            return m_is_mounted;
+        }
+        // Replay the log. A failed write can leave a blank slot before later
+        // records, so the log ends after the last programmed slot.
+        m_next_slot = 1;
+        for (uint32_t slot = 1; slot < k_slots_per_sector; ++slot) {
+            Record record{};
+            if (!readRecord(m_active_sector, slot, record)) {
+                return false;
+            }
+            if (isBlank(record)) {
+                continue;
+            }
+            m_next_slot = slot + 1;
+            if (isValid(record)) {
+                if (auto* entry = findOrAddEntry(record.key)) {
+                    *entry = {.key = record.key,
+                              .size = record.size,
+                              .value = record.value};
+                }
+            }
+        }
+        m_is_mounted = true;
+        return true;
+    }
+
+    /**
+     * @brief Read the latest value of a key
+     *
+     * @param[in] key Key, 0xFFFF is reserved
+     * @param[out] value Value, only written if the key holds a value of the
+     * same size
+     * @return True if the value is found
+     */
+    template <typename T>
+    auto read(uint16_t key, T& value) const -> bool {
+        checkValueType<T>();
+        const auto* entry = findEntry(key);
+        if (entry == nullptr || entry->size != sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, entry->value.data(), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Write a value
+     *
+     * Nothing is written if the key already holds the same value.
+     *
+     * @param[in] key Key, 0xFFFF is reserved
+     * @param[in] value Value
+     * @return True if the value is stored
+     */
+    template <typename T>
+    auto write(uint16_t key, const T& value) -> bool {
+        checkValueType<T>();
+        if (!m_is_mounted || key == k_blank_key) {
+            return false;
+        }
+        Entry update{.key = key, .size = sizeof(T)};
+        std::memcpy(update.value.data(), &value, sizeof(T));
+        auto* entry = findOrAddEntry(key);
+        if (entry == nullptr) {
+            return false;
+        }
+        if (entry->key == key && entry->size == update.size &&
+            entry->value == update.value) {
+            return true;
+        }
+        if (m_next_slot >= k_slots_per_sector) {
+            auto previous = *entry;
+            *entry = update;
+            if (!compact()) {
+                *entry = previous;
+                return false;
+            }
+            return true;
+        }
+        if (!appendRecord(m_active_sector, m_next_slot, makeRecord(update))) {
+            // The slot may be partially programmed, never reuse it
+            ++m_next_slot;
+            return false;
+        }
+        ++m_next_slot;
+        *entry = update;
+        return true;
+    }
+
+  private:
+    static constexpr uint16_t k_blank_key = 0xFFFF;
+
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t sequence;
+        uint32_t reserved;
+        uint32_t crc;
+    };
+
+    struct Record {
+        uint16_t key;
+        uint8_t size;
+        uint8_t reserved;
+        std::array<uint8_t, k_max_value_size> value;
+        uint32_t crc;
+    };
+
+    struct Entry {
+        uint16_t key{k_blank_key};
+        uint8_t size{0};
+        std::array<uint8_t, k_max_value_size> value{};
+    };
+
+    static_assert(sizeof(SectorHeader) == sizeof(Record),
+                  "The header occupies the first record slot");
+    static constexpr uint32_t k_slot_size = sizeof(Record);
+    static constexpr uint32_t k_slots_per_sector =
+        F::getSectorSize() / k_slot_size;
+    static constexpr uint32_t k_slots_per_page = F::getPageSize() / k_slot_size;
+    static_assert(F::getPageSize() % k_slot_size == 0,
+                  "Records must not cross pages");
+    static_assert(MaxKeys < k_slots_per_sector,
+                  "All keys must fit into one sector");
+
+    using Page = std::array<uint8_t, F::getPageSize()>;
+
+    template <typename T>
+    static constexpr auto checkValueType() -> void {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Value must be trivially copyable");
+        static_assert(sizeof(T) <= k_max_value_size, "Value is too large");
+    }
+
+    // Sequence numbers may wrap around
+    static constexpr auto isNewer(uint32_t sequence, uint32_t reference)
+        -> bool {
+        return static_cast<int32_t>(sequence - reference) > 0;
+    }
+
+    template <typename T>
+    static auto getCrc(const T& object) -> uint32_t {
+        std::array<uint8_t, sizeof(T) - sizeof(uint32_t)> bytes{};
+        std::memcpy(bytes.data(), &object, bytes.size());
+        return crc32(bytes);
+    }
+
+    static auto isBlank(const Record& record) -> bool {
+        std::array<uint8_t, sizeof(Record)> bytes{};
+        std::memcpy(bytes.data(), &record, bytes.size());
+        for (auto byte : bytes) {
+            if (byte != 0xFF) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static auto isValid(const Record& record) -> bool {
+        return record.key != k_blank_key &&
+               record.size <= k_max_value_size &&
+               record.crc == getCrc(record);
+    }
+
+    static auto makeRecord(const Entry& entry) -> Record {
+        Record record{.key = entry.key,
+                      .size = entry.size,
+                      .reserved = 0xFF,
+                      .value = entry.value,
+                      .crc = 0};
+        record.crc = getCrc(record);
+        return record;
+    }
+
+    auto findEntry(uint16_t key) const -> const Entry* {
+        for (const auto& entry : m_entries) {
+            if (entry.key == key) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // Find the entry of a key or a free one
+    auto findOrAddEntry(uint16_t key) -> Entry* {
+        Entry* free_entry = nullptr;
+        for (auto& entry : m_entries) {
+            if (entry.key == key) {
+                return &entry;
+            }
+            if (entry.key == k_blank_key && free_entry == nullptr) {
+                free_entry = &entry;
+            }
+        }
+        return free_entry;
+    }
+
+    auto getAddress(uint32_t sector, uint32_t slot) const -> uint32_t {
+        return (sector * F::getSectorSize()) + (slot * k_slot_size);
+    }
+
+    auto readSectorHeader(uint32_t sector, SectorHeader& header) const
+        -> bool {
+        std::array<uint8_t, sizeof(SectorHeader)> bytes{};
+        if (!m_flash.read(getAddress(sector, 0), bytes)) {
+            return false;
+        }
+        std::memcpy(&header, bytes.data(), bytes.size());
+        return header.magic == m_magic && header.crc == getCrc(header);
+    }
+
+    auto readRecord(uint32_t sector, uint32_t slot, Record& record) const
+        -> bool {
+        std::array<uint8_t, sizeof(Record)> bytes{};
+        if (!m_flash.read(getAddress(sector, slot), bytes)) {
+            return false;
+        }
+        std::memcpy(&record, bytes.data(), bytes.size());
+        return true;
+    }
+
+    // Program one slot, the rest of the page is left untouched by
+    // programming it with 0xFF
+    template <typename T>
+    auto appendRecord(uint32_t sector, uint32_t slot, const T& record) const
+        -> bool {
+        static_assert(sizeof(T) == k_slot_size);
+        Page page{};
+        page.fill(0xFF);
+        uint32_t first_slot = slot - (slot % k_slots_per_page);
+        std::memcpy(page.data() + ((slot - first_slot) * k_slot_size), &record,
+                    sizeof(T));
+        return m_flash.program(getAddress(sector, first_slot), page);
+    }
+
+    // Erase a sector and make it active, the header is programmed last
+    auto startSector(uint32_t sector, uint32_t sequence) -> bool {
+        if (!m_flash.erase(sector * F::getSectorSize(), F::getSectorSize())) {
+            return false;
+        }
+        uint32_t slot = 1;
+        for (const auto& entry : m_entries) {
+            if (entry.key != k_blank_key &&
+                !appendRecord(sector, slot++, makeRecord(entry))) {
+                return false;
+            }
+        }
+        SectorHeader header{.magic = m_magic,
+                            .sequence = sequence,
+                            .reserved = 0xFFFFFFFF,
+                            .crc = 0};
+        header.crc = getCrc(header);
+        if (!appendRecord(sector, 0, header)) {
+            return false;
+        }
+        m_active_sector = sector;
+        m_sequence = sequence;
+        m_next_slot = slot;
+        return true;
+    }
+
+    auto compact() -> bool {
+        return startSector((m_active_sector + 1) % m_sector_count,
+                           m_sequence + 1);
+    }
+
+    const F& m_flash;
+    uint32_t m_magic;
+    std::array<Entry, MaxKeys> m_entries{};
+    uint32_t m_sector_count{0};
+    uint32_t m_active_sector{0};
+    uint32_t m_sequence{0};
+    uint32_t m_next_slot{0};
+    bool m_is_mounted{false};
+};
+
+#endif   // log_store_hpp
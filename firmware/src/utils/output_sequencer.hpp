@@ -0,0 +1,357 @@
+#ifndef output_sequencer_hpp
+#define output_sequencer_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Plays a list of output steps, for automated tests of a device
+ *
+ * Every step holds a voltage and a current limit for its duration, or ramps
+ * the voltage linearly from the previous step to its own. The step boundaries
+ * are deadlines counted from the start, a late update() never shifts the
+ * following steps, so the timing does not drift with the load of the caller.
+ * The list is played a number of times, 0 loops until stopped.
+ *
+ * The sensor samples are captured per step, a capture holds the averages of
+ * the last pass of its step. Samples taken within the settling time after a
+ * boundary are skipped, the source needs time to follow a new request.
+ */
+class OutputSequencer {
+  public:
+    static constexpr size_t k_max_steps = 64;
+
+    /**
+     * @brief Step of the list, packed into 8 bytes
+     */
+    struct Step {
+        uint16_t voltage{0};             // mV, reached at the end of a ramp
+        uint16_t current{0};             // mA, current limit
+        uint32_t duration : 31 {0};      // us
+        uint32_t is_ramp : 1 {false};    // ramp from the previous voltage
+    };
+
+    /**
+     * @brief Measurements of the last pass of a step
+     */
+    struct Capture {
+        uint32_t timestamp{0};   // us, deadline the step started at
+        uint32_t sample_count{0};
+        int32_t voltage{0};       // mV, average
+        int32_t current{0};       // mA, average
+        int32_t current_max{0};   // mA
+        uint16_t loop{0};         // pass the capture is from
+    };
+
+    /**
+     * @brief Timing counters
+     */
+    struct Statistics {
+        uint32_t step_count{0};     // steps started
+        uint32_t max_lateness{0};   // us, from a deadline to its update()
+    };
+
+    /**
+     * @brief Sequencer settings
+     */
+    struct Settings {
+        uint32_t settling_time{0};   // us, samples skipped after a boundary
+    };
+
+    /**
+     * @brief Constructor, uses the default settings
+     */
+    constexpr OutputSequencer() = default;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] settings Sequencer settings
+     */
+    constexpr explicit OutputSequencer(const Settings& settings)
+        : m_settings(settings) {}
+
+    /**
+     * @brief Set the voltage resolution of the source
+     *
+     * @param[in] voltage_step Voltage step in mV, ramps are rounded to it
+     */
+    constexpr auto setVoltageStep(uint16_t voltage_step) -> void {
+        m_voltage_step = (voltage_step > 0) ? voltage_step : 1;
+    }
+
+    /**
+     * @brief Remove all steps, stops a running list
+     */
+    constexpr auto clear() -> void {
+        stop();
+        m_step_count = 0;
+        m_captures = {};
+    }
+
+    /**
+     * @brief Append a step, not while running
+     *
+     * @param[in] step Step
+     * @return False if the list is full or running
+     */
+    constexpr auto addStep(const Step& step) -> bool {
+        if (m_is_running || m_step_count >= k_max_steps) {
+            return false;
+        }
+        m_steps[m_step_count++] = step;
+        return true;
+    }
+
+    /**
+     * @brief Set how often the list is played
+     *
+     * @param[in] loop_count Number of passes, 0 loops until stopped
+     */
+    constexpr auto setLoopCount(uint16_t loop_count) -> void {
+        m_loop_count = loop_count;
+    }
+
+    /**
+     * @brief Arm the list, the first update() starts the first step
+     *
+     * @param[in] voltage Output voltage in mV before the start, a ramp in the
+     * first step starts from it
+     * @return False if there is no step or the list takes no time
+     */
+    constexpr auto start(uint16_t voltage) -> bool {
+        uint64_t duration = 0;
+        for (size_t i = 0; i < m_step_count; ++i) {
+            duration += m_steps[i].duration;
+        }
+        if (duration == 0) {
+            return false;
+        }
+        m_captures = {};
+        m_statistics = {};
+        m_previous_voltage = voltage;
+        m_index = 0;
+        m_loop = 0;
+        m_is_running = true;
+        m_is_started = false;
+        return true;
+    }
+
+    /**
+     * @brief Stop, the output keeps the current request
+     */
+    constexpr auto stop() -> void {
+        m_is_running = false;
+        m_is_started = false;
+    }
+
+    /**
+     * @brief Advance to the step due at a time
+     *
+     * Call it at least once per millisecond and before addSample().
+     *
+     * @param[in] timestamp Current time in us, may wrap around
+     * @return True if the voltage or the current to request changed
+     */
+    constexpr auto update(uint32_t timestamp) -> bool {
+        if (!m_is_running) {
+            return false;
+        }
+        uint16_t voltage = m_voltage;
+        uint16_t current = m_current;
+        if (!m_is_started) {
+            m_is_started = true;
+            enterStep(timestamp, timestamp);
+        }
+        // Catch up with every boundary that passed, each one is a deadline
+        while (m_is_running &&
+               timestamp - m_step_start >= m_steps[m_index].duration) {
+            finishCapture();
+            uint32_t deadline = m_step_start + m_steps[m_index].duration;
+            m_previous_voltage = m_steps[m_index].voltage;
+            if (++m_index >= m_step_count) {
+                m_index = 0;
+                ++m_loop;
+                if (m_loop_count != 0 && m_loop >= m_loop_count) {
+                    // The output keeps the end of the last step
+                    m_index = m_step_count - 1;
+                    m_voltage = roundVoltage(m_previous_voltage);
+                    m_is_running = false;
+                    break;
+                }
+            }
+            enterStep(deadline, timestamp);
+        }
+        if (m_is_running) {
+            m_voltage = getStepVoltage(timestamp - m_step_start);
+        }
+        return m_voltage != voltage || m_current != current;
+    }
+
+    /**
+     * @brief Capture a sensor sample for the running step
+     *
+     * @param[in] timestamp Sample time in us, may wrap around
+     * @param[in] voltage Measured output voltage in mV
+     * @param[in] current Measured output current in mA
+     */
+    constexpr auto addSample(uint32_t timestamp, int32_t voltage,
+                             int32_t current) -> void {
+        if (!m_is_running || !m_is_started) {
+            return;
+        }
+        uint32_t elapsed = timestamp - m_step_start;
+        if (elapsed < m_settings.settling_time ||
+            elapsed >= m_steps[m_index].duration) {
+            return;
+        }
+        m_voltage_sum += voltage;
+        m_current_sum += current;
+        if (m_sample_count == 0 || current > m_current_max) {
+            m_current_max = current;
+        }
+        ++m_sample_count;
+    }
+
+    /**
+     * @brief Get the voltage to request
+     *
+     * @return Voltage in mV, rounded to the voltage step
+     */
+    [[nodiscard]] constexpr auto getVoltage() const -> uint16_t {
+        return m_voltage;
+    }
+
+    /**
+     * @brief Get the current limit to request
+     *
+     * @return Current in mA
+     */
+    [[nodiscard]] constexpr auto getCurrent() const -> uint16_t {
+        return m_current;
+    }
+
+    /**
+     * @brief Check whether the list is playing
+     *
+     * @return True from start() until stopped or all passes are done
+     */
+    [[nodiscard]] constexpr auto isRunning() const -> bool {
+        return m_is_running;
+    }
+
+    /**
+     * @brief Get the number of steps
+     *
+     * @return Step count
+     */
+    [[nodiscard]] constexpr auto getStepCount() const -> size_t {
+        return m_step_count;
+    }
+
+    /**
+     * @brief Get the running step
+     *
+     * @return Index of the step, the last one after the list is done
+     */
+    [[nodiscard]] constexpr auto getStepIndex() const -> size_t {
+        return m_index;
+    }
+
+    /**
+     * @brief Get the running pass
+     *
+     * @return Number of finished passes
+     */
+    [[nodiscard]] constexpr auto getLoop() const -> uint16_t { return m_loop; }
+
+    /**
+     * @brief Get the measurements of a step
+     *
+     * @param[in] index Index of the step
+     * @return Capture of the last finished pass of the step
+     */
+    [[nodiscard]] constexpr auto getCapture(size_t index) const -> Capture {
+        return (index < m_step_count) ? m_captures[index] : Capture{};
+    }
+
+    /**
+     * @brief Get the timing counters
+     *
+     * @return Counters since the last start
+     */
+    [[nodiscard]] constexpr auto getStatistics() const -> const Statistics& {
+        return m_statistics;
+    }
+
+  private:
+    constexpr auto enterStep(uint32_t deadline, uint32_t timestamp) -> void {
+        m_step_start = deadline;
+        m_current = m_steps[m_index].current;
+        m_voltage_sum = 0;
+        m_current_sum = 0;
+        m_current_max = 0;
+        m_sample_count = 0;
+        ++m_statistics.step_count;
+        uint32_t lateness = timestamp - deadline;
+        if (lateness > m_statistics.max_lateness) {
+            m_statistics.max_lateness = lateness;
+        }
+    }
+
+    constexpr auto finishCapture() -> void {
+        auto& capture = m_captures[m_index];
+        capture = {.timestamp = m_step_start,
+                   .sample_count = m_sample_count,
+                   .loop = m_loop};
+        if (m_sample_count > 0) {
+            capture.voltage = static_cast<int32_t>(m_voltage_sum /
+                                                   m_sample_count);
+            capture.current = static_cast<int32_t>(m_current_sum /
+                                                   m_sample_count);
+            capture.current_max = m_current_max;
+        }
+    }
+
+    [[nodiscard]] constexpr auto getStepVoltage(uint32_t elapsed) const
+        -> uint16_t {
+        const auto& step = m_steps[m_index];
+        if (!step.is_ramp) {
+            return roundVoltage(step.voltage);
+        }
+        int32_t from = m_previous_voltage;
+        int64_t delta = static_cast<int64_t>(step.voltage - from) * elapsed /
+                        step.duration;
+        return roundVoltage(from + static_cast<int32_t>(delta));
+    }
+
+    // The source only takes whole voltage steps
+    [[nodiscard]] constexpr auto roundVoltage(int32_t voltage) const
+        -> uint16_t {
+        int32_t step = m_voltage_step;
+        return static_cast<uint16_t>(((voltage + (step / 2)) / step) * step);
+    }
+
+    Settings m_settings{};
+    std::array<Step, k_max_steps> m_steps{};
+    std::array<Capture, k_max_steps> m_captures{};
+    size_t m_step_count{0};
+    uint16_t m_loop_count{1};
+    uint16_t m_voltage_step{1};       // mV
+    uint16_t m_previous_voltage{0};   // mV, end of the previous step
+    uint16_t m_voltage{0};            // mV
+    uint16_t m_current{0};            // mA
+    size_t m_index{0};
+    uint16_t m_loop{0};
+    uint32_t m_step_start{0};   // us, deadline of the running step
+    int64_t m_voltage_sum{0};
+    int64_t m_current_sum{0};
+    int32_t m_current_max{0};
+    uint32_t m_sample_count{0};
+    Statistics m_statistics{};
+    bool m_is_running{false};
+    bool m_is_started{false};
+};
+
+#endif   // output_sequencer_hpp
@@ -0,0 +1,221 @@
+#ifndef pd_request_queue_hpp
+#define pd_request_queue_hpp
+
+#include <cstdint>
+
+#include "pdsink_iface.hpp"
+
+/**
+ * @brief Rate limited, non-blocking request queue in front of a PD sink
+ *
+ * Only the latest setpoint is kept: a request submitted while another one is
+ * still waiting replaces it, so a burst of edits or control loop updates ends
+ * up as a single request. Requests are spaced by at least the minimum
+ * interval, the source needs time to answer and to settle to every contract.
+ *
+ * A sent request is polled until the sink reports the outcome. A request the
+ * source did not answer within the timeout is sent again, up to the retry
+ * count, unless a newer setpoint is waiting. Rejections are final.
+ */
+class PdRequestQueue {
+  public:
+    using Result = IPdSink::RequestResult;
+
+    /**
+     * @brief Output request of a PDO
+     */
+    struct Request {
+        uint8_t index{0};
+        uint16_t voltage{0};   // mV
+        uint16_t current{0};   // mA
+
+        auto operator==(const Request&) const -> bool = default;
+    };
+
+    /**
+     * @brief Result of a request sent to the sink
+     */
+    struct Outcome {
+        Request request{};
+        Result result{Result::Rejected};
+    };
+
+    /**
+     * @brief Request counters
+     */
+    struct Statistics {
+        uint32_t submitted{0};
+        uint32_t coalesced{0};   // replaced before they were sent
+        uint32_t accepted{0};
+        uint32_t rejected{0};
+        uint32_t timeouts{0};
+        uint32_t retries{0};
+    };
+
+    /**
+     * @brief Queue settings
+     */
+    struct Settings {
+        uint32_t min_interval{100};   // ms between two requests
+        uint32_t poll_interval{5};    // ms between two result reads
+        uint32_t timeout{1000};       // ms until a request is given up
+        uint8_t retry_count{2};       // sends after a timeout
+    };
+
+    /**
+     * @brief Constructor, uses the default settings
+     *
+     * @param[in] sink PD sink receiving the requests
+     */
+    explicit PdRequestQueue(IPdSink& sink) : m_sink(sink) {}
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] sink PD sink receiving the requests
+     * @param[in] settings Queue settings
+     */
+    PdRequestQueue(IPdSink& sink, const Settings& settings)
+        : m_sink(sink), m_settings(settings) {}
+
+    /**
+     * @brief Queue a request, replaces the one still waiting
+     *
+     * @param[in] request Request to send
+     */
+    auto submit(const Request& request) -> void {
+        ++m_statistics.submitted;
+        if (m_is_pending) {
+            ++m_statistics.coalesced;
+        }
+        m_pending = request;
+        m_is_pending = true;
+    }
+
+    /**
+     * @brief Drop the request still waiting, a sent one is still followed
+     */
+    auto cancel() -> void { m_is_pending = false; }
+
+    /**
+     * @brief Follow the sent request and send the waiting one when due
+     *
+     * Never blocks on the negotiation, every call costs at most one result
+     * read or one request.
+     *
+     * @param[in] timestamp Current time in ms, may wrap around
+     * @param[out] outcome Result of the finished request
+     * @return True if a request finished and outcome is written
+     */
+    auto process(uint32_t timestamp, Outcome& outcome) -> bool {
+        if (m_is_in_flight) {
+            return poll(timestamp, outcome);
+        }
+        if (!m_is_pending ||
+            (m_has_sent &&
+             timestamp - m_sent_timestamp < m_settings.min_interval)) {
+            return false;
+        }
+        m_is_pending = false;
+        m_in_flight = m_pending;
+        m_retries_left = m_settings.retry_count;
+        return send(timestamp, outcome);
+    }
+
+    /**
+     * @brief Check whether a request is waiting or not finished yet
+     *
+     * @return True if busy
+     */
+    [[nodiscard]] auto isBusy() const -> bool {
+        return m_is_pending || m_is_in_flight;
+    }
+
+    /**
+     * @brief Check whether a request is waiting to be sent
+     *
+     * @return True if a request is waiting
+     */
+    [[nodiscard]] auto isPending() const -> bool { return m_is_pending; }
+
+    /**
+     * @brief Get the request counters
+     *
+     * @return Counters since the start or the last reset
+     */
+    [[nodiscard]] auto getStatistics() const -> const Statistics& {
+        return m_statistics;
+    }
+
+    /**
+     * @brief Reset the request counters
+     */
+    auto resetStatistics() -> void { m_statistics = {}; }
+
+  private:
+    auto send(uint32_t timestamp, Outcome& outcome) -> bool {
+        m_has_sent = true;
+        m_sent_timestamp = timestamp;
+        m_poll_timestamp = timestamp;
+        if (!m_sink.requestPdo(m_in_flight.index, m_in_flight.voltage,
+                               m_in_flight.current)) {
+            return finish(Result::Rejected, outcome);
+        }
+        m_is_in_flight = true;
+        return false;
+    }
+
+    auto poll(uint32_t timestamp, Outcome& outcome) -> bool {
+        if (timestamp - m_poll_timestamp < m_settings.poll_interval) {
+            return false;
+        }
+        m_poll_timestamp = timestamp;
+        auto result = m_sink.getRequestResult();
+        if (result == Result::Pending &&
+            timestamp - m_sent_timestamp >= m_settings.timeout) {
+            result = Result::Timeout;
+        }
+        if (result == Result::Pending) {
+            return false;
+        }
+        m_is_in_flight = false;
+        // Retrying is pointless once a newer setpoint waits
+        if (result == Result::Timeout && m_retries_left > 0 && !m_is_pending) {
+            --m_retries_left;
+            ++m_statistics.retries;
+            return send(timestamp, outcome);
+        }
+        return finish(result, outcome);
+    }
+
+    auto finish(Result result, Outcome& outcome) -> bool {
+        m_is_in_flight = false;
+        switch (result) {
+        case Result::Accepted:
+            ++m_statistics.accepted;
+            break;
+        case Result::Timeout:
+            ++m_statistics.timeouts;
+            break;
+        default:
+            ++m_statistics.rejected;
+            break;
+        }
+        outcome = Outcome{.request = m_in_flight, .result = result};
+        return true;
+    }
+
+    IPdSink& m_sink;
+    Settings m_settings{};
+    Request m_pending{};
+    Request m_in_flight{};
+    uint32_t m_sent_timestamp{0};
+    uint32_t m_poll_timestamp{0};
+    Statistics m_statistics{};
+    uint8_t m_retries_left{0};
+    bool m_is_pending{false};
+    bool m_is_in_flight{false};
+    bool m_has_sent{false};
+};
+
+#endif   // pd_request_queue_hpp
@@ -1,8 +1,11 @@
 #ifndef pdo_helper_hpp
 #define pdo_helper_hpp
 
+#include <array>
+#include <cstdint>
 #include <string_view>
 
+#include "crc32.hpp"
 #include "pdsink_iface.hpp"
 #include "tiny_format.hpp"
 
@@ -17,21 +20,54 @@
 template <size_t N>
 auto pdoToString(const IPdSink::Pdo& pdo, std::array<char, N>& dest)
     -> std::string_view {
+    // PDO values are in mV/mA and shown in V/A with one decimal, like "5.0"
+    constexpr NumberFormat k_format{.decimals = 1, .scale = 3};
     if (pdo.type == IPdSink::PdoType::FIX) {
-        return tinyFormat(dest, "FIX %.1fV ^%.1fA", pdo.voltage_max / 1000.0,
-                          pdo.current_max / 1000.0);
+        return TinyFormat{dest}
+            .append("FIX ")
+            .append(pdo.voltage_max, k_format)
+            .append("V ^")
+            .append(pdo.current_max, k_format)
+            .append("A")
+            .str();
     }
-    if (pdo.type == IPdSink::PdoType::PPS) {
-        return tinyFormat(dest, "PPS %.1f-%.1fV ^%.1fA",
-                          pdo.voltage_min / 1000.0, pdo.voltage_max / 1000.0,
-                          pdo.current_max / 1000.0);
-    }
-    if (pdo.type == IPdSink::PdoType::AVS) {
-        return tinyFormat(dest, "AVS %.1f-%.1fV ^%.1fA",
-                          pdo.voltage_min / 1000.0, pdo.voltage_max / 1000.0,
-                          pdo.current_max / 1000.0);
+    if (pdo.type == IPdSink::PdoType::PPS ||
+        pdo.type == IPdSink::PdoType::AVS) {
+        return TinyFormat{dest}
+            .append(IPdSink::pdoTypeToString(pdo.type))
+            .append(" ")
+            .append(pdo.voltage_min, k_format)
+            .append("-")
+            .append(pdo.voltage_max, k_format)
+            .append("V ^")
+            .append(pdo.current_max, k_format)
+            .append("A")
+            .str();
     }
     return std::string_view{"N/A"};
 }
 
+/**
+ * @brief Compute a fingerprint of a PDO
+ *
+ * Used to recognize a PDO of the same source after a restart, so values saved
+ * for a PDO are never applied to a different one.
+ *
+ * @param[in] pdo PDO
+ * @return CRC-32 of all PDO fields
+ */
+constexpr auto getPdoFingerprint(const IPdSink::Pdo& pdo) -> uint32_t {
+    const std::array<uint16_t, 8> fields = {
+        pdo.index,        static_cast<uint16_t>(pdo.type),
+        pdo.voltage_min,  pdo.voltage_max,
+        pdo.voltage_step, pdo.current_min,
+        pdo.current_max,  pdo.current_step};
+    std::array<uint8_t, fields.size() * 2> bytes{};
+    for (size_t i = 0; i < fields.size(); ++i) {
+        bytes[2 * i] = static_cast<uint8_t>(fields[i]);
+        bytes[(2 * i) + 1] = static_cast<uint8_t>(fields[i] >> 8);
+    }
+    return crc32(bytes);
+}
+
 #endif   // pdo_helper_hpp
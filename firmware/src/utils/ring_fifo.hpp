@@ -0,0 +1,69 @@
+#ifndef ring_fifo_hpp
+#define ring_fifo_hpp
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Fixed size first in, first out queue that keeps the newest entries
+ *
+ * A push into the full queue drops the oldest entry, so a reader that falls
+ * behind loses the start of the data and not the latest state.
+ *
+ * @tparam T Entry type
+ * @tparam N Capacity
+ */
+template <typename T, size_t N>
+class RingFifo {
+    static_assert(N > 0, "Capacity must not be zero");
+
+  public:
+    /**
+     * @brief Add an entry, the oldest one is dropped if the queue is full
+     *
+     * @param[in] entry Entry
+     */
+    constexpr auto push(const T& entry) -> void {
+        m_entries[(m_first + m_size) % N] = entry;
+        if (m_size < N) {
+            ++m_size;
+        } else {
+            m_first = (m_first + 1) % N;
+        }
+    }
+
+    /**
+     * @brief Remove the oldest entry
+     *
+     * @param[out] entry Oldest entry
+     * @return True if the queue was not empty
+     */
+    constexpr auto pop(T& entry) -> bool {
+        if (m_size == 0) {
+            return false;
+        }
+        entry = m_entries[m_first];
+        m_first = (m_first + 1) % N;
+        --m_size;
+        return true;
+    }
+
+    /**
+     * @brief Remove all entries
+     */
+    constexpr auto clear() -> void {
+        m_first = 0;
+        m_size = 0;
+    }
+
+    [[nodiscard]] constexpr auto getSize() const -> size_t { return m_size; }
+
+    [[nodiscard]] static constexpr auto getCapacity() -> size_t { return N; }
+
+  private:
+    std::array<T, N> m_entries{};
+    size_t m_first{0};
+    size_t m_size{0};
+};
+
+#endif   // ring_fifo_hpp
@@ -0,0 +1,758 @@
+#ifndef scpi_interpreter_hpp
+#define scpi_interpreter_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "serial.hpp"
+#include "tiny_format.hpp"
+
+/**
+ * @brief SCPI error codes, the subset the interpreter reports
+ */
+enum class ScpiError : int16_t {
+    None = 0,
+    DataTypeError = -104,
+    ParameterNotAllowed = -108,
+    MissingParameter = -109,
+    UndefinedHeader = -113,
+    SettingsConflict = -221,
+    DataOutOfRange = -222,
+    TooMuchData = -223,
+    SystemError = -310,
+    QueueOverflow = -350,
+    QueryError = -400
+};
+
+/**
+ * @brief Convert ScpiError enum value to the standard error message
+ *
+ * @param error ScpiError
+ */
+constexpr auto scpiErrorToString(ScpiError error) -> std::string_view {
+    switch (error) {
+    case ScpiError::None:
+        return "No error";
+    case ScpiError::DataTypeError:
+        return "Data type error";
+    case ScpiError::ParameterNotAllowed:
+        return "Parameter not allowed";
+    case ScpiError::MissingParameter:
+        return "Missing parameter";
+    case ScpiError::UndefinedHeader:
+        return "Undefined header";
+    case ScpiError::SettingsConflict:
+        return "Settings conflict";
+    case ScpiError::DataOutOfRange:
+        return "Data out of range";
+    case ScpiError::TooMuchData:
+        return "Too much data";
+    case ScpiError::SystemError:
+        return "System error";
+    case ScpiError::QueueOverflow:
+        return "Queue overflow";
+    case ScpiError::QueryError:
+        return "Query error";
+    }
+    return "Unknown error";
+}
+
+/**
+ * @brief Remote command passed on to the state machine
+ *
+ * Voltages and currents are given in mV and mA, calibration references in uV
+ * and uA, step durations in us, counts and indexes as they are and booleans
+ * as 0 or 1.
+ */
+struct RemoteCommand {
+    enum class Type : uint8_t {
+        MeasureVoltage,       // MEASure:VOLTage?
+        MeasureCurrent,       // MEASure:CURRent?
+        MeasurePower,         // MEASure:POWer?
+        MeasureBinary,        // MEASure:BINary?, all of them in one block
+        MeasureArray,         // MEASure:ARRay?, the samples since the last one
+        SetVoltage,           // VOLTage <V>
+        GetVoltage,           // VOLTage?
+        SetCurrent,           // CURRent <A>
+        GetCurrent,           // CURRent?
+        SetOcpLimit,          // CURRent:PROTection <A>, 0 disables it
+        GetOcpLimit,          // CURRent:PROTection?
+        SetSensorProfile,     // SENSe:PROFile <n>, 0 fast to 2 precise
+        GetSensorProfile,     // SENSe:PROFile?
+        SetVoltageTrim,       // VOLTage:TRIM ON|OFF, cable-drop compensation
+        GetVoltageTrim,       // VOLTage:TRIM?
+        SetOutput,            // OUTPut ON|OFF
+        GetOutput,            // OUTPut?
+        ResetEnergy,          // ENERgy:RESet, energy and charge totals
+        GetPdos,              // SYSTem:PDO?
+        ListClear,            // LIST:CLEar
+        ListStep,             // LIST:STEP <V>,<A>,<s>
+        ListRamp,             // LIST:RAMP <V>,<A>,<s>
+        ListCount,            // LIST:COUNt <passes>
+        ListStart,            // LIST:STARt
+        ListStop,             // LIST:STOP
+        ListData,             // LIST:DATA? <step>
+        CalibrationStart,     // CALibration:STARt
+        CalibrationVoltage,   // CALibration:VOLTage <V>, reference reading
+        CalibrationCurrent,   // CALibration:CURRent <A>, reference reading
+        CalibrationSave,      // CALibration:SAVE
+        CalibrationAbort,     // CALibration:ABORt, keeps the stored one
+        CalibrationReset      // CALibration:RESet, stores no correction
+    };
+    Type type{Type::MeasureVoltage};
+    std::array<int32_t, 3> values{};
+};
+
+/**
+ * @brief Reply to a line of commands, filled by the command handlers
+ *
+ * The last byte is kept for the line end, appends never take it.
+ */
+class RemoteReply {
+  public:
+    static constexpr size_t k_size = 1024;
+
+    /**
+     * @brief Remove the content and the error
+     */
+    auto clear() -> void {
+        m_size = 0;
+        m_error = ScpiError::None;
+        m_is_overflow = false;
+    }
+
+    /**
+     * @brief Append a string, dropped as a whole if it does not fit
+     *
+     * @param[in] str String
+     * @return reference to this reply
+     */
+    auto append(std::string_view str) -> RemoteReply& {
+        if (str.size() > k_size - 1 - m_size) {
+            m_is_overflow = true;
+            return *this;
+        }
+        for (const auto& character : str) {
+            m_data[m_size++] = static_cast<uint8_t>(character);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append a number
+     *
+     * @param[in] value Value in units of 10^-format.scale
+     * @param[in] format Number format
+     * @return reference to this reply
+     */
+    auto append(int32_t value, const NumberFormat& format = {})
+        -> RemoteReply& {
+        std::array<char, 16> buffer{};
+        return append(TinyFormat{buffer}.append(value, format).str());
+    }
+
+    /**
+     * @brief Append binary data as a definite length block
+     *
+     * The block is '#', the digit count of the length, the length and the
+     * data, e.g. "#216" and 16 bytes.
+     *
+     * @param[in] block Data
+     * @return reference to this reply
+     */
+    auto appendBlock(std::span<const uint8_t> block) -> RemoteReply& {
+        std::array<char, 12> buffer{};
+        auto length = TinyFormat{buffer}
+                          .append(static_cast<int32_t>(block.size()))
+                          .str();
+        if (block.size() + length.size() + 2 > k_size - 1 - m_size) {
+            m_is_overflow = true;
+            return *this;
+        }
+        m_data[m_size++] = '#';
+        m_data[m_size++] = static_cast<uint8_t>('0' + length.size());
+        append(length);
+        for (const auto& byte : block) {
+            m_data[m_size++] = byte;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Terminate the reply with a line feed, always fits
+     */
+    auto endLine() -> void { m_data[m_size++] = '\n'; }
+
+    /**
+     * @brief Report the failure of the command
+     *
+     * @param[in] error Error queued for SYSTem:ERRor?
+     */
+    auto setError(ScpiError error) -> void { m_error = error; }
+
+    [[nodiscard]] auto getError() const -> ScpiError { return m_error; }
+
+    [[nodiscard]] auto getSize() const -> size_t { return m_size; }
+
+    [[nodiscard]] auto getData() const -> std::span<const uint8_t> {
+        return std::span<const uint8_t>(m_data.data(), m_size);
+    }
+
+    /**
+     * @brief Check whether an append was dropped
+     *
+     * @return True if the content did not fit since the last clear()
+     */
+    [[nodiscard]] auto isOverflow() const -> bool { return m_is_overflow; }
+
+  private:
+    std::array<uint8_t, k_size> m_data{};
+    size_t m_size{0};
+    ScpiError m_error{ScpiError::None};
+    bool m_is_overflow{false};
+};
+
+/**
+ * @brief Line based SCPI interpreter on a serial port
+ *
+ * Lines end with LF or CR and may hold several commands separated by ';',
+ * every command is given with its full path. Keywords match in their short
+ * or long form in any case, e.g. "MEAS:VOLT?" or "measure:voltage?". The
+ * answers of the queries in a line are sent as one line separated by ';', a
+ * query that can not be answered gets 9.91E+37, the SCPI not-a-number. Errors
+ * are queued and read with SYSTem:ERRor?, set commands do not answer.
+ *
+ * *IDN?, *OPC?, *CLS and SYSTem:ERRor? are handled by the interpreter, the
+ * other commands are returned by poll() to be handled by the caller.
+ *
+ * Nothing is allocated and poll() never waits: it receives at most one chunk
+ * from the port and returns at most one command. No new line is read until
+ * the reply to the previous one is sent, a host that does not read the
+ * replies stalls its own commands.
+ *
+ * @tparam S Serial port type
+ */
+template <hal::serial::Serial S>
+class ScpiInterpreter {
+  public:
+    static constexpr size_t k_max_line_length = 128;
+    static constexpr size_t k_error_queue_size = 8;
+    static constexpr std::string_view k_not_a_number = "9.91E+37";
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] serial Serial port
+     * @param[in] identity Answer to *IDN?, "maker,model,serial,version"
+     */
+    constexpr ScpiInterpreter(const S& serial, std::string_view identity)
+        : m_serial(serial), m_identity(identity) {}
+
+    /**
+     * @brief Send the pending reply and parse the next command
+     *
+     * Handle the returned command before the next call, a query appends its
+     * answer to getReply(), a failed command sets the error of it.
+     *
+     * @param[out] command Next command for the caller
+     * @return True if a command is written
+     */
+    auto poll(RemoteCommand& command) -> bool {
+        finishCommand();
+        if (!transmit()) {
+            return false;
+        }
+        if (!m_has_line && !receiveLine()) {
+            return false;
+        }
+        m_has_line = true;
+        while (m_line_position < m_line_length) {
+            if (parseCommand(nextCommand(), command)) {
+                return true;
+            }
+        }
+        finishLine();
+        return false;
+    }
+
+    /**
+     * @brief Get the reply the handler of a command appends to
+     *
+     * @return Reply of the line in progress
+     */
+    auto getReply() -> RemoteReply& { return m_reply; }
+
+    /**
+     * @brief Queue an error that is not caused by a command
+     *
+     * @param[in] error Error read with SYSTem:ERRor?
+     */
+    auto reportError(ScpiError error) -> void { pushError(error); }
+
+  private:
+    // Parameters are converted to integers in units of 10^-scale
+    enum class Parameter : uint8_t { None, Boolean, Integer, Milli, Micro };
+
+    struct CommandSpec {
+        std::array<std::string_view, 2> keywords{};   // second may be empty
+        bool is_query{false};
+        RemoteCommand::Type type{RemoteCommand::Type::MeasureVoltage};
+        std::array<Parameter, 3> parameters{};
+    };
+
+    using Type = RemoteCommand::Type;
+
+    static constexpr std::array k_commands = {
+        CommandSpec{{"MEASure", "VOLTage"}, true, Type::MeasureVoltage},
+        CommandSpec{{"MEASure", "CURRent"}, true, Type::MeasureCurrent},
+        CommandSpec{{"MEASure", "POWer"}, true, Type::MeasurePower},
+        CommandSpec{{"MEASure", "BINary"}, true, Type::MeasureBinary},
+        CommandSpec{{"MEASure", "ARRay"}, true, Type::MeasureArray},
+        CommandSpec{{"VOLTage"}, false, Type::SetVoltage, {Parameter::Milli}},
+        CommandSpec{{"VOLTage"}, true, Type::GetVoltage},
+        CommandSpec{{"CURRent"}, false, Type::SetCurrent, {Parameter::Milli}},
+        CommandSpec{{"CURRent"}, true, Type::GetCurrent},
+        CommandSpec{{"CURRent", "PROTection"},
+                    false,
+                    Type::SetOcpLimit,
+                    {Parameter::Milli}},
+        CommandSpec{{"CURRent", "PROTection"}, true, Type::GetOcpLimit},
+        CommandSpec{{"SENSe", "PROFile"},
+                    false,
+                    Type::SetSensorProfile,
+                    {Parameter::Integer}},
+        CommandSpec{{"SENSe", "PROFile"}, true, Type::GetSensorProfile},
+        CommandSpec{{"VOLTage", "TRIM"},
+                    false,
+                    Type::SetVoltageTrim,
+                    {Parameter::Boolean}},
+        CommandSpec{{"VOLTage", "TRIM"}, true, Type::GetVoltageTrim},
+        CommandSpec{{"OUTPut"}, false, Type::SetOutput, {Parameter::Boolean}},
+        CommandSpec{{"OUTPut"}, true, Type::GetOutput},
+        CommandSpec{{"ENERgy", "RESet"}, false, Type::ResetEnergy},
+        CommandSpec{{"SYSTem", "PDO"}, true, Type::GetPdos},
+        CommandSpec{{"LIST", "CLEar"}, false, Type::ListClear},
+        CommandSpec{{"LIST", "STEP"},
+                    false,
+                    Type::ListStep,
+                    {Parameter::Milli, Parameter::Milli, Parameter::Micro}},
+        CommandSpec{{"LIST", "RAMP"},
+                    false,
+                    Type::ListRamp,
+                    {Parameter::Milli, Parameter::Milli, Parameter::Micro}},
+        CommandSpec{{"LIST", "COUNt"},
+                    false,
+                    Type::ListCount,
+                    {Parameter::Integer}},
+        CommandSpec{{"LIST", "STARt"}, false, Type::ListStart},
+        CommandSpec{{"LIST", "STOP"}, false, Type::ListStop},
+        CommandSpec{{"LIST", "DATA"},
+                    true,
+                    Type::ListData,
+                    {Parameter::Integer}},
+        CommandSpec{{"CALibration", "STARt"}, false, Type::CalibrationStart},
+        CommandSpec{{"CALibration", "VOLTage"},
+                    false,
+                    Type::CalibrationVoltage,
+                    {Parameter::Micro}},
+        CommandSpec{{"CALibration", "CURRent"},
+                    false,
+                    Type::CalibrationCurrent,
+                    {Parameter::Micro}},
+        CommandSpec{{"CALibration", "SAVE"}, false, Type::CalibrationSave},
+        CommandSpec{{"CALibration", "ABORt"}, false, Type::CalibrationAbort},
+        CommandSpec{{"CALibration", "RESet"}, false, Type::CalibrationReset},
+    };
+
+    // Collect the outcome of the command returned by the last poll()
+    auto finishCommand() -> void {
+        if (!m_is_command_pending) {
+            return;
+        }
+        m_is_command_pending = false;
+        if (m_reply.getError() != ScpiError::None) {
+            pushError(m_reply.getError());
+            m_reply.setError(ScpiError::None);
+        }
+        if (m_is_query && m_reply.getSize() == m_answer_start) {
+            m_reply.append(k_not_a_number);
+        }
+    }
+
+    auto finishLine() -> void {
+        m_has_line = false;
+        m_line_length = 0;
+        m_line_position = 0;
+        if (m_reply.isOverflow()) {
+            pushError(ScpiError::QueryError);
+        }
+        if (m_reply.getSize() == 0) {
+            return;
+        }
+        m_reply.endLine();
+        m_tx_size = m_reply.getSize();
+        m_tx_position = 0;
+        transmit();
+    }
+
+    // Send what the port takes, true once the whole reply is sent
+    auto transmit() -> bool {
+        if (m_tx_size == 0) {
+            return true;
+        }
+        int count = m_serial.write(m_reply.getData().subspan(
+            m_tx_position, m_tx_size - m_tx_position));
+        m_tx_position += static_cast<size_t>(count);
+        if (m_tx_position < m_tx_size) {
+            return false;
+        }
+        m_tx_size = 0;
+        m_tx_position = 0;
+        m_reply.clear();
+        return true;
+    }
+
+    // Read at most one chunk, true once a line is complete. The rest of the
+    // chunk is kept for the next line.
+    auto receiveLine() -> bool {
+        if (m_rx_position >= m_rx_size) {
+            int count = m_serial.read(m_rx);
+            m_rx_size = (count > 0) ? static_cast<size_t>(count) : 0;
+            m_rx_position = 0;
+        }
+        while (m_rx_position < m_rx_size) {
+            auto character = static_cast<char>(m_rx[m_rx_position++]);
+            if (character == '\n' || character == '\r') {
+                if (m_is_line_overflow) {
+                    m_is_line_overflow = false;
+                    m_line_length = 0;
+                    pushError(ScpiError::TooMuchData);
+                    continue;
+                }
+                // CR LF ends a line and an empty one
+                if (m_line_length > 0) {
+                    return true;
+                }
+                continue;
+            }
+            if (m_line_length < m_line.size()) {
+                m_line[m_line_length++] = character;
+            } else {
+                m_is_line_overflow = true;
+            }
+        }
+        return false;
+    }
+
+    auto nextCommand() -> std::string_view {
+        size_t start = m_line_position;
+        while (m_line_position < m_line_length &&
+               m_line[m_line_position] != ';') {
+            ++m_line_position;
+        }
+        std::string_view text(m_line.data() + start, m_line_position - start);
+        // Skip the separator
+        if (m_line_position < m_line_length) {
+            ++m_line_position;
+        }
+        return text;
+    }
+
+    // True if the command is for the caller, false if it is handled or wrong
+    auto parseCommand(std::string_view text, RemoteCommand& command) -> bool {
+        text = trim(text);
+        if (text.empty()) {
+            return false;
+        }
+        size_t separator = text.find_first_of(" \t");
+        std::string_view header = text.substr(0, separator);
+        std::string_view parameters =
+            (separator == std::string_view::npos)
+                ? std::string_view{}
+                : trim(text.substr(separator));
+        if (!header.empty() && header.front() == ':') {
+            header.remove_prefix(1);
+        }
+        bool is_query = !header.empty() && header.back() == '?';
+        if (is_query) {
+            header.remove_suffix(1);
+        }
+        if (parseInternalCommand(header, is_query, parameters)) {
+            return false;
+        }
+        size_t colon = header.find(':');
+        std::string_view first = header.substr(0, colon);
+        std::string_view second = (colon == std::string_view::npos)
+                                      ? std::string_view{}
+                                      : header.substr(colon + 1);
+        for (const auto& spec : k_commands) {
+            if (spec.is_query == is_query &&
+                matchesKeyword(first, spec.keywords[0]) &&
+                matchesKeyword(second, spec.keywords[1])) {
+                command = RemoteCommand{.type = spec.type};
+                if (!parseParameters(parameters, spec.parameters,
+                                     command.values)) {
+                    return false;
+                }
+                beginCommand(is_query);
+                return true;
+            }
+        }
+        pushError(ScpiError::UndefinedHeader);
+        return false;
+    }
+
+    auto parseInternalCommand(std::string_view header, bool is_query,
+                              std::string_view parameters) -> bool {
+        bool is_identity = matchesKeyword(header, "*IDN") && is_query;
+        bool is_complete = matchesKeyword(header, "*OPC") && is_query;
+        bool is_clear = matchesKeyword(header, "*CLS") && !is_query;
+        bool is_error = matchesKeyword(header, "SYSTem:ERRor") && is_query;
+        if (!is_identity && !is_complete && !is_clear && !is_error) {
+            return false;
+        }
+        if (!parameters.empty()) {
+            pushError(ScpiError::ParameterNotAllowed);
+            return true;
+        }
+        if (is_clear) {
+            m_error_count = 0;
+            return true;
+        }
+        beginAnswer();
+        if (is_identity) {
+            m_reply.append(m_identity);
+        } else if (is_complete) {
+            // Commands are executed in order, all of them are done
+            m_reply.append("1");
+        } else {
+            ScpiError error = popError();
+            m_reply.append(static_cast<int32_t>(error))
+                .append(",\"")
+                .append(scpiErrorToString(error))
+                .append("\"");
+        }
+        return true;
+    }
+
+    auto parseParameters(std::string_view text,
+                         const std::array<Parameter, 3>& parameters,
+                         std::array<int32_t, 3>& values) -> bool {
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            if (parameters[i] == Parameter::None) {
+                if (!text.empty()) {
+                    pushError(ScpiError::ParameterNotAllowed);
+                    return false;
+                }
+                return true;
+            }
+            if (text.empty()) {
+                pushError(ScpiError::MissingParameter);
+                return false;
+            }
+            size_t comma = text.find(',');
+            std::string_view value = trim(text.substr(0, comma));
+            text = (comma == std::string_view::npos)
+                       ? std::string_view{}
+                       : trim(text.substr(comma + 1));
+            if (!parseValue(value, parameters[i], values[i])) {
+                pushError(ScpiError::DataTypeError);
+                return false;
+            }
+        }
+        if (!text.empty()) {
+            pushError(ScpiError::ParameterNotAllowed);
+            return false;
+        }
+        return true;
+    }
+
+    static constexpr auto parseValue(std::string_view text,
+                                     Parameter parameter, int32_t& value)
+        -> bool {
+        switch (parameter) {
+        case Parameter::Boolean:
+            if (matchesKeyword(text, "ON") || text == "1") {
+                value = 1;
+                return true;
+            }
+            if (matchesKeyword(text, "OFF") || text == "0") {
+                value = 0;
+                return true;
+            }
+            return false;
+        case Parameter::Integer:
+            return parseNumber(text, 0, value);
+        case Parameter::Milli:
+            return parseNumber(text, 3, value);
+        case Parameter::Micro:
+            return parseNumber(text, 6, value);
+        default:
+            return false;
+        }
+    }
+
+    // Decimal number without exponent to an integer in units of 10^-scale,
+    // the digits beyond the scale round the value
+    static constexpr auto parseNumber(std::string_view text, uint8_t scale,
+                                      int32_t& value) -> bool {
+        bool is_negative = false;
+        if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+            is_negative = text.front() == '-';
+            text.remove_prefix(1);
+        }
+        int64_t magnitude = 0;
+        uint8_t decimals = 0;
+        bool has_digits = false;
+        bool has_point = false;
+        bool is_rounded_up = false;
+        bool is_rounding_known = false;
+        for (const auto& character : text) {
+            if (character == '.' && !has_point) {
+                has_point = true;
+                continue;
+            }
+            if (character < '0' || character > '9') {
+                return false;
+            }
+            has_digits = true;
+            if (has_point && decimals == scale) {
+                if (!is_rounding_known) {
+                    is_rounded_up = character >= '5';
+                    is_rounding_known = true;
+                }
+                continue;
+            }
+            magnitude = (magnitude * 10) + (character - '0');
+            if (has_point) {
+                ++decimals;
+            }
+            if (magnitude > INT32_MAX) {
+                return false;
+            }
+        }
+        if (!has_digits) {
+            return false;
+        }
+        for (; decimals < scale; ++decimals) {
+            magnitude *= 10;
+        }
+        if (is_rounded_up) {
+            ++magnitude;
+        }
+        if (magnitude > INT32_MAX) {
+            return false;
+        }
+        value = static_cast<int32_t>(is_negative ? -magnitude : magnitude);
+        return true;
+    }
+
+    // The short form is the upper case part of the keyword, either form
+    // matches in any case. Keywords of a path are compared one by one.
+    static constexpr auto matchesKeyword(std::string_view token,
+                                         std::string_view keyword) -> bool {
+        size_t colon = keyword.find(':');
+        if (colon != std::string_view::npos) {
+            size_t token_colon = token.find(':');
+            return token_colon != std::string_view::npos &&
+                   matchesKeyword(token.substr(0, token_colon),
+                                  keyword.substr(0, colon)) &&
+                   matchesKeyword(token.substr(token_colon + 1),
+                                  keyword.substr(colon + 1));
+        }
+        size_t short_length = 0;
+        while (short_length < keyword.size() &&
+               !isLower(keyword[short_length])) {
+            ++short_length;
+        }
+        if (token.size() != short_length && token.size() != keyword.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < token.size(); ++i) {
+            if (toUpper(token[i]) != toUpper(keyword[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr auto isLower(char character) -> bool {
+        return character >= 'a' && character <= 'z';
+    }
+
+    static constexpr auto toUpper(char character) -> char {
+        return isLower(character) ? static_cast<char>(character - 'a' + 'A')
+                                  : character;
+    }
+
+    static constexpr auto trim(std::string_view text) -> std::string_view {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    auto beginCommand(bool is_query) -> void {
+        m_is_command_pending = true;
+        m_is_query = is_query;
+        if (is_query) {
+            beginAnswer();
+        }
+    }
+
+    auto beginAnswer() -> void {
+        if (m_reply.getSize() > 0) {
+            m_reply.append(";");
+        }
+        m_answer_start = m_reply.getSize();
+    }
+
+    // A full queue keeps its oldest errors, the last one becomes an overflow
+    auto pushError(ScpiError error) -> void {
+        if (m_error_count < m_errors.size()) {
+            m_errors[(m_error_head + m_error_count++) % m_errors.size()] =
+                error;
+        } else {
+            m_errors[(m_error_head + m_errors.size() - 1) % m_errors.size()] =
+                ScpiError::QueueOverflow;
+        }
+    }
+
+    auto popError() -> ScpiError {
+        if (m_error_count == 0) {
+            return ScpiError::None;
+        }
+        ScpiError error = m_errors[m_error_head];
+        m_error_head = (m_error_head + 1) % m_errors.size();
+        --m_error_count;
+        return error;
+    }
+
+    const S& m_serial;
+    std::string_view m_identity;
+    std::array<uint8_t, 64> m_rx{};
+    size_t m_rx_size{0};
+    size_t m_rx_position{0};
+    std::array<char, k_max_line_length> m_line{};
+    size_t m_line_length{0};
+    size_t m_line_position{0};   // start of the next command
+    bool m_has_line{false};
+    bool m_is_line_overflow{false};
+    RemoteReply m_reply{};
+    size_t m_answer_start{0};   // answer of the pending query starts here
+    size_t m_tx_size{0};        // bytes of the reply being sent
+    size_t m_tx_position{0};
+    bool m_is_command_pending{false};
+    bool m_is_query{false};
+    std::array<ScpiError, k_error_queue_size> m_errors{};
+    size_t m_error_head{0};
+    size_t m_error_count{0};
+};
+
+#endif   // scpi_interpreter_hpp
@@ -0,0 +1,130 @@
+#ifndef short_circuit_detector_hpp
+#define short_circuit_detector_hpp
+
+#include <cstdint>
+
+/**
+ * @brief Detects a collapsed output voltage from fresh sensor samples
+ *
+ * All timing is taken from the sample timestamps, so the reaction time only
+ * depends on the configured window and the sensor rate, never on how often the
+ * caller runs. A short is reported when the voltage stays below the threshold
+ * for the detection window, or right away when the voltage fell below the
+ * threshold faster than the collapse rate, which a regular discharge of the
+ * output capacitors never does.
+ */
+class ShortCircuitDetector {
+  public:
+    /**
+     * @brief Detection settings
+     */
+    struct Settings {
+        int32_t voltage_threshold{500};   // mV
+        uint32_t detection_window{20};    // ms
+        int32_t collapse_rate{1000};      // mV/ms, 0 disables early detection
+        uint32_t blanking_period{500};    // ms, ignored after arm()
+    };
+
+    /**
+     * @brief Constructor, uses the default settings
+     */
+    constexpr ShortCircuitDetector() = default;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] settings Detection settings
+     */
+    constexpr explicit ShortCircuitDetector(const Settings& settings)
+        : m_settings(settings) {}
+
+    /**
+     * @brief Start watching the output, call it when the output is enabled
+     *
+     * The blanking period starts with the first sample after arm(), the
+     * output voltage is still ramping up meanwhile.
+     */
+    constexpr auto arm() -> void {
+        m_is_armed = true;
+        m_has_reference = false;
+        m_is_low = false;
+    }
+
+    /**
+     * @brief Stop watching the output
+     */
+    constexpr auto disarm() -> void { m_is_armed = false; }
+
+    /**
+     * @brief Check whether the output is watched
+     *
+     * @return True if armed
+     */
+    [[nodiscard]] constexpr auto isArmed() const -> bool { return m_is_armed; }
+
+    /**
+     * @brief Process a fresh sample
+     *
+     * The detector disarms itself once a short is reported.
+     *
+     * @param[in] timestamp Sample time in us, may wrap around
+     * @param[in] voltage Output voltage in mV
+     * @return True if a short circuit is detected
+     */
+    constexpr auto addSample(uint32_t timestamp, int32_t voltage) -> bool {
+        if (!m_is_armed) {
+            return false;
+        }
+        if (!m_has_reference) {
+            m_has_reference = true;
+            m_arm_timestamp = timestamp;
+            m_last_timestamp = timestamp;
+            m_last_voltage = voltage;
+            return false;
+        }
+        uint32_t delta = timestamp - m_last_timestamp;
+        int32_t drop = m_last_voltage - voltage;
+        m_last_timestamp = timestamp;
+        m_last_voltage = voltage;
+        if (timestamp - m_arm_timestamp <
+            m_settings.blanking_period * k_us_per_ms) {
+            return false;
+        }
+        if (voltage >= m_settings.voltage_threshold) {
+            m_is_low = false;
+            return false;
+        }
+        // Averaged samples can not resolve a slope steeper than one step per
+        // sample, so the slope is taken over at most 1 ms. mV/ms is compared
+        // as mV * us to avoid the division.
+        uint32_t slope_time = (delta < k_us_per_ms) ? delta : k_us_per_ms;
+        bool is_collapse =
+            !m_is_low && m_settings.collapse_rate > 0 &&
+            static_cast<int64_t>(drop) * k_us_per_ms >=
+                static_cast<int64_t>(m_settings.collapse_rate) * slope_time;
+        if (!m_is_low) {
+            m_is_low = true;
+            m_low_timestamp = timestamp;
+        }
+        if (is_collapse || timestamp - m_low_timestamp >=
+                               m_settings.detection_window * k_us_per_ms) {
+            m_is_armed = false;
+            return true;
+        }
+        return false;
+    }
+
+  private:
+    static constexpr uint32_t k_us_per_ms = 1000;
+
+    Settings m_settings{};
+    uint32_t m_arm_timestamp{0};
+    uint32_t m_last_timestamp{0};
+    uint32_t m_low_timestamp{0};
+    int32_t m_last_voltage{0};
+    bool m_has_reference{false};
+    bool m_is_low{false};
+    bool m_is_armed{false};
+};
+
+#endif   // short_circuit_detector_hpp
@@ -0,0 +1,192 @@
+#ifndef task_scheduler_hpp
+#define task_scheduler_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Cooperative scheduler of periodic tasks
+ *
+ * Every task has its own period and priority. A call to run() executes at
+ * most one due task, the one with the highest priority and, among equal
+ * priorities, the most overdue one, so the caller loop keeps a bounded
+ * latency however many tasks are due. A due task gains one priority level
+ * per aging period it is late, so a task that is always due can not starve
+ * the lower priorities. The time spent in every task is accounted, which
+ * gives the bus time of tasks that are I2C transfers.
+ *
+ * @tparam N Maximum number of tasks
+ */
+template <size_t N>
+class TaskScheduler {
+  public:
+    using Task = void (*)(uint32_t timestamp, void* context);
+    using Clock = uint32_t (*)();
+
+    /**
+     * @brief Time accounting of a task
+     */
+    struct TaskStatistics {
+        uint32_t run_count{0};
+        uint64_t busy_time{0};       // us
+        uint32_t max_busy_time{0};   // us
+    };
+
+    /**
+     * @brief Default lateness that raises a task by one priority level
+     */
+    static constexpr uint32_t k_default_aging_period = 100'000;   // us
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] clock Free running microsecond clock, may wrap around
+     * @param[in] aging_period Lateness in us that raises a task by one
+     * priority level, not 0
+     */
+    explicit TaskScheduler(Clock clock,
+                           uint32_t aging_period = k_default_aging_period)
+        : m_clock(clock),
+          m_aging_period((aging_period > 0) ? aging_period : 1) {}
+
+    /**
+     * @brief Add a task, it is due right away
+     *
+     * @param[in] period Period in us
+     * @param[in] priority Priority, higher runs first
+     * @param[in] task Task function, called with the start time in us
+     * @param[in] context User-defined context pointer passed to the task
+     * @param[out] id Identifier of the task
+     * @return False if there is no free slot
+     */
+    auto addTask(uint32_t period, uint8_t priority, Task task, void* context,
+                 size_t& id) -> bool {
+        if (m_task_count >= N || task == nullptr) {
+            return false;
+        }
+        id = m_task_count++;
+        m_tasks[id] = {.task = task,
+                       .context = context,
+                       .period = period,
+                       .last_run = m_clock(),
+                       .priority = priority,
+                       .is_pending = true};
+        return true;
+    }
+
+    /**
+     * @brief Change the period of a task, the next run is scheduled from the
+     * last one
+     *
+     * @param[in] id Identifier of the task
+     * @param[in] period Period in us
+     */
+    auto setPeriod(size_t id, uint32_t period) -> void {
+        if (id < m_task_count) {
+            m_tasks[id].period = period;
+        }
+    }
+
+    /**
+     * @brief Enable or disable a task, a disabled task is never due
+     *
+     * An enabled task is due right away.
+     *
+     * @param[in] id Identifier of the task
+     * @param[in] enable True to enable the task
+     */
+    auto setEnabled(size_t id, bool enable) -> void {
+        if (id >= m_task_count || m_tasks[id].is_enabled == enable) {
+            return;
+        }
+        m_tasks[id].is_enabled = enable;
+        m_tasks[id].is_pending = enable;
+        m_tasks[id].last_run = m_clock();
+    }
+
+    /**
+     * @brief Run the most urgent due task
+     *
+     * @return True if a task was run
+     */
+    auto run() -> bool {
+        uint32_t now = m_clock();
+        Entry* next = nullptr;
+        uint32_t next_lateness = 0;
+        uint32_t next_priority = 0;
+        for (size_t i = 0; i < m_task_count; ++i) {
+            auto& entry = m_tasks[i];
+            uint32_t elapsed = now - entry.last_run;
+            if (!entry.is_enabled ||
+                (!entry.is_pending && elapsed < entry.period)) {
+                continue;
+            }
+            // A pending task is late since it was added or enabled
+            uint32_t lateness =
+                entry.is_pending ? elapsed : elapsed - entry.period;
+            uint32_t priority = entry.priority + (lateness / m_aging_period);
+            if (next == nullptr || priority > next_priority ||
+                (priority == next_priority && lateness > next_lateness)) {
+                next = &entry;
+                next_lateness = lateness;
+                next_priority = priority;
+            }
+        }
+        if (next == nullptr) {
+            return false;
+        }
+        // The period restarts at the actual run, a late task is not run
+        // again in a burst to catch up
+        next->last_run = now;
+        next->is_pending = false;
+        next->task(now, next->context);
+        uint32_t busy_time = m_clock() - now;
+        auto& statistics = next->statistics;
+        ++statistics.run_count;
+        statistics.busy_time += busy_time;
+        if (busy_time > statistics.max_busy_time) {
+            statistics.max_busy_time = busy_time;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the time accounting of a task
+     *
+     * @param[in] id Identifier of the task
+     * @return Accounting since the start or the last reset
+     */
+    [[nodiscard]] auto getStatistics(size_t id) const -> TaskStatistics {
+        return (id < m_task_count) ? m_tasks[id].statistics
+                                   : TaskStatistics{};
+    }
+
+    /**
+     * @brief Reset the time accounting of all tasks
+     */
+    auto resetStatistics() -> void {
+        for (auto& entry : m_tasks) {
+            entry.statistics = {};
+        }
+    }
+
+  private:
+    struct Entry {
+        Task task{nullptr};
+        void* context{nullptr};
+        uint32_t period{0};
+        uint32_t last_run{0};
+        uint8_t priority{0};
+        bool is_pending{false};
+        bool is_enabled{true};
+        TaskStatistics statistics{};
+    };
+
+    Clock m_clock;
+    uint32_t m_aging_period;
+    std::array<Entry, N> m_tasks{};
+    size_t m_task_count{0};
+};
+
+#endif   // task_scheduler_hpp
@@ -1,28 +1,219 @@
 #ifndef tiny_format_hpp
 #define tiny_format_hpp
 
-#include <cstdio>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 /**
- * @brief Formats a string using the given format and arguments
+ * @brief Number format used by TinyFormat
  *
- * This function uses `std::snprintf` to format the string.
+ * The value passed to TinyFormat is an integer in units of 10^-scale, e.g. a
+ * voltage in millivolts has scale 3. The output matches printf("%0*.*f")
+ * applied to the value converted to double, e.g. 5070 with {.width = 5,
+ * .decimals = 2, .zero_pad = true, .scale = 3} gives "05.07".
+ */
+struct NumberFormat {
+    uint8_t width{0};       // minimum field width
+    uint8_t decimals{0};    // digits after the decimal point
+    bool zero_pad{false};   // pad with zeros instead of spaces
+    uint8_t scale{0};       // value is given in units of 10^-scale
+};
+
+/**
+ * @brief Float free string formatter
  *
- * @param dest The destination buffer
- * @param format The format string
- * @param args The arguments to format
- * @return The formatted string
- * @note The buffer size is limited to N characters
+ * Appends strings and fixed-point numbers into a user provided buffer. All
+ * operations are integer only and usable in constant expressions.
+ *
+ * @note The buffer size is limited to N characters including the terminating
+ * null character
  */
-template <size_t N, typename... Args>
-auto tinyFormat(std::array<char, N>& dest, const char* format, Args... args)
-    -> std::string_view {
-    auto written = std::snprintf(dest.data(), dest.size(), format, args...);
-    if (written < 0 || static_cast<size_t>(written) >= dest.size()) {
-        return std::string_view{};
-    }
-    return std::string_view(dest.data(), static_cast<size_t>(written));
-}
+template <size_t N>
+class TinyFormat {
+    static_assert(N > 0, "Buffer must not be empty");
+
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param[out] dest The destination buffer
+     */
+    constexpr explicit TinyFormat(std::array<char, N>& dest) : m_dest(dest) {
+        m_dest[0] = '\0';
+    }
+
+    /**
+     * @brief Append a string
+     *
+     * @param[in] str String
+     * @return reference to this formatter
+     */
+    constexpr auto append(std::string_view str) -> TinyFormat& {
+        for (const auto& character : str) {
+            put(character);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append a number
+     *
+     * @param[in] value Value in units of 10^-format.scale
+     * @param[in] format Number format
+     * @return reference to this formatter
+     */
+    constexpr auto append(int32_t value, const NumberFormat& format = {})
+        -> TinyFormat& {
+        bool is_negative = value < 0;
+        uint32_t magnitude = is_negative ? 0U - static_cast<uint32_t>(value)
+                                         : static_cast<uint32_t>(value);
+        uint8_t scale = format.scale;
+        // Drop the digits that are not printed, rounding like printf would
+        // round the value converted to double
+        if (scale > format.decimals) {
+            uint32_t divisor = pow10(scale - format.decimals);
+            uint32_t quotient = magnitude / divisor;
+            uint32_t remainder = magnitude % divisor;
+            if (remainder > divisor / 2) {
+                ++quotient;
+            } else if (remainder == divisor / 2) {
+                int direction =
+                    doubleRoundingDirection(magnitude, pow10(scale));
+                bool is_odd = (quotient & 1U) != 0;
+                if (direction > 0 || (direction == 0 && is_odd)) {
+                    ++quotient;
+                }
+            }
+            magnitude = quotient;
+            scale = format.decimals;
+        }
+        uint8_t padding_decimals = format.decimals - scale;
+
+        std::array<char, 10> digits{};
+        uint8_t digit_count = 0;
+        do {
+            digits[digit_count++] = static_cast<char>('0' + (magnitude % 10));
+            magnitude /= 10;
+        } while (magnitude != 0);
+        // Make sure there is at least one integer digit
+        while (digit_count <= scale) {
+            digits[digit_count++] = '0';
+        }
+
+        std::size_t length = (is_negative ? 1 : 0) + digit_count +
+                             padding_decimals +
+                             (format.decimals > 0 ? 1 : 0);
+        std::size_t padding =
+            (format.width > length) ? (format.width - length) : 0;
+        if (!format.zero_pad) {
+            fill(' ', padding);
+        }
+        if (is_negative) {
+            put('-');
+        }
+        if (format.zero_pad) {
+            fill('0', padding);
+        }
+        for (uint8_t i = digit_count; i > 0; --i) {
+            if (i == scale && format.decimals > 0) {
+                put('.');
+            }
+            put(digits[i - 1]);
+        }
+        if (scale == 0 && format.decimals > 0) {
+            put('.');
+        }
+        fill('0', padding_decimals);
+        return *this;
+    }
+
+    /**
+     * @brief Get the formatted string
+     *
+     * @return The formatted string or an empty string if it did not fit into
+     * the buffer
+     */
+    [[nodiscard]] constexpr auto str() const -> std::string_view {
+        if (m_is_overflow) {
+            return std::string_view{};
+        }
+        return std::string_view(m_dest.data(), m_size);
+    }
+
+  private:
+    constexpr auto put(char character) -> void {
+        if (m_size + 1 >= N) {
+            m_is_overflow = true;
+            return;
+        }
+        m_dest[m_size++] = character;
+        m_dest[m_size] = '\0';
+    }
+
+    constexpr auto fill(char character, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) {
+            put(character);
+        }
+    }
+
+    static constexpr auto pow10(uint8_t exponent) -> uint32_t {
+        uint32_t result = 1;
+        for (uint8_t i = 0; i < exponent; ++i) {
+            result *= 10;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Compare the double closest to num / den with the exact quotient
+     *
+     * Used to resolve ties the same way printf does, it rounds the binary
+     * value of its double argument and not the decimal one.
+     *
+     * @return 1 if the double is above, -1 if below and 0 if it is exact
+     */
+    static constexpr auto doubleRoundingDirection(uint32_t num, uint32_t den)
+        -> int {
+        constexpr uint8_t k_mantissa_bits = 53;
+        uint32_t quotient = num / den;
+        uint64_t remainder = num % den;
+        uint8_t bits = 0;
+        bool last_bit = (quotient & 1U) != 0;
+        for (auto q = quotient; q != 0; q >>= 1) {
+            ++bits;
+        }
+        // Binary long division until the mantissa is full
+        while (bits < k_mantissa_bits) {
+            if (remainder == 0) {
+                return 0;
+            }
+            remainder <<= 1;
+            bool bit = remainder >= den;
+            if (bit) {
+                remainder -= den;
+            }
+            if (bits > 0 || bit) {
+                ++bits;
+                last_bit = bit;
+            }
+        }
+        remainder <<= 1;
+        bool guard = remainder >= den;
+        if (guard) {
+            remainder -= den;
+        }
+        bool sticky = remainder != 0;
+        if (guard && (sticky || last_bit)) {
+            return 1;
+        }
+        return (guard || sticky) ? -1 : 0;
+    }
+
+    std::array<char, N>& m_dest;
+    std::size_t m_size{0};
+    bool m_is_overflow{false};
+};
 
 #endif   // tiny_format_hpp
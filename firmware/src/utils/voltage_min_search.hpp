@@ -0,0 +1,98 @@
+#ifndef voltage_min_search_hpp
+#define voltage_min_search_hpp
+
+#include <cstdint>
+
+/**
+ * @brief Binary search for the lowest voltage a source accepts
+ *
+ * Some sources only report a range for the lowest voltage of a PPS profile.
+ * The search probes the voltages in between with real requests, the source
+ * accepts every voltage from its minimum on and rejects the ones below. The
+ * upper end of the range is known to be accepted and never probed, so N
+ * candidate steps take ceil(log2(N + 1)) probes.
+ */
+class VoltageMinSearch {
+  public:
+    /**
+     * @brief Constructor, the search is done right away
+     */
+    constexpr VoltageMinSearch() = default;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] floor Lowest voltage that may be accepted in mV
+     * @param[in] ceiling Voltage known to be accepted in mV
+     * @param[in] step Voltage resolution of the source in mV
+     */
+    constexpr VoltageMinSearch(uint16_t floor, uint16_t ceiling, uint16_t step)
+        : m_low(floor), m_high(ceiling), m_step((step > 0) ? step : 1) {
+        if (m_low > m_high) {
+            m_low = m_high;
+        }
+    }
+
+    /**
+     * @brief Check whether the lowest voltage is found
+     *
+     * @return True if no more probes are needed
+     */
+    [[nodiscard]] constexpr auto isDone() const -> bool {
+        return m_low >= m_high;
+    }
+
+    /**
+     * @brief Get the voltage to probe next
+     *
+     * @return Voltage in mV, only valid while the search is not done
+     */
+    [[nodiscard]] constexpr auto getProbeVoltage() const -> uint16_t {
+        uint16_t steps = (m_high - m_low) / m_step;
+        return m_low + ((steps / 2) * m_step);
+    }
+
+    /**
+     * @brief Add the answer of the source to the probed voltage
+     *
+     * @param[in] is_accepted True if the source accepted the probe
+     */
+    constexpr auto addResult(bool is_accepted) -> void {
+        if (isDone()) {
+            return;
+        }
+        uint16_t voltage = getProbeVoltage();
+        if (is_accepted) {
+            m_high = voltage;
+        } else {
+            m_low = voltage + m_step;
+        }
+        ++m_probe_count;
+    }
+
+    /**
+     * @brief Get the lowest accepted voltage
+     *
+     * @return Voltage in mV, the known upper end until the search is done
+     */
+    [[nodiscard]] constexpr auto getVoltageMin() const -> uint16_t {
+        return m_high;
+    }
+
+    /**
+     * @brief Get the number of probes so far
+     *
+     * @return Probe count
+     */
+    [[nodiscard]] constexpr auto getProbeCount() const -> uint8_t {
+        return m_probe_count;
+    }
+
+  private:
+    uint16_t m_low{0};    // mV, lowest voltage not ruled out
+    uint16_t m_high{0};   // mV, lowest voltage known to be accepted
+    uint16_t m_step{1};   // mV
+    uint8_t m_probe_count{0};
+};
+
+#endif   // voltage_min_search_hpp
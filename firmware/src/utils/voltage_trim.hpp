@@ -0,0 +1,183 @@
+#ifndef voltage_trim_hpp
+#define voltage_trim_hpp
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief Trims the requested source voltage until the measured output matches
+ * the voltage setpoint
+ *
+ * Compensates the voltage lost between the source and the sensor, mostly in
+ * the cable, which grows with the load current. The samples are averaged over
+ * the update interval and the correction moves in whole voltage steps of the
+ * source. Errors within the hysteresis, at least half a step, are left alone,
+ * so the request does not toggle between two steps. The correction stays
+ * within the configured range and never brings the request above the highest
+ * voltage of the source.
+ */
+class VoltageTrim {
+  public:
+    /**
+     * @brief Trim settings
+     */
+    struct Settings {
+        int32_t hysteresis{30};          // mV
+        int32_t max_correction{500};     // mV
+        int32_t max_adjustment{200};     // mV, per update
+        uint32_t update_interval{100};   // ms
+    };
+
+    /**
+     * @brief Constructor, uses the default settings
+     */
+    constexpr VoltageTrim() = default;
+
+    /**
+     * @brief Constructor
+     *
+     * @param[in] settings Trim settings
+     */
+    constexpr explicit VoltageTrim(const Settings& settings)
+        : m_settings(settings) {}
+
+    /**
+     * @brief Set the voltage range of the source
+     *
+     * @param[in] voltage_max Highest voltage the source accepts in mV
+     * @param[in] voltage_step Voltage resolution of the source in mV
+     */
+    constexpr auto setLimits(uint16_t voltage_max, uint16_t voltage_step)
+        -> void {
+        m_voltage_max = voltage_max;
+        m_voltage_step = std::max<uint16_t>(voltage_step, 1);
+    }
+
+    /**
+     * @brief Set the voltage setpoint, the correction is kept
+     *
+     * @param[in] voltage Voltage the output should measure in mV
+     */
+    constexpr auto setTarget(uint16_t voltage) -> void { m_voltage = voltage; }
+
+    /**
+     * @brief Start trimming from an uncorrected request
+     */
+    constexpr auto start() -> void {
+        m_is_running = true;
+        m_correction = 0;
+        hold();
+    }
+
+    /**
+     * @brief Stop trimming, the request returns to the setpoint
+     */
+    constexpr auto stop() -> void {
+        m_is_running = false;
+        m_correction = 0;
+    }
+
+    /**
+     * @brief Keep the correction but drop the samples taken so far
+     *
+     * Call it while the measured voltage does not follow the request, e.g.
+     * while the current is limited.
+     */
+    constexpr auto hold() -> void {
+        m_has_reference = false;
+        m_voltage_sum = 0;
+        m_sample_count = 0;
+    }
+
+    /**
+     * @brief Process a fresh sensor sample
+     *
+     * @param[in] timestamp Sample time in us, may wrap around
+     * @param[in] voltage Measured output voltage in mV
+     * @return True if the requested voltage changed
+     */
+    constexpr auto addSample(uint32_t timestamp, int32_t voltage) -> bool {
+        if (!m_is_running) {
+            return false;
+        }
+        if (!m_has_reference) {
+            // The first sample may still show the previous request
+            m_has_reference = true;
+            m_last_update = timestamp;
+            return false;
+        }
+        m_voltage_sum += voltage;
+        ++m_sample_count;
+        if (timestamp - m_last_update <
+            m_settings.update_interval * k_us_per_ms) {
+            return false;
+        }
+        m_last_update = timestamp;
+        auto average = static_cast<int32_t>(m_voltage_sum / m_sample_count);
+        m_voltage_sum = 0;
+        m_sample_count = 0;
+
+        int32_t error = m_voltage - average;
+        // A hysteresis below half a step would toggle between two steps
+        int32_t step = m_voltage_step;
+        int32_t hysteresis = std::max(m_settings.hysteresis, (step / 2) + 1);
+        if (error > -hysteresis && error < hysteresis) {
+            return false;
+        }
+        int32_t adjustment = std::clamp(error, -m_settings.max_adjustment,
+                                        m_settings.max_adjustment);
+        int32_t steps =
+            (adjustment + (((adjustment > 0) ? step : -step) / 2)) / step;
+        int32_t max_correction = std::clamp<int32_t>(
+            m_voltage_max - m_voltage, 0, m_settings.max_correction);
+        int32_t previous = getRequestVoltage();
+        m_correction =
+            std::clamp(m_correction + (steps * step), 0, max_correction);
+        return getRequestVoltage() != previous;
+    }
+
+    /**
+     * @brief Get the voltage to request from the source
+     *
+     * @return Trimmed voltage setpoint in mV
+     */
+    [[nodiscard]] constexpr auto getRequestVoltage() const -> uint16_t {
+        int32_t voltage = m_voltage + m_correction;
+        return static_cast<uint16_t>(
+            std::min<int32_t>(voltage, std::max(m_voltage_max, m_voltage)));
+    }
+
+    /**
+     * @brief Get the correction
+     *
+     * @return Correction added to the setpoint in mV
+     */
+    [[nodiscard]] constexpr auto getCorrection() const -> int32_t {
+        return m_correction;
+    }
+
+    /**
+     * @brief Check whether the trim is running
+     *
+     * @return True if started
+     */
+    [[nodiscard]] constexpr auto isRunning() const -> bool {
+        return m_is_running;
+    }
+
+  private:
+    static constexpr uint32_t k_us_per_ms = 1000;
+
+    Settings m_settings{};
+    uint16_t m_voltage_max{0};
+    uint16_t m_voltage_step{1};
+    uint16_t m_voltage{0};       // mV
+    int32_t m_correction{0};     // mV
+    int64_t m_voltage_sum{0};
+    uint32_t m_sample_count{0};
+    uint32_t m_last_update{0};
+    bool m_has_reference{false};
+    bool m_is_running{false};
+};
+
+#endif   // voltage_trim_hpp